@@ -0,0 +1,380 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#include "ga_engine.h"
+#include "physics.h"
+#include "route.h"
+#include "rng.h"
+
+/**
+ * @file bench.c
+ * @brief Microbenchmarks dos kernels de física e dos operadores do AG ('make bench').
+ * * Saída em CSV (uma linha por medição) para comparar builds:
+ *   build,bench,variante,pop,dims,chamadas,ns_por_chamada,avaliacoes_por_s,geracoes_por_s
+ * Campos que não se aplicam a uma medição ficam vazios.
+ * * Opções:
+ *   --label NOME     Valor da coluna 'build' (padrão "local")
+ *   --min-time S     Tempo mínimo de cada medição de kernel (padrão 0.2 s)
+ *   --generations G  Gerações por medição dos operadores do AG (padrão 200)
+ *   --quick          Só as menores populações (para conferir se a suíte roda)
+ */
+
+// Entradas pré-sorteadas, percorridas em círculo (o compilador não pode
+// supor valores constantes e o custo do sorteio fica fora da medição)
+#define BENCH_INPUTS 1024
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static const char* build_label = "local";
+static double min_time = 0.2;
+
+static void print_header() {
+    printf("build,bench,variante,pop,dims,chamadas,ns_por_chamada,avaliacoes_por_s,geracoes_por_s\n");
+}
+
+/** Uma linha do CSV. pop/dims <= 0 e taxas < 0 viram campos vazios. */
+static void print_row(const char* bench, const char* variante, int pop, int dims, long long chamadas,
+                      double ns, double evals_s, double gens_s) {
+    printf("%s,%s,%s,", build_label, bench, variante);
+    if (pop > 0) printf("%d", pop);
+    printf(",");
+    if (dims > 0) printf("%d", dims);
+    printf(",%lld,%.2f,", chamadas, ns);
+    if (evals_s >= 0) printf("%.1f", evals_s);
+    printf(",");
+    if (gens_s >= 0) printf("%.2f", gens_s);
+    printf("\n");
+    fflush(stdout);
+}
+
+// =============================================================================
+// KERNELS DE FÍSICA
+// =============================================================================
+
+// Cada kernel é chamado em lotes de BENCH_INPUTS até somar min_time segundos.
+typedef double (*KernelFunc)(int k, const void* dados);
+
+typedef struct {
+    double v[BENCH_INPUTS];      // Velocidade (m/s)
+    double L[BENCH_INPUTS], W[BENCH_INPUTS], H[BENCH_INPUTS];
+    double P[BENCH_INPUTS];      // Potência resistiva (W)
+    double M[BENCH_INPUTS], CdA[BENCH_INPUTS], T[BENCH_INPUTS];
+} KernelInputs;
+
+static double k_drag_body(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    double A;
+    return calcular_drag_body(in->L[k], in->W[k], in->H[k], in->v[k], &A) + A;
+}
+
+static double k_potencia_resistiva(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    return calcular_potencia_resistiva(in->v[k], in->M[k], in->CdA[k], in->T[k]);
+}
+
+static double k_eficiencia_motor(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    return eficiencia_motor(in->P[k]);
+}
+
+static double k_eficiencia_motor_tab(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    return eficiencia_motor_tab(in->P[k]);
+}
+
+static double k_crr_dinamico(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    return calcular_crr_dinamico(in->v[k] * 3.6, in->T[k]);
+}
+
+static double k_crr_dinamico_tab(int k, const void* d) {
+    const KernelInputs* in = (const KernelInputs*)d;
+    return crr_dinamico_tab(in->v[k] * 3.6, in->T[k]);
+}
+
+static void bench_kernel(const char* nome, const char* variante, KernelFunc f, const void* dados) {
+    volatile double sink = 0.0;
+    long long chamadas = 0;
+    double t0 = now_seconds(), t = 0.0;
+    do {
+        double s = 0.0;
+        for (int k = 0; k < BENCH_INPUTS; k++) s += f(k, dados);
+        sink += s;
+        chamadas += BENCH_INPUTS;
+        t = now_seconds() - t0;
+    } while (t < min_time);
+    (void)sink;
+    print_row(nome, variante, 0, 0, chamadas, t * 1e9 / chamadas, chamadas / t, -1);
+}
+
+static void bench_physics_kernels(RngState* rng) {
+    KernelInputs in;
+    for (int k = 0; k < BENCH_INPUTS; k++) {
+        in.v[k] = 10.0 + 20.0 * rng_uniform(rng);
+        in.L[k] = 1.5 + 4.3 * rng_uniform(rng);
+        in.W[k] = 0.55 + 0.35 * rng_uniform(rng);
+        in.H[k] = 0.55 + 0.65 * rng_uniform(rng);
+        in.P[k] = 50.0 + 2000.0 * rng_uniform(rng);
+        in.M[k] = 200.0 + 100.0 * rng_uniform(rng);
+        in.CdA[k] = 0.05 + 0.15 * rng_uniform(rng);
+        in.T[k] = 20.0 + 40.0 * rng_uniform(rng);
+    }
+    physics_tables_init();
+    bench_kernel("calcular_drag_body", "escalar", k_drag_body, &in);
+    bench_kernel("calcular_potencia_resistiva", "escalar", k_potencia_resistiva, &in);
+    bench_kernel("eficiencia_motor", "escalar", k_eficiencia_motor, &in);
+    bench_kernel("eficiencia_motor", "tabela", k_eficiencia_motor_tab, &in);
+    bench_kernel("calcular_crr_dinamico", "escalar", k_crr_dinamico, &in);
+    bench_kernel("calcular_crr_dinamico", "tabela", k_crr_dinamico_tab, &in);
+
+    // Versão vetorial (um lote de BENCH_INPUTS corpos por chamada)
+    double CdA[BENCH_INPUTS], A[BENCH_INPUTS];
+    volatile double sink = 0.0;
+    long long chamadas = 0;
+    double t0 = now_seconds(), t = 0.0;
+    do {
+        calcular_drag_body_n(BENCH_INPUTS, in.L, in.W, in.H, in.v[chamadas / BENCH_INPUTS % BENCH_INPUTS], CdA, A);
+        sink += CdA[0] + A[BENCH_INPUTS - 1];
+        chamadas += BENCH_INPUTS;
+        t = now_seconds() - t0;
+    } while (t < min_time);
+    (void)sink;
+    print_row("calcular_drag_body_n", physics_simd_backend(), 0, 0, chamadas, t * 1e9 / chamadas, chamadas / t, -1);
+}
+
+// =============================================================================
+// FITNESS (ESCALAR E EM LOTE)
+// =============================================================================
+
+// Espaço de busca das três fases (os mesmos limites de main.c)
+static const double SHAPE_MIN[7] = {3.0, MIN_CASCO_WIDTH, MIN_CASCO_HEIGHT, 1.5, MIN_POD_DIAMETER, 4.0,
+                                    (MIN_CASCO_WIDTH + MIN_POD_DIAMETER + MIN_COMPONENT_SEP)};
+static const double SHAPE_MAX[7] = {5.8, 0.9, 1.2, 3.0, 0.7, 6.0, MAX_VEHICLE_WIDTH};
+static const double SPEED_MIN[9] = {15, 15, 15, 15, 15, 15, 15, 15, 15};
+static const double SPEED_MAX[9] = {25, 25, 25, 25, 25, 25, 25, 25, 25};
+
+/** População aleatória (AoS) dentro dos limites. */
+static GeneMatrix random_population(RngState* rng, int n, int dims, const double* gmin, const double* gmax) {
+    GeneMatrix m = {(double*)malloc(sizeof(double) * n * dims), n, dims, dims, 1};
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < dims; j++) GM_AT(&m, i, j) = gmin[j] + rng_uniform(rng) * (gmax[j] - gmin[j]);
+    return m;
+}
+
+/**
+ * Escalar, lote e (se houver) no dispositivo 0: a matriz vai uma vez para o
+ * acelerador e só a fitness é cronometrada, como em ga_context_run_device.
+ */
+static void bench_fitness(const char* nome, FitnessFunc escalar, FitnessBatchFunc lote, FitnessDeviceFunc dispositivo,
+                          const void* param, const GeneMatrix* pop) {
+    int n = pop->n;
+    double* out = (double*)malloc(sizeof(double) * n);
+    volatile double sink = 0.0;
+
+    long long chamadas = 0;
+    double t0 = now_seconds(), t = 0.0;
+    do {
+        double s = 0.0;
+        for (int i = 0; i < n; i++) {
+            Individual ind = {&GM_AT(pop, i, 0), pop->gene_stride};
+            s += escalar(ind, param);
+        }
+        sink += s;
+        chamadas += n;
+        t = now_seconds() - t0;
+    } while (t < min_time);
+    print_row(nome, "escalar", n, pop->dims, chamadas, t * 1e9 / chamadas, chamadas / t, -1);
+
+    chamadas = 0;
+    t0 = now_seconds();
+    do {
+        lote(pop, 0, n, out, param);
+        sink += out[n - 1];
+        chamadas += n;
+        t = now_seconds() - t0;
+    } while (t < min_time);
+    print_row(nome, "lote", n, pop->dims, chamadas, t * 1e9 / chamadas, chamadas / t, -1);
+
+    if (dispositivo) {
+        int dev = ga_device_resolve(0);
+        double* d_genes = (double*)ga_device_alloc(sizeof(double) * n * pop->dims, dev);
+        double* d_out = (double*)ga_device_alloc(sizeof(double) * n, dev);
+        ga_device_put(d_genes, pop->data, sizeof(double) * n * pop->dims, dev);
+        chamadas = 0;
+        t0 = now_seconds();
+        do {
+            dispositivo(d_genes, n, pop->dims, d_out, param, dev);
+            chamadas += n;
+            t = now_seconds() - t0;
+        } while (t < min_time);
+        ga_device_get(out, d_out, sizeof(double) * n, dev);
+        sink += out[n - 1];
+        print_row(nome, "dispositivo", n, pop->dims, chamadas, t * 1e9 / chamadas, chamadas / t, -1);
+        ga_device_free(d_genes, dev);
+        ga_device_free(d_out, dev);
+    }
+    (void)sink;
+    free(out);
+}
+
+static void bench_fitness_all(RngState* rng, const RaceContext* rc, const RouteContext* rota,
+                              const int* pops, int n_pops) {
+    double ref_speed_ms = 22.0;
+    for (int p = 0; p < n_pops; p++) {
+        GeneMatrix forma = random_population(rng, pops[p], 7, SHAPE_MIN, SHAPE_MAX);
+        PHYSICS_FAST_AERO = 0;
+        bench_fitness("fitness_shape", fitness_shape_wrapper, fitness_shape_batch, fitness_shape_device,
+                      &ref_speed_ms, &forma);
+        PHYSICS_FAST_AERO = 1;
+        bench_fitness("fitness_shape_fast_aero", fitness_shape_wrapper, fitness_shape_batch, NULL, &ref_speed_ms, &forma);
+        PHYSICS_FAST_AERO = 0;
+        free(forma.data);
+
+        GeneMatrix estrategia = random_population(rng, pops[p], 9, SPEED_MIN, SPEED_MAX);
+        bench_fitness("fitness_strategy", fitness_strategy_wrapper, fitness_strategy_batch, fitness_strategy_device,
+                      rc, &estrategia);
+        bench_fitness("fitness_strategy_daily", fitness_strategy_daily_wrapper, fitness_strategy_daily_batch,
+                      fitness_strategy_daily_device, rc, &estrategia);
+        physics_set_fidelity(PHYSICS_FIDELITY_TABELADA);
+        bench_fitness("fitness_strategy_tabulated", fitness_strategy_wrapper, fitness_strategy_batch, NULL, rc, &estrategia);
+        physics_set_fidelity(PHYSICS_FIDELITY_EXATA);
+        if (rota) {
+            bench_fitness("fitness_strategy_route_dt60", fitness_strategy_route_wrapper, fitness_strategy_route_batch,
+                          NULL, rota, &estrategia);
+            bench_fitness("fitness_strategy_route_dt3600", fitness_strategy_route_wrapper, fitness_strategy_route_batch,
+                          NULL, rota + 1, &estrategia);
+        }
+        free(estrategia.data);
+    }
+}
+
+// =============================================================================
+// OPERADORES DO AG
+// =============================================================================
+
+/**
+ * Fitness quase gratuita (esfera deslocada): com ela o tempo por geração é só o
+ * custo do motor (cruzamento, mutação, diversidade, controle adaptativo).
+ */
+static double sphere_fitness(Individual ind, const void* param) {
+    const int* dims = (const int*)param;
+    double s = 0.0;
+    for (int j = 0; j < *dims; j++) { double d = IND_GENE(ind, j) - 0.3; s += d * d; }
+    return -s;
+}
+
+static void bench_operators_at(int pop, int dims, int generations, GeneLayout layout, int paralela, GaStrategy estrategia,
+                               FitnessFunc f, FitnessBatchFunc fb, const void* param,
+                               const double* gmin, const double* gmax, const char* fitness_nome) {
+    GAConfig cfg = ga_config_from_globals();
+    cfg.population_size = pop;
+    cfg.num_dimensions = dims;
+    cfg.num_threads = paralela ? 0 : 1; // Tempos por núcleo, estáveis entre máquinas (a reprodução paralela usa todos)
+    cfg.parallel_breeding = paralela;
+    cfg.strategy = estrategia;
+    cfg.gene_min = gmin;
+    cfg.gene_max = gmax;
+    cfg.layout = layout;
+    cfg.diversity_sample_size = 0;
+    cfg.seed = 12345;
+
+    GaOperatorTiming tm;
+    if (ga_measure_operators(&cfg, f, fb, param, generations, &tm) != 0) return;
+    char variante[64];
+    snprintf(variante, sizeof(variante), "%s%s%s%s/%s", layout == GA_LAYOUT_SOA ? "soa" : "aos",
+             paralela ? "-paralela" : "", estrategia != GA_STRATEGY_HIBRIDA ? "-" : "",
+             estrategia != GA_STRATEGY_HIBRIDA ? ga_strategy_name(estrategia) : "", fitness_nome);
+    double ns_geracao = tm.evaluate_ns + tm.adapt_ns + tm.breed_ns;
+    long long gens = tm.generations;
+    print_row("ga_crossover_mutation", variante, pop, dims, gens, tm.breed_ns, -1, 1e9 / tm.breed_ns);
+    print_row("ga_diversity", variante, pop, dims, gens, tm.diversity_ns, -1, -1);
+    print_row("ga_adapt", variante, pop, dims, gens, tm.adapt_ns, -1, -1);
+    print_row("ga_evaluate", variante, pop, dims, gens, tm.evaluate_ns,
+              tm.evaluations / (tm.evaluate_ns * gens * 1e-9), -1);
+    print_row("ga_generation", variante, pop, dims, gens, ns_geracao,
+              tm.evaluations / (ns_geracao * gens * 1e-9), 1e9 / ns_geracao);
+}
+
+static void bench_operators(const RaceContext* rc, const int* pops, int n_pops, int generations) {
+    static const int dims_list[] = {7, 9, 32};
+    double gmin[32], gmax[32];
+    for (int j = 0; j < 32; j++) { gmin[j] = -1.0; gmax[j] = 1.0; }
+
+    for (int p = 0; p < n_pops; p++) {
+        for (int d = 0; d < 3; d++) {
+            int dims = dims_list[d];
+            bench_operators_at(pops[p], dims, generations, GA_LAYOUT_AOS, 0, GA_STRATEGY_HIBRIDA, sphere_fitness, NULL, &dims, gmin, gmax, "esfera");
+            bench_operators_at(pops[p], dims, generations, GA_LAYOUT_SOA, 0, GA_STRATEGY_HIBRIDA, sphere_fitness, NULL, &dims, gmin, gmax, "esfera");
+            bench_operators_at(pops[p], dims, generations, GA_LAYOUT_AOS, 1, GA_STRATEGY_HIBRIDA, sphere_fitness, NULL, &dims, gmin, gmax, "esfera");
+            bench_operators_at(pops[p], dims, generations, GA_LAYOUT_AOS, 0, GA_STRATEGY_FISHER, sphere_fitness, NULL, &dims, gmin, gmax, "esfera");
+            bench_operators_at(pops[p], dims, generations, GA_LAYOUT_AOS, 0, GA_STRATEGY_POR_GENE, sphere_fitness, NULL, &dims, gmin, gmax, "esfera");
+        }
+        // Geração completa com a física de verdade (Fases 1 e 2)
+        double ref_speed_ms = 22.0;
+        bench_operators_at(pops[p], 7, generations, GA_LAYOUT_AOS, 0, GA_STRATEGY_HIBRIDA, fitness_shape_wrapper, fitness_shape_batch,
+                           &ref_speed_ms, SHAPE_MIN, SHAPE_MAX, "fase1");
+        bench_operators_at(pops[p], 9, generations, GA_LAYOUT_AOS, 0, GA_STRATEGY_HIBRIDA, fitness_strategy_wrapper, fitness_strategy_batch,
+                           rc, SPEED_MIN, SPEED_MAX, "fase2");
+    }
+}
+
+// =============================================================================
+// PROGRAMA
+// =============================================================================
+
+static int has_flag(int argc, char** argv, const char* flag) {
+    for (int i = 1; i < argc; i++) if (strcmp(argv[i], flag) == 0) return 1;
+    return 0;
+}
+
+static const char* parse_string_option(int argc, char** argv, const char* nome, const char* padrao) {
+    for (int i = 1; i < argc - 1; i++) if (strcmp(argv[i], nome) == 0) return argv[i + 1];
+    return padrao;
+}
+
+int main(int argc, char** argv) {
+    build_label = parse_string_option(argc, argv, "--label", "local");
+    min_time = atof(parse_string_option(argc, argv, "--min-time", "0.2"));
+    int generations = atoi(parse_string_option(argc, argv, "--generations", "200"));
+    int quick = has_flag(argc, argv, "--quick");
+
+    static const int pops_all[] = {100, 1000, 10000};
+    int n_pops = quick ? 1 : 3;
+
+    // Um carro no meio do espaço de busca para as Fases 2 e 3
+    CarDesignOutrigger car;
+    car.L_casco = 4.4; car.W_casco = 0.75; car.H_casco = 1.0;
+    car.L_pod = 2.2; car.D_pod = 0.6; car.A_solar = 5.0; car.W_sep = 1.8;
+    RaceContext rc;
+    race_context_init(&rc, &car);
+
+    RngState rng;
+    rng_seed(&rng, 2024);
+
+    // Rota sintética de 3000 km (passos de 60 s e de 1 h) para a fitness com passo fino
+    const char* arquivo_rota = "ProjetoSolar_bench.rota";
+    RouteContext rotas[2];
+    Route rota;
+    int tem_rota = route_write_synthetic(arquivo_rota, 3000.0, 100.0, 60.0, RACE_MAX_DIAS) == 0 &&
+                   route_open(&rota, arquivo_rota) == 0;
+    if (tem_rota) {
+        tem_rota = route_context_init(&rotas[0], &rc, &rota, 60.0) == 0 &&
+                   route_context_init(&rotas[1], &rc, &rota, 3600.0) == 0;
+        route_close(&rota);
+    }
+    remove(arquivo_rota);
+
+    print_header();
+    bench_physics_kernels(&rng);
+    bench_fitness_all(&rng, &rc, tem_rota ? rotas : NULL, pops_all, n_pops);
+    bench_operators(&rc, pops_all, n_pops, generations);
+    if (tem_rota) { route_context_free(&rotas[0]); route_context_free(&rotas[1]); }
+    return 0;
+}
@@ -0,0 +1,117 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+// =============================================================================
+// GRAVADORA (uma thread por arquivo, com um único snapshot pendente)
+// =============================================================================
+
+struct CheckpointWriter {
+    char* path;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    void* pendente;          // Snapshot ainda não gravado (NULL = nada a fazer)
+    size_t len;
+    int encerrar;
+    int tem_thread;
+    pthread_t thread;
+};
+
+int checkpoint_write_file(const char* path, const void* data, size_t len) {
+    size_t n = strlen(path);
+    char* tmp = (char*)malloc(n + 5);
+    memcpy(tmp, path, n);
+    memcpy(tmp + n, ".tmp", 5);
+
+    int ok = 0;
+    FILE* f = fopen(tmp, "wb");
+    if (f) {
+        ok = fwrite(data, 1, len, f) == len;
+        ok = (fflush(f) == 0) && ok;
+        ok = (fsync(fileno(f)) == 0) && ok; // O rename só pode ver o conteúdo inteiro
+        ok = (fclose(f) == 0) && ok;
+        if (ok) ok = rename(tmp, path) == 0;
+        if (!ok) remove(tmp);
+    }
+    free(tmp);
+    return ok ? 0 : -1;
+}
+
+void* checkpoint_read_file(const char* path, size_t* len) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    long tam = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    void* data = (tam > 0) ? malloc((size_t)tam) : NULL;
+    if (data && fread(data, 1, (size_t)tam, f) != (size_t)tam) { free(data); data = NULL; }
+    fclose(f);
+    if (data) *len = (size_t)tam;
+    return data;
+}
+
+static void* writer_main(void* arg) {
+    CheckpointWriter* w = (CheckpointWriter*)arg;
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->pendente == NULL && !w->encerrar) pthread_cond_wait(&w->cond, &w->lock);
+        if (w->pendente == NULL) break; // Encerrar, sem nada pendente
+        void* data = w->pendente;
+        size_t len = w->len;
+        w->pendente = NULL;
+        pthread_mutex_unlock(&w->lock);
+
+        if (checkpoint_write_file(w->path, data, len) != 0)
+            fprintf(stderr, "AVISO: falha ao gravar o checkpoint %s\n", w->path);
+        free(data);
+        pthread_mutex_lock(&w->lock);
+    }
+    pthread_mutex_unlock(&w->lock);
+    return NULL;
+}
+
+CheckpointWriter* checkpoint_writer_start(const char* path) {
+    CheckpointWriter* w = (CheckpointWriter*)calloc(1, sizeof(CheckpointWriter));
+    if (w == NULL) return NULL;
+    size_t n = strlen(path) + 1;
+    w->path = (char*)malloc(n);
+    memcpy(w->path, path, n);
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    w->tem_thread = pthread_create(&w->thread, NULL, writer_main, w) == 0;
+    return w;
+}
+
+void checkpoint_writer_submit(CheckpointWriter* w, void* data, size_t len) {
+    if (!w->tem_thread) {
+        if (checkpoint_write_file(w->path, data, len) != 0)
+            fprintf(stderr, "AVISO: falha ao gravar o checkpoint %s\n", w->path);
+        free(data);
+        return;
+    }
+    pthread_mutex_lock(&w->lock);
+    free(w->pendente); // O disco ficou para trás: vale só o snapshot mais novo
+    w->pendente = data;
+    w->len = len;
+    pthread_cond_signal(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+void checkpoint_writer_stop(CheckpointWriter* w) {
+    if (w == NULL) return;
+    if (w->tem_thread) {
+        pthread_mutex_lock(&w->lock);
+        w->encerrar = 1;
+        pthread_cond_signal(&w->cond);
+        pthread_mutex_unlock(&w->lock);
+        pthread_join(w->thread, NULL);
+    }
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->cond);
+    free(w->path);
+    free(w);
+}
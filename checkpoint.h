@@ -0,0 +1,38 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+/**
+ * @file checkpoint.h
+ * @brief Gravação atômica e assíncrona de arquivos de checkpoint.
+ * * O AG só monta o snapshot em memória (uma cópia) e o entrega a uma thread
+ * gravadora, que escreve "<arquivo>.tmp", força o conteúdo para o disco
+ * (fsync) e troca o nome para "<arquivo>" (rename é atômico): quem lê o
+ * checkpoint sempre encontra uma versão completa, nunca a metade de uma.
+ * * Se um snapshot chega antes do anterior ter sido gravado, o anterior é
+ * descartado (só o mais recente interessa) e o AG não espera pelo disco.
+ * O formato do conteúdo é definido por quem grava (ver ga_engine.c).
+ */
+
+#include <stddef.h>
+
+typedef struct CheckpointWriter CheckpointWriter;
+
+/**
+ * @brief Cria a thread gravadora de um arquivo.
+ * Se a thread não puder ser criada, checkpoint_writer_submit grava na hora.
+ */
+CheckpointWriter* checkpoint_writer_start(const char* path);
+
+/** @brief Entrega um snapshot (alocado com malloc; a gravadora assume e libera o buffer). */
+void checkpoint_writer_submit(CheckpointWriter* w, void* data, size_t len);
+
+/** @brief Grava o snapshot pendente, encerra a thread e libera a gravadora. */
+void checkpoint_writer_stop(CheckpointWriter* w);
+
+/** @brief Gravação atômica síncrona (tmp + fsync + rename). @return 0 em sucesso, -1 em erro. */
+int checkpoint_write_file(const char* path, const void* data, size_t len);
+
+/** @brief Lê um arquivo inteiro (liberar com free). @return NULL se não existir. */
+void* checkpoint_read_file(const char* path, size_t* len);
+
+#endif // CHECKPOINT_H
@@ -2,16 +2,22 @@
 dashboard_evolution.py
 
 Script de visualização de dados para o Algoritmo Genético do Carro Solar.
-Este script lê arquivos CSV gerados pela simulação em C e gera um painel 
+Este script lê os logs gerados pela simulação em C e gera um painel 
 comparativo (Dashboard) com métricas de Fitness, Diversidade e Controle.
+Lê de preferência o log binário colunar 'faseN.galog' (mapeado em memória,
+formato descrito em ga_log.h); se ele não existir, cai no CSV exportado
+('faseN.csv', gerado com a opção --csv).
 
 Dependências:
-    - pandas: Manipulação de dados (CSV)
+    - numpy: Leitura do log binário (memmap)
+    - pandas: Manipulação de dados (tabelas / CSV)
     - matplotlib: Criação dos gráficos
 """
 
+import numpy as np
 import pandas as pd
 import matplotlib.pyplot as plt
+import struct
 import sys
 import os
 
@@ -28,31 +34,84 @@ USE_LOG_SCALE = True
 plt.style.use('seaborn-v0_8-whitegrid')
 plt.rcParams.update({'font.size': 10, 'font.family': 'sans-serif'})
 
-def plot_phase_data(ax_col, filename, phase_title):
+# ==============================================================================
+# --- LEITURA DOS LOGS ---
+# ==============================================================================
+GALOG_MAGIC = b'GALOG01\0'
+GALOG_NAME_LEN = 24
+
+def read_galog(filename):
+    """
+    Lê um log binário .galog e devolve um DataFrame com as mesmas colunas do CSV.
+
+    O arquivo é um cabeçalho fixo seguido de blocos de mesmo tamanho
+    (int64 n_linhas + colunas de float64), então os blocos são mapeados
+    direto em memória, sem parsing de texto. Só os blocos completos são lidos,
+    o que permite abrir o arquivo enquanto a simulação ainda roda.
+    """
+    with open(filename, 'rb') as f:
+        raw = f.read(28)
+        magic, version, header_size, n_cols, block_rows, n_events = struct.unpack('<8s5i', raw)
+        if magic != GALOG_MAGIC:
+            raise ValueError(f"{filename} não é um log .galog")
+        names_raw = f.read((n_cols + n_events) * GALOG_NAME_LEN)
+
+    def name(i):
+        return names_raw[i * GALOG_NAME_LEN:(i + 1) * GALOG_NAME_LEN].split(b'\0')[0].decode()
+    col_names = [name(i) for i in range(n_cols)]
+    event_names = {i: name(n_cols + i) for i in range(n_events)}
+
+    block_dtype = np.dtype([('n', '<i8'), ('cols', '<f8', (n_cols, block_rows))])
+    n_blocks = (os.path.getsize(filename) - header_size) // block_dtype.itemsize
+    if n_blocks <= 0:
+        return pd.DataFrame({c: [] for c in col_names})
+    blocks = np.memmap(filename, dtype=block_dtype, mode='r', offset=header_size, shape=(n_blocks,))
+
+    # Máscara das linhas válidas de cada bloco (o último pode estar incompleto)
+    valid = np.arange(block_rows)[None, :] < blocks['n'][:, None]
+    data = {c: blocks['cols'][:, k, :][valid] for k, c in enumerate(col_names)}
+    df = pd.DataFrame(data)
+    df['Geracao'] = df['Geracao'].astype(int)
+    df['Evento'] = df['Evento'].astype(int).map(event_names)
+    return df
+
+def load_phase_log(base):
+    """
+    Carrega o log de uma fase ('fase1' -> 'fase1.galog' ou 'fase1.csv').
+
+    Returns:
+        (DataFrame ou None, nome do arquivo procurado)
+    """
+    for filename, reader in ((base + '.galog', read_galog), (base + '.csv', pd.read_csv)):
+        if os.path.exists(filename):
+            return reader(filename), filename
+    return None, base + '.galog'
+
+def plot_phase_data(ax_col, base, phase_title):
     """
     Processa um arquivo CSV e plota os 3 gráficos de uma fase específica.
 
     Args:
         ax_col (list): Lista com os 3 objetos Axes (subplots) onde os dados serão desenhados.
-        filename (str): Caminho do arquivo CSV (ex: 'fase1.csv').
+        base (str): Nome da fase sem extensão (ex: 'fase1').
         phase_title (str): Título principal desta coluna de gráficos (ex: 'Fase 1').
     """
     
     # 1. Validação de Arquivo
-    # Verifica se o arquivo existe antes de tentar ler para evitar crash feio.
-    if not os.path.exists(filename):
+    # Verifica se o log existe antes de tentar ler para evitar crash feio.
+    try:
+        df, filename = load_phase_log(base)
+    except Exception as e:
+        print(f"Erro crítico ao ler o log de {base}: {e}")
+        return
+
+    if df is None:
         for ax in ax_col:
             # Escreve uma mensagem de erro visual dentro do gráfico vazio
             ax.text(0.5, 0.5, f"Arquivo '{filename}' não encontrado", 
                     ha='center', va='center', transform=ax.transAxes, color='red')
         return
 
-    try:
-        df = pd.read_csv(filename)
-    except Exception as e:
-        print(f"Erro crítico ao ler {filename}: {e}")
-        return
-
     # Extração de dados comuns para facilitar a leitura
     geracao = df['Geracao']
     
@@ -109,6 +168,8 @@ def plot_phase_data(ax_col, filename, phase_title):
     
     # Eixo Y da Esquerda (Mutação)
     ln1 = ax3.plot(geracao, df['TaxaMutacao'], color='#2ca02c', label='Mutação %', linewidth=1.2)
+    if 'Severidade' in df:  # Logs antigos (versão < 4) não têm a coluna
+        ln1 += ax3.plot(geracao, df['Severidade'], color='#2ca02c', linestyle=':', label='Passo % range', linewidth=1.2)
     ax3.set_ylabel("Mutação (%)", color='#2ca02c')
     ax3.tick_params(axis='y', labelcolor='#2ca02c') # Pinta os números do eixo da mesma cor da linha
     
@@ -144,33 +205,138 @@ def plot_phase_data(ax_col, filename, phase_title):
         ax3.set_xscale('linear')
         ax3.set_xlim(left=0, right=max(geracao))
 
+# ==============================================================================
+# --- MODO AO VIVO (--follow): TELEMETRIA UDP ---
+# ==============================================================================
+# O executável, rodado com --telemetry, envia datagramas UDP com as métricas de
+# cada geração (formato em telemetry.h). Este modo escuta a porta e redesenha
+# os gráficos da fase em andamento enquanto o AG roda.
+TELEMETRY_DEFAULT_PORT = 47800
+TELEMETRY_MAGIC = b'GATL'
+TELEMETRY_HEADER = struct.Struct('<4sIQ')    # magic, n, dropped
+TELEMETRY_RECORD = struct.Struct('<ii12d')   # fase, reservado, 12 colunas (as do .galog)
+TELEMETRY_EVENTS = ['-', 'POS-RESET', 'REPULSAO', 'RESET-HIBRIDO', 'EXPANSAO', 'RESET-TOTAL']
+
+def parse_telemetry_packet(data):
+    """
+    Decodifica um datagrama de telemetria.
+
+    Returns:
+        (lista de (fase, [12 colunas]), total descartado pelo produtor) ou (None, 0) se inválido.
+    """
+    if len(data) < TELEMETRY_HEADER.size:
+        return None, 0
+    magic, n, dropped = TELEMETRY_HEADER.unpack_from(data, 0)
+    if magic != TELEMETRY_MAGIC or len(data) < TELEMETRY_HEADER.size + n * TELEMETRY_RECORD.size:
+        return None, 0
+    recs = []
+    for k in range(n):
+        fase, _, *cols = TELEMETRY_RECORD.unpack_from(data, TELEMETRY_HEADER.size + k * TELEMETRY_RECORD.size)
+        recs.append((fase, cols))
+    return recs, dropped
+
+def follow_telemetry(port):
+    """Escuta a telemetria na porta dada e atualiza o painel da fase atual."""
+    import socket
+    from matplotlib.animation import FuncAnimation
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind(('127.0.0.1', port))
+    sock.setblocking(False)
+
+    fases = {}  # fase -> {coluna: lista}
+    estado = {'fase': None, 'dropped': 0}
+
+    fig, (ax1, ax2, ax3) = plt.subplots(nrows=3, ncols=1, figsize=(10, 10), sharex=True)
+
+    def atualizar(_):
+        # Esvazia tudo que chegou desde o último quadro
+        while True:
+            try:
+                data = sock.recv(65536)
+            except BlockingIOError:
+                break
+            recs, dropped = parse_telemetry_packet(data)
+            if recs is None:
+                continue
+            estado['dropped'] = dropped
+            for fase, cols in recs:
+                d = fases.setdefault(fase, {'ger': [], 'best': [], 'avg': [], 'div': [], 'mut': [], 'sev': [], 'rep': [], 'resets': []})
+                d['ger'].append(cols[0]); d['best'].append(cols[1]); d['avg'].append(cols[2])
+                d['div'].append(cols[4]); d['mut'].append(cols[5]); d['rep'].append(cols[6])
+                d['sev'].append(cols[11])
+                if TELEMETRY_EVENTS[int(cols[7])] in ('RESET-HIBRIDO', 'RESET-TOTAL'):
+                    d['resets'].append(cols[0])
+                estado['fase'] = fase
+
+        fase = estado['fase']
+        if fase is None:
+            return
+        d = fases[fase]
+        for ax in (ax1, ax2, ax3):
+            ax.clear()
+        ax1.plot(d['ger'], d['best'], color='#1f77b4', linewidth=1.5, label='Melhor Indivíduo')
+        ax1.plot(d['ger'], d['avg'], color='#ff7f0e', linestyle='--', linewidth=1, label='Média')
+        ax1.set_ylabel("Fitness")
+        ax1.legend(loc='lower right', fontsize=8)
+        ax2.plot(d['ger'], d['div'], color='#9467bd', linewidth=1.2)
+        for r in d['resets']:
+            ax2.axvline(x=r, color='red', alpha=0.3, linewidth=0.5)
+        ax2.set_ylabel("Diversidade")
+        ax3.plot(d['ger'], d['mut'], color='#2ca02c', linewidth=1.2, label='Mutação %')
+        ax3.plot(d['ger'], d['sev'], color='#2ca02c', linestyle=':', linewidth=1.2, label='Passo % range')
+        ax3.plot(d['ger'], d['rep'], color='#d62728', linestyle='-.', linewidth=1.2, label='Repulsão')
+        ax3.set_ylabel("Controle")
+        ax3.set_xlabel("Gerações")
+        ax3.legend(loc='upper left', fontsize=8)
+        ultima = d['best'][-1] if d['best'] else 0
+        fig.suptitle(f"AO VIVO - Fase {fase} | Geração {int(d['ger'][-1])} | Melhor: {ultima:.3f} "
+                     f"| Descartados: {estado['dropped']}", fontsize=12)
+
+    print(f"Ouvindo telemetria em udp://127.0.0.1:{port} (rode ./ProjetoSolar --telemetry)")
+    anim = FuncAnimation(fig, atualizar, interval=500, cache_frame_data=False)
+    plt.show()
+    return anim
+
 # ==============================================================================
 # --- EXECUÇÃO PRINCIPAL ---
 # ==============================================================================
 
-# Cria a figura e uma grade de subplots (3 linhas, 2 colunas)
-# sharex='col' faz com que dar zoom em um gráfico aplique o zoom nos outros da mesma coluna
-fig, axes = plt.subplots(nrows=3, ncols=2, figsize=(16, 12), sharex='col')
+def plot_dashboard():
+    """Painel estático das Fases 1 e 2, a partir dos logs gravados."""
+    # Cria a figura e uma grade de subplots (3 linhas, 2 colunas)
+    # sharex='col' faz com que dar zoom em um gráfico aplique o zoom nos outros da mesma coluna
+    fig, axes = plt.subplots(nrows=3, ncols=2, figsize=(16, 12), sharex='col')
 
-# Ajusta espaço vertical entre os gráficos
-plt.subplots_adjust(hspace=0.3)
+    # Ajusta espaço vertical entre os gráficos
+    plt.subplots_adjust(hspace=0.3)
 
-# Processa a Coluna da Esquerda (Fase 1 - Design)
-# Passamos axes[:, 0] que pega todas as linhas da coluna 0
-plot_phase_data(axes[:, 0], 'fase1.csv', 'FASE 1: Design (Geometria)')
+    # Processa a Coluna da Esquerda (Fase 1 - Design)
+    # Passamos axes[:, 0] que pega todas as linhas da coluna 0
+    plot_phase_data(axes[:, 0], 'fase1', 'FASE 1: Design (Geometria)')
 
-# Processa a Coluna da Direita (Fase 2 - Estratégia)
-# Passamos axes[:, 1] que pega todas as linhas da coluna 1
-plot_phase_data(axes[:, 1], 'fase2.csv', 'FASE 2: Estratégia (3000km)')
+    # Processa a Coluna da Direita (Fase 2 - Estratégia)
+    # Passamos axes[:, 1] que pega todas as linhas da coluna 1
+    plot_phase_data(axes[:, 1], 'fase2', 'FASE 2: Estratégia (3000km)')
 
-# Título Geral do Painel
-mode_str = "Logarítmica" if USE_LOG_SCALE else "Linear"
-fig.suptitle(f'Painel de Otimização Evolutiva - Carro Solar (Escala {mode_str})', fontsize=16, y=0.98)
+    # Título Geral do Painel
+    mode_str = "Logarítmica" if USE_LOG_SCALE else "Linear"
+    fig.suptitle(f'Painel de Otimização Evolutiva - Carro Solar (Escala {mode_str})', fontsize=16, y=0.98)
 
-# Tight Layout ajusta as margens para nada ficar cortado
-plt.tight_layout(rect=[0, 0.03, 1, 0.97])
+    # Tight Layout ajusta as margens para nada ficar cortado
+    plt.tight_layout(rect=[0, 0.03, 1, 0.97])
 
-# Salva o arquivo final
-filename_out = f'dashboard_carro_solar_{"log" if USE_LOG_SCALE else "linear"}.png'
-plt.savefig(filename_out, dpi=150)
-print(f"Gráfico salvo com sucesso: {filename_out}")
\ No newline at end of file
+    # Salva o arquivo final
+    filename_out = f'dashboard_carro_solar_{"log" if USE_LOG_SCALE else "linear"}.png'
+    plt.savefig(filename_out, dpi=150)
+    print(f"Gráfico salvo com sucesso: {filename_out}")
+
+if __name__ == '__main__':
+    # Uso: python3 dashboard.py             -> painel a partir dos logs (.galog/.csv)
+    #      python3 dashboard.py --follow [PORTA] -> painel ao vivo da telemetria
+    if '--follow' in sys.argv:
+        i = sys.argv.index('--follow')
+        port = int(sys.argv[i + 1]) if i + 1 < len(sys.argv) else TELEMETRY_DEFAULT_PORT
+        follow_telemetry(port)
+    else:
+        plot_dashboard()
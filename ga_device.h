@@ -0,0 +1,119 @@
+#ifndef GA_DEVICE_H
+#define GA_DEVICE_H
+
+/**
+ * @file ga_device.h
+ * @brief Camada mínima de acelerador (OpenMP target) usada pelo motor e pela física.
+ * * Compilado com -DGA_USE_OFFLOAD (make GPU=1), cada GA_DEVICE_FOR vira uma
+ * região 'omp target teams distribute parallel for' no dispositivo escolhido,
+ * a memória vem de omp_target_alloc e o que fica entre GA_DEVICE_BEGIN/END é
+ * compilado também para o acelerador. Sem offload (padrão), o "dispositivo" é
+ * a própria CPU: memória comum e laços 'omp parallel for', então o mesmo
+ * caminho roda (e pode ser conferido) em qualquer máquina.
+ * * Ponteiros de ga_device_alloc só podem ser lidos dentro de GA_DEVICE_FOR
+ * (declarados em is_device_ptr) ou copiados com ga_device_put/ga_device_get.
+ * Funções static/inline chamadas numa região do mesmo arquivo viram 'declare
+ * target' implicitamente (OpenMP 5.0); globais lidas no dispositivo precisam
+ * de GA_DEVICE_BEGIN/END e de GA_DEVICE_UPDATE depois de mudar no hospedeiro.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define GA_PRAGMA(...) _Pragma(#__VA_ARGS__)
+
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+/** @brief Laço paralelo no dispositivo. 'dados': cláusulas só do offload (is_device_ptr, map). */
+#define GA_DEVICE_FOR(dev, dados, ...) \
+    GA_PRAGMA(omp target teams distribute parallel for device(dev) dados __VA_ARGS__)
+#define GA_DEVICE_BEGIN GA_PRAGMA(omp declare target)
+#define GA_DEVICE_END GA_PRAGMA(omp end declare target)
+/** @brief Copia globais 'declare target' do hospedeiro para o dispositivo. */
+#define GA_DEVICE_UPDATE(dev, ...) GA_PRAGMA(omp target update device(dev) to(__VA_ARGS__))
+#elif defined(_OPENMP)
+#define GA_DEVICE_FOR(dev, dados, ...) GA_PRAGMA(omp parallel for __VA_ARGS__)
+#define GA_DEVICE_BEGIN
+#define GA_DEVICE_END
+#define GA_DEVICE_UPDATE(dev, ...) ((void)(dev))
+#else
+#define GA_DEVICE_FOR(dev, dados, ...)
+#define GA_DEVICE_BEGIN
+#define GA_DEVICE_END
+#define GA_DEVICE_UPDATE(dev, ...) ((void)(dev))
+#endif
+
+/** @brief Aceleradores visíveis (0 sem offload ou sem dispositivo). */
+static inline int ga_device_count(void) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    return omp_get_num_devices();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Dispositivo que vai rodar de fato o pedido 'dev' (>= 0).
+ * Sem aquele acelerador, devolve o hospedeiro (omp_get_initial_device no
+ * offload, ou o próprio número sem offload, onde ele não tem efeito).
+ */
+static inline int ga_device_resolve(int dev) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    return (dev >= 0 && dev < omp_get_num_devices()) ? dev : omp_get_initial_device();
+#else
+    return dev;
+#endif
+}
+
+/** @brief Texto do dispositivo (para o cabeçalho e os relatórios). */
+static inline const char* ga_device_name(int dev) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    return (dev == omp_get_initial_device()) ? "hospedeiro (sem acelerador)" : "acelerador OpenMP";
+#else
+    (void)dev;
+    return "CPU (build sem offload)";
+#endif
+}
+
+static inline void* ga_device_alloc(size_t bytes, int dev) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    return omp_target_alloc(bytes, dev);
+#else
+    (void)dev;
+    return malloc(bytes);
+#endif
+}
+
+static inline void ga_device_free(void* p, int dev) {
+    if (p == NULL) return;
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    omp_target_free(p, dev);
+#else
+    (void)dev;
+    free(p);
+#endif
+}
+
+/** @brief Hospedeiro -> dispositivo ('dst' de ga_device_alloc). */
+static inline void ga_device_put(void* dst, const void* src, size_t bytes, int dev) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    omp_target_memcpy(dst, (void*)src, bytes, 0, 0, dev, omp_get_initial_device());
+#else
+    (void)dev;
+    memcpy(dst, src, bytes);
+#endif
+}
+
+/** @brief Dispositivo -> hospedeiro ('src' de ga_device_alloc). */
+static inline void ga_device_get(void* dst, const void* src, size_t bytes, int dev) {
+#if defined(_OPENMP) && defined(GA_USE_OFFLOAD)
+    omp_target_memcpy(dst, (void*)src, bytes, 0, 0, omp_get_initial_device(), dev);
+#else
+    (void)dev;
+    memcpy(dst, src, bytes);
+#endif
+}
+
+#endif // GA_DEVICE_H
@@ -2,20 +2,47 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
+#include <time.h>
 #include "ga_engine.h"
+#include "telemetry.h"
+#include "checkpoint.h"
+#include "ga_device.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef GA_USE_MPI
+#include <mpi.h>
+#endif
 
 // =============================================================================
 // VARIÁVEIS GLOBAIS E CONFIGURAÇÕES
 // =============================================================================
-Individual* population = NULL;
-double* fitness = NULL;
+// Valores padrão lidos por ga_config_from_globals(). O motor em si só enxerga
+// a cópia em GAConfig, então várias execuções (ilhas) convivem sem conflito.
 int POPULATION_SIZE;
+int NUM_THREADS = 1;
 int MAX_GENERATIONS;
 int NUM_DIMENSIONS;
 double* GENE_MIN_VALUE = NULL;
 double* GENE_MAX_VALUE = NULL;
+unsigned long long GA_SEED = 1;
+GeneLayout GENE_LAYOUT = GA_LAYOUT_AOS;
+int DIVERSITY_SAMPLE_SIZE = 0;
+GaStopCriteria GA_STOP = {0, 0, 0.0, 0.0, 0, 0, 0.0};
+GaIslandConfig GA_ISLANDS = {1, 50, 2, GA_TOPOLOGY_RING};
+GaSurrogateConfig GA_SURROGATE = {0, 512, 8, 0.3, 0.05};
+GaFitnessCacheConfig GA_FITNESS_CACHE = {0, 0.0};
+int GA_DEVICE = -1;
+int GA_PARALLEL_BREEDING = 0;
+GaStrategy GA_STRATEGY = GA_STRATEGY_HIBRIDA;
+GaStopReason GA_LAST_STOP_REASON = GA_STOP_MAX_GENERATIONS;
+int GA_LAST_GENERATIONS = 0;
+long long GA_LAST_EVALUATIONS = 0;
 
-FILE* ga_csv_file = NULL;
+GaLog* ga_log = NULL;
+int GA_LOG_EVERY = 1;
 
 // --- PARÂMETROS BIOLÓGICOS E ADAPTATIVOS ---
 #define MUTATION_PROB_INITIAL 5.0   // Começa com 5% de chance de mutar
@@ -23,7 +50,7 @@ FILE* ga_csv_file = NULL;
 #define MUTATION_PROB_MIN 0.1       // Mínimo para refinamento fino
 
 // Severidade: Quando a mutação ocorre, o gene muda em até 15% do seu range total
-#define MUTATION_SEVERITY 15.0      
+#define MUTATION_SEVERITY 15.0
 
 // Controle de Estagnação
 #define STAGNATION_LIMIT 20           // Gerações sem melhora para aumentar a mutação
@@ -36,322 +63,2648 @@ FILE* ga_csv_file = NULL;
 #define MODE_REPULSION 1
 #define PI 3.1415926535
 
+// --- ESTRATÉGIA FISHER (severidade adaptativa) ---
+#define FISHER_MUTATION_RATE 20.0     // Chance fixa de mutar cada gene (%)
+#define FISHER_SEVERITY_INITIAL 0.50  // Desvio do passo gaussiano, em fração do range (busca ampla)
+#define FISHER_SEVERITY_MIN 0.0001    // Refinamento de precisão
+#define FISHER_SEVERITY_MAX 1.0       // Salto do tamanho do range
+#define FISHER_SEVERITY_DECAY 0.85    // Melhorou: encolhe o passo
+#define FISHER_SEVERITY_EXPAND 2.5    // Estagnou: amplia o passo
+#define FISHER_STAGNATION_LIMIT 15    // Gerações sem melhora antes de ampliar
+#define FISHER_CATASTROPHE_LIMIT 5    // Ampliações sem sucesso antes do reset total
+
+// --- ESTRATÉGIA POR GENE (todo gene muta) ---
+#define POR_GENE_STAGNATION_LIMIT 50  // Gerações sem melhora antes de subir a taxa
+#define POR_GENE_RATE_UP 1.2          // Estagnou: taxa x 1.2 até MUTATION_PROB_MAX
+#define POR_GENE_RATE_DOWN 1.1        // Convergindo (diversidade baixa): taxa / 1.1
+#define POR_GENE_POST_RESET_GENS 30   // Gerações de proteção depois do reset (taxa x 3)
+
+// Limite de blocos de avaliação paralela (cada bloco guarda estatísticas parciais)
+#define GA_MAX_THREADS 256
+// Menor bloco de avaliação: a divisão da população só depende do seu tamanho
+#define GA_EVAL_BLOCK 32
+
+// Modelo de ilhas: menor população por ilha e maior número de migrantes por troca
+#define GA_ISLAND_MIN_POP 8
+#define GA_MAX_MIGRANTS 64
+
+// Modelo substituto: maior k aceito (vizinhos ficam num vetor na pilha) e
+// amostras do arquivo por bloco de distâncias
+#define GA_SURR_MAX_K 32
+#define GA_SURR_TILE 256
+
+// Cache de fitness: posições sondadas a partir da origem do hash
+#define GA_CACHE_PROBES 8
+
+// Reprodução paralela: indivíduos por bloco (fixo, para o resultado não depender das threads)
+#define GA_BREED_CHUNK 256
+
+static double wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Perfil (make PROFILE=1): cronômetros por trecho do laço. Sem GA_PROFILE as
+// macros viram nada e o laço quente fica exatamente como era.
+#ifdef GA_PROFILE
+#define GA_PROF_START(t) double t = wall_seconds()
+#define GA_PROF_STOP(prof, secao, t) ((prof)->seconds[secao] += wall_seconds() - (t))
+#else
+#define GA_PROF_START(t) ((void)0)
+#define GA_PROF_STOP(prof, secao, t) ((void)0)
+#endif
+
+// Especializações por número de genes (7 e 9): GA_FIXED_DIMS(d) escolhe o case
+// do switch. Com -DGA_GENERIC_DIMS (make GENERIC_DIMS=1) tudo cai no caminho
+// genérico, para comparar as duas versões no bench.
+#ifdef GA_GENERIC_DIMS
+#define GA_FIXED_DIMS(d) ((void)(d), 0)
+#else
+#define GA_FIXED_DIMS(d) (d)
+#endif
+
+// =============================================================================
+// ESTADO DE UMA EXECUÇÃO
+// =============================================================================
+
+/** Papel de cada indivíduo na triagem do modelo substituto (uma geração). */
+enum {
+    SURR_CONHECIDO = 0, // Fitness já conhecido (elite, migrante, filho igual à elite)
+    SURR_AVALIADO,      // Filho novo avaliado (escolhido pela previsão, ou sem triagem)
+    SURR_SONDA,         // Descartado pela previsão, mas sorteado para a cota de exploração
+    SURR_DESCARTADO     // Sem avaliação nesta geração (fitness = -1e300)
+};
+
+/** Estado de uma posição do cache de fitness. */
+enum {
+    CACHE_VAZIA = 0,    // Nunca usada (encerra a sondagem)
+    CACHE_SEM_VALOR,    // Chave reservada, fitness ainda não calculado
+    CACHE_VALIDA        // Chave e fitness
+};
+
+/** Previsão do modelo substituto para um filho (ordenada na triagem). */
+typedef struct {
+    double previsto;
+    int idx;
+} SurrogateRank;
+
+/**
+ * Tudo o que uma execução do AG precisa: configuração, matrizes, gerador e os
+ * contadores do controle adaptativo. Nada disso é global, então cada ilha
+ * (thread ou processo) tem o seu GAState e evolui de forma independente.
+ * * As matrizes são "ping-pong": geração atual e próxima, alocadas uma vez. A
+ * reprodução escreve na livre e as duas trocam de papel ao final do ciclo.
+ * O fitness viaja com os genes: fitness_known[i] = 1 quando fitness[i] já vale
+ * para os genes atuais do slot i (ex: a elite copiada para o slot 0), e a
+ * avaliação pula esse indivíduo. gene_sums guarda a soma de cada gene sobre a
+ * população (centróide = soma / N), acumulada durante a própria reprodução.
+ */
+struct GaStrategyOps;
+
+typedef struct {
+    GAConfig cfg;
+    int report;                      // 1 = esta população imprime progresso e publica telemetria
+    const struct GaStrategyOps* ops; // Controle e reprodução de cfg.strategy (escolhidos uma vez)
+
+    GeneMatrix pop_buffers[2];
+    Individual* pop_views[2];
+    double* fitness_buffers[2];
+    unsigned char* known_buffers[2];
+    double* sum_buffers[2];
+    int cur_buffer;
+    Individual* population;          // Visões da geração atual (pop_views[cur_buffer])
+    double* fitness;
+    unsigned char* fitness_known;
+    double* gene_sums;
+
+    RngState rng;                    // Gerador próprio (reprodutível a partir de cfg.seed)
+    unsigned long long rng_stream;   // Fluxo de rng (a ilha); também separa os sorteios sem estado
+    double* breed_sums;              // [blocos][dims] Somas parciais da reprodução paralela (cfg.parallel_breeding)
+
+    // Controle adaptativo
+    double mutation_prob;            // Probabilidade (%)
+    double baseline_mutation;
+    int stagnation_counter;
+    int convergence_counter;         // Buffer para redução suave
+    int repulsion_mode_counter;
+    int crossover_mode;
+    int post_reset_cnt;              // Contador de proteção pós-reset
+    double severity;                 // Estratégia fisher: desvio do passo, em fração do range
+    int expansion_events;            // Estratégia fisher: ampliações seguidas sem melhora
+    int reset_pendente;              // Estratégia fisher: a próxima reprodução sorteia a população de novo
+
+    // Melhor da geração anterior: buffer fixo + fitness guardado junto (sem reavaliar)
+    Individual prev_best;
+    int has_prev_best;
+    double prev_best_fit;
+    Individual elite;                // Reaproveitado a cada geração
+    GaEvent prev_evento;             // Decimação do log: mudanças de evento sempre entram
+
+    // Critérios de parada
+    long long total_evals;
+    int gens_sem_melhora;
+    int resets_feitos;
+
+    // Resultado da geração corrente
+    double max_fit, avg_fit, std_dev_fit;
+    int best_idx;
+    double diversity;                // Calculada sob demanda, no máximo uma vez por população
+    double rep_fact;
+    GaEvent evento;                  // Evento do controle adaptativo (para o log)
+
+    GaProfile prof;                  // Tempos e contadores desta população
+    double t_ultimo_relatorio;       // Para a coluna TempoGeracaoUs (só com GA_PROFILE)
+
+    // Modelo substituto (só alocado com cfg.surrogate.enabled). Os descartados
+    // da triagem ficam com fitness_known = 1 e fitness = -1e300: a avaliação os
+    // pula e as estatísticas os tratam como inválidos.
+    double* surr_genes;              // [dims][archive_size] Genes normalizados (0..1 nos limites), em colunas
+    double* surr_fit;                // [archive_size]
+    int surr_n, surr_next;           // Amostras guardadas e próxima posição do anel
+    double* surr_inv_range;          // [dims] 1 / (gmax - gmin)
+    unsigned char* surr_marca;       // [n] SURR_* da geração corrente
+    SurrogateRank* surr_ordem;       // [n] Filhos novos ordenados pela previsão
+    int surr_triou;                  // 1 = a geração corrente passou pela triagem
+    RngState surr_rng;               // Sorteio da cota de exploração (não mexe no gerador do AG)
+
+    // Cache de fitness (só alocado com cfg.cache.entries > 0). Um filho repetido
+    // na geração fica com fitness_known = 1 e recebe o fitness do primeiro igual
+    // antes das estatísticas.
+    uint64_t* cache_chaves;          // [entries][dims] Chave de cada posição
+    double* cache_fit;               // [entries]
+    unsigned char* cache_estado;     // [entries] CACHE_*
+    int* cache_dono;                 // [entries] Filho que preenche a posição nesta geração (-1 = nenhum)
+    int cache_mask;                  // entries - 1
+    double* cache_inv_q;             // [dims] 1 / (quantum x intervalo); NULL = chave com os bits exatos
+    int* cache_slot;                 // [n] Posição reservada para o filho i (-1 = nenhuma)
+    int* cache_origem;               // [n] Primeiro filho igual nesta geração (-1 = nenhum)
+    int cache_acertos, cache_falhas; // Da geração corrente (colunas do log)
+
+    // Execução no dispositivo (só durante ga_context_run_device). A população
+    // mora no acelerador; no hospedeiro só a linha best_idx está em dia, a não
+    // ser durante um reset híbrido (que traz e devolve a matriz inteira).
+    int dev;                         // Dispositivo resolvido (ga_device_resolve)
+    double* dev_genes[2];            // [n x dims] AoS, ping-pong no dispositivo (NULL = população no hospedeiro)
+    double* dev_fitness;             // [n] No dispositivo
+    int dev_cur;                     // Matriz atual em dev_genes
+    long long dev_geracao;           // Fluxo do gerador sem estado da próxima reprodução
+} GAState;
+
+/**
+ * Uma estratégia do AG: o controle que reage à melhora/estagnação de cada
+ * geração e a reprodução que usa o estado dele. GAState guarda o ponteiro
+ * escolhido em ga_state_alloc; o laço por gene fica inteiro dentro de 'breed'.
+ */
+typedef struct GaStrategyOps {
+    const char* nome;
+    void (*adapt)(GAState* st, int improved);
+    void (*breed)(GAState* st, int gen);
+} GaStrategyOps;
+
+GAConfig ga_config_from_globals() {
+    GAConfig c;
+    c.population_size = POPULATION_SIZE;
+    c.num_dimensions = NUM_DIMENSIONS;
+    c.max_generations = MAX_GENERATIONS;
+    c.num_threads = NUM_THREADS;
+    c.gene_min = GENE_MIN_VALUE;
+    c.gene_max = GENE_MAX_VALUE;
+    c.layout = GENE_LAYOUT;
+    c.diversity_sample_size = DIVERSITY_SAMPLE_SIZE;
+    c.seed = GA_SEED;
+    c.stop = GA_STOP;
+    c.log = ga_log;
+    c.log_every = GA_LOG_EVERY;
+    c.telemetry_phase = telemetry_current_phase();
+    c.verbose = 1;
+    c.on_generation = NULL;
+    c.hook_param = NULL;
+    c.checkpoint_path = NULL;
+    c.checkpoint_every = 0;
+    c.surrogate = GA_SURROGATE;
+    c.cache = GA_FITNESS_CACHE;
+    c.device = GA_DEVICE;
+    c.parallel_breeding = GA_PARALLEL_BREEDING;
+    c.strategy = GA_STRATEGY;
+    c.fitness_id = NULL;
+    return c;
+}
+
 // =============================================================================
 // FUNÇÕES AUXILIARES (Matemática e Memória)
 // =============================================================================
 
-int are_individuals_equal(Individual a, Individual b) {
+static int are_individuals_equal(Individual a, Individual b, int dims) {
     if (a.genes == NULL || b.genes == NULL) return 0;
-    for (int i = 0; i < NUM_DIMENSIONS; i++) {
-        if (fabs(a.genes[i] - b.genes[i]) > 1e-9) return 0;
+    for (int i = 0; i < dims; i++) {
+        if (fabs(IND_GENE(a, i) - IND_GENE(b, i)) > 1e-9) return 0;
     }
     return 1;
 }
 
-double calculate_genetic_diversity() {
-    if (population == NULL || POPULATION_SIZE == 0) return 0.0;
-    Individual centroid;
-    centroid.genes = (double*)malloc(sizeof(double) * NUM_DIMENSIONS);
-    
-    // 1. Acha o centro da população
-    for (int j = 0; j < NUM_DIMENSIONS; j++) {
-        double sum = 0.0;
-        for (int i = 0; i < POPULATION_SIZE; i++) sum += population[i].genes[j];
-        centroid.genes[j] = sum / POPULATION_SIZE;
-    }
-    
-    // 2. Calcula média das distâncias até o centro
+/**
+ * Diversidade genética: distância euclidiana média dos indivíduos até o centróide.
+ * O centróide vem de gene_sums (mantido pela reprodução), então resta uma única
+ * passada sobre a população. Com 0 < diversity_sample_size < N, a média é
+ * estimada numa amostra sistemática (um indivíduo a cada N/m), sem consumir o
+ * gerador aleatório.
+ */
+static inline __attribute__((always_inline)) double genetic_diversity(const GAState* st, const int dims) {
+    int n = st->cfg.population_size;
+    if (st->population == NULL || n == 0) return 0.0;
+    double centroid[dims];
+    for (int j = 0; j < dims; j++) centroid[j] = st->gene_sums[j] / n;
+
+    int m = st->cfg.diversity_sample_size;
+    if (m <= 0 || m > n) m = n;
+
     double total_distance = 0.0;
-    for (int i = 0; i < POPULATION_SIZE; i++) {
+    for (int k = 0; k < m; k++) {
+        int i = (m == n) ? k : (int)((long long)k * n / m);
         double sq_dist = 0.0;
-        for (int j = 0; j < NUM_DIMENSIONS; j++) sq_dist += pow(population[i].genes[j] - centroid.genes[j], 2.0);
+        for (int j = 0; j < dims; j++) {
+            double d = IND_GENE(st->population[i], j) - centroid[j];
+            sq_dist += d * d;
+        }
         total_distance += sqrt(sq_dist);
     }
-    free(centroid.genes);
-    return total_distance / POPULATION_SIZE;
+    return total_distance / m;
+}
+
+/** Despacho para as versões de 7 e 9 genes (ver ga_breed) ou para a genérica. */
+static double calculate_genetic_diversity(const GAState* st) {
+    switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+        case 7:  return genetic_diversity(st, 7);
+        case 9:  return genetic_diversity(st, 9);
+        default: return genetic_diversity(st, st->cfg.num_dimensions);
+    }
+}
+
+/** Diversidade da população atual, calculada só na primeira vez que alguém pede. */
+static double current_diversity(GAState* st) {
+    if (st->diversity < 0) st->diversity = calculate_genetic_diversity(st);
+    return st->diversity;
+}
+
+/** Recalcula gene_sums da matriz atual (após a inicialização, um reset ou uma migração). */
+static void recompute_gene_sums(GAState* st) {
+    for (int j = 0; j < st->cfg.num_dimensions; j++) {
+        double sum = 0.0;
+        for (int i = 0; i < st->cfg.population_size; i++) sum += IND_GENE(st->population[i], j);
+        st->gene_sums[j] = sum;
+    }
 }
 
-Individual clone_individual(const Individual* src) {
+/** Cópia profunda e contígua (stride = 1), independente do layout da origem. */
+static Individual clone_individual(const Individual* src, int dims) {
     Individual dest;
-    dest.genes = (double*)malloc(sizeof(double) * NUM_DIMENSIONS);
-    memcpy(dest.genes, src->genes, sizeof(double) * NUM_DIMENSIONS);
+    dest.genes = (double*)malloc(sizeof(double) * dims);
+    dest.stride = 1;
+    for (int j = 0; j < dims; j++) dest.genes[j] = IND_GENE(*src, j);
     return dest;
 }
 
-void initialize_population() {
-    if (population) free_population();
-    population = (Individual*)malloc(sizeof(Individual) * POPULATION_SIZE);
-    fitness = (double*)malloc(sizeof(double) * POPULATION_SIZE);
-    for (int i = 0; i < POPULATION_SIZE; i++) {
-        population[i].genes = (double*)malloc(sizeof(double) * NUM_DIMENSIONS);
-        fitness[i] = -1e300; 
-        for (int j = 0; j < NUM_DIMENSIONS; j++) {
-            double range = (GENE_MAX_VALUE[j] - GENE_MIN_VALUE[j]);
+/** malloc/calloc contados no perfil da população. */
+static void* st_malloc(GAState* st, size_t n) {
+    st->prof.allocations++;
+    return malloc(n);
+}
+
+static void* st_calloc(GAState* st, size_t n, size_t size) {
+    st->prof.allocations++;
+    return calloc(n, size);
+}
+
+/** Aloca uma matriz de genes no layout escolhido e monta as visões por indivíduo. */
+static void alloc_gene_buffer(GAState* st, int b) {
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions;
+    GeneMatrix* m = &st->pop_buffers[b];
+    m->n = n;
+    m->dims = dims;
+    m->data = (double*)st_malloc(st, sizeof(double) * n * dims);
+    if (st->cfg.layout == GA_LAYOUT_SOA) { m->ind_stride = 1; m->gene_stride = n; }
+    else                                 { m->ind_stride = dims; m->gene_stride = 1; }
+
+    st->pop_views[b] = (Individual*)st_malloc(st, sizeof(Individual) * n);
+    for (int i = 0; i < n; i++) {
+        st->pop_views[b][i].genes = &GM_AT(m, i, 0);
+        st->pop_views[b][i].stride = m->gene_stride;
+    }
+
+    st->fitness_buffers[b] = (double*)st_malloc(st, sizeof(double) * n);
+    st->known_buffers[b] = (unsigned char*)st_calloc(st, n, 1);
+    st->sum_buffers[b] = (double*)st_calloc(st, dims, sizeof(double));
+}
+
+/** Troca os papéis das matrizes: a "próxima" geração passa a ser a atual. */
+static void swap_gene_buffers(GAState* st) {
+    st->cur_buffer ^= 1;
+    st->population = st->pop_views[st->cur_buffer];
+    st->fitness = st->fitness_buffers[st->cur_buffer];
+    st->fitness_known = st->known_buffers[st->cur_buffer];
+    st->gene_sums = st->sum_buffers[st->cur_buffer];
+}
+
+/** Execução no dispositivo: a matriz atual do hospedeiro vai para o acelerador. */
+static void device_push_population(GAState* st) {
+    size_t bytes = sizeof(double) * st->cfg.population_size * st->cfg.num_dimensions;
+    ga_device_put(st->dev_genes[st->dev_cur], st->pop_buffers[st->cur_buffer].data, bytes, st->dev);
+}
+
+/** Execução no dispositivo: traz a população inteira para a matriz atual do hospedeiro. */
+static void device_pull_population(GAState* st) {
+    size_t bytes = sizeof(double) * st->cfg.population_size * st->cfg.num_dimensions;
+    ga_device_get(st->pop_buffers[st->cur_buffer].data, st->dev_genes[st->dev_cur], bytes, st->dev);
+}
+
+/** Aloca as matrizes e buffers de uma população (uma vez por contexto). */
+static const struct GaStrategyOps* strategy_ops(GaStrategy s);
+
+static void ga_state_alloc(GAState* st, const GAConfig* cfg) {
+    memset(st, 0, sizeof(*st));
+    st->cfg = *cfg;
+    st->ops = strategy_ops(cfg->strategy);
+    alloc_gene_buffer(st, 0);
+    alloc_gene_buffer(st, 1);
+    st->prev_best.genes = (double*)st_malloc(st, sizeof(double) * cfg->num_dimensions);
+    st->prev_best.stride = 1;
+    st->elite.genes = (double*)st_malloc(st, sizeof(double) * cfg->num_dimensions);
+    st->elite.stride = 1;
+    if (cfg->parallel_breeding) {
+        int blocos = (cfg->population_size - 1 + GA_BREED_CHUNK - 1) / GA_BREED_CHUNK;
+        st->breed_sums = (double*)st_malloc(st, sizeof(double) * (blocos > 0 ? blocos : 1) * cfg->num_dimensions);
+    }
+
+    GaSurrogateConfig* sc = &st->cfg.surrogate;
+    if (sc->enabled) {
+        int n = cfg->population_size, dims = cfg->num_dimensions;
+        if (sc->archive_size < 1) sc->archive_size = 1;
+        if (sc->k < 1) sc->k = 1;
+        if (sc->k > GA_SURR_MAX_K) sc->k = GA_SURR_MAX_K;
+        st->surr_genes = (double*)st_malloc(st, sizeof(double) * sc->archive_size * dims);
+        st->surr_fit = (double*)st_malloc(st, sizeof(double) * sc->archive_size);
+        st->surr_inv_range = (double*)st_malloc(st, sizeof(double) * dims);
+        st->surr_marca = (unsigned char*)st_calloc(st, n, 1);
+        st->surr_ordem = (SurrogateRank*)st_malloc(st, sizeof(SurrogateRank) * n);
+        for (int j = 0; j < dims; j++) {
+            double range = cfg->gene_max[j] - cfg->gene_min[j];
+            st->surr_inv_range[j] = 1.0 / (range < 1e-9 ? 1e-9 : range);
+        }
+    }
+
+    GaFitnessCacheConfig* cc = &st->cfg.cache;
+    if (cc->entries > 0) {
+        int n = cfg->population_size, dims = cfg->num_dimensions;
+        int e = 1;
+        while (e < cc->entries && e < (1 << 30)) e <<= 1;
+        cc->entries = e;
+        st->cache_mask = e - 1;
+        st->cache_chaves = (uint64_t*)st_malloc(st, sizeof(uint64_t) * e * dims);
+        st->cache_fit = (double*)st_malloc(st, sizeof(double) * e);
+        st->cache_estado = (unsigned char*)st_calloc(st, e, 1);
+        st->cache_dono = (int*)st_malloc(st, sizeof(int) * e);
+        st->cache_slot = (int*)st_malloc(st, sizeof(int) * n);
+        st->cache_origem = (int*)st_malloc(st, sizeof(int) * n);
+        if (cc->quantum > 0) {
+            st->cache_inv_q = (double*)st_malloc(st, sizeof(double) * dims);
+            for (int j = 0; j < dims; j++) {
+                double range = cfg->gene_max[j] - cfg->gene_min[j];
+                st->cache_inv_q[j] = 1.0 / (cc->quantum * (range < 1e-9 ? 1e-9 : range));
+            }
+        }
+    }
+}
+
+/** Zera os tempos e contadores de uma execução (as alocações são do contexto inteiro). */
+static void ga_prof_reset(GAState* st) {
+    long long alocacoes = st->prof.allocations;
+    memset(&st->prof, 0, sizeof(st->prof));
+    st->prof.allocations = alocacoes;
+#ifdef GA_PROFILE
+    st->prof.enabled = 1;
+    st->t_ultimo_relatorio = wall_seconds();
+#endif
+}
+
+/**
+ * Começa uma execução nos buffers já alocados: semeia o gerador no fluxo
+ * 'stream' (0 = o mesmo de rng_seed(seed)), sorteia a população inicial e
+ * zera o controle adaptativo e os contadores de parada.
+ */
+static void ga_state_reset(GAState* st, unsigned long long seed, unsigned long long stream) {
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions;
+    const double* gmin = st->cfg.gene_min;
+    const double* gmax = st->cfg.gene_max;
+    st->cfg.seed = seed;
+    st->rng_stream = stream;
+    rng_seed_stream(&st->rng, seed, stream);
+
+    for (int b = 0; b < 2; b++) memset(st->known_buffers[b], 0, n);
+    st->cur_buffer = 1;
+    swap_gene_buffers(st); // Começa na matriz 0
+    for (int i = 0; i < n; i++) {
+        st->fitness[i] = -1e300;
+        for (int j = 0; j < dims; j++) {
+            double range = (gmax[j] - gmin[j]);
             if (range < 1e-9) range = 1e-9;
-            population[i].genes[j] = GENE_MIN_VALUE[j] + ((double)rand()/RAND_MAX) * range;
+            IND_GENE(st->population[i], j) = gmin[j] + rng_uniform(&st->rng) * range;
         }
     }
+    recompute_gene_sums(st);
+
+    st->mutation_prob = MUTATION_PROB_INITIAL;
+    st->baseline_mutation = MUTATION_PROB_INITIAL;
+    st->stagnation_counter = 0;
+    st->convergence_counter = 0;
+    st->repulsion_mode_counter = 0;
+    st->crossover_mode = MODE_ATTRACTION;
+    st->post_reset_cnt = 0;
+    st->severity = FISHER_SEVERITY_INITIAL;
+    st->expansion_events = 0;
+    st->reset_pendente = 0;
+    st->has_prev_best = 0;
+    st->prev_best_fit = -1e300;
+    st->prev_evento = GA_EVT_NENHUM;
+    st->total_evals = 0;
+    st->gens_sem_melhora = 0;
+    st->resets_feitos = 0;
+    st->surr_n = st->surr_next = 0;
+    st->surr_triou = 0;
+    rng_seed_stream(&st->surr_rng, seed ^ 0x5EED5A7E5A7E5EEDULL, stream);
+    if (st->cache_chaves) {
+        memset(st->cache_estado, CACHE_VAZIA, st->cfg.cache.entries); // A fitness pode ser outra nesta execução
+        for (int s = 0; s < st->cfg.cache.entries; s++) st->cache_dono[s] = -1;
+    }
+    st->cache_acertos = st->cache_falhas = 0;
+    ga_prof_reset(st);
 }
 
-void free_population() {
-    if (population) {
-        for (int i = 0; i < POPULATION_SIZE; i++) free(population[i].genes);
-        free(population); population = NULL;
+static void ga_state_free(GAState* st) {
+    for (int b = 0; b < 2; b++) {
+        free(st->pop_buffers[b].data);
+        free(st->pop_views[b]);
+        free(st->fitness_buffers[b]);
+        free(st->known_buffers[b]);
+        free(st->sum_buffers[b]);
     }
-    if (fitness) { free(fitness); fitness = NULL; }
+    free(st->prev_best.genes);
+    free(st->elite.genes);
+    free(st->breed_sums);
+    free(st->surr_genes);
+    free(st->surr_fit);
+    free(st->surr_inv_range);
+    free(st->surr_marca);
+    free(st->surr_ordem);
+    free(st->cache_chaves);
+    free(st->cache_fit);
+    free(st->cache_estado);
+    free(st->cache_dono);
+    free(st->cache_inv_q);
+    free(st->cache_slot);
+    free(st->cache_origem);
+    memset(st, 0, sizeof(*st));
+}
+
+/** Índice do melhor indivíduo da população atual (empate: menor índice). */
+static int ga_best_index(const GAState* st) {
+    int best = 0;
+    for (int i = 1; i < st->cfg.population_size; i++)
+        if (st->fitness[i] > st->fitness[best]) best = i;
+    return best;
 }
 
 // =============================================================================
-// MOTOR PRINCIPAL (GA CYCLE)
+// AVALIAÇÃO PARALELA
 // =============================================================================
-Individual run_ga_cycle(double (*fitness_func)(Individual, const void*), const void* extra_param, int is_shape_opt) {
-    
-    initialize_population();
-    
-    // Variáveis de Estado
-    double mutation_prob = MUTATION_PROB_INITIAL; // Probabilidade (%)
-    double baseline_mutation = MUTATION_PROB_INITIAL;
-    
-    int stagnation_counter = 0;
-    int convergence_counter = 0; // Buffer para redução suave
-    int repulsion_mode_counter = 0;
-    int crossover_mode = MODE_ATTRACTION;
-    int post_reset_cnt = 0; // Contador de proteção pós-reset
-    
-    Individual prev_best = {NULL};
-
-    // Cabeçalho CSV
-    if (ga_csv_file != NULL) {
-        fprintf(ga_csv_file, "Geracao,MelhorFitness,FitnessMedio,DesvioPadraoFit,DiversidadeGenetica,TaxaMutacao,FatorRepulsao,Evento\n");
-    }
-
-    for (int gen = 0; gen < MAX_GENERATIONS; gen++) {
-        double total_fitness = 0.0;
-        double max_fit = -1e300;
-        int best_idx = 0;
-        int valid = 0;
-        char event_str[30] = "-"; // String para logar eventos
-
-        // ---------------------------------------------------------
-        // 1. AVALIAÇÃO DA POPULAÇÃO
-        // ---------------------------------------------------------
-        for (int i = 0; i < POPULATION_SIZE; i++) {
-            double f = fitness_func(population[i], extra_param);
-            if (f > -1e200) {
-                fitness[i] = f;
-                total_fitness += f;
-                if (f > max_fit) { max_fit = f; best_idx = i; }
-                valid++;
-            } else {
-                fitness[i] = -1e300;
+
+/** Estatísticas parciais de um bloco contíguo da população. */
+typedef struct {
+    double total;   // Soma dos fitness válidos
+    double max_fit; // Melhor fitness do bloco
+    int best_idx;   // Índice global do melhor do bloco
+    int valid;      // Quantidade de indivíduos válidos
+    int evals;      // Chamadas de fitness de fato feitas (sem os reaproveitados)
+    int invalid;    // Das quais devolveram um indivíduo inválido
+} EvalPartial;
+
+/** Resolve num_threads (<= 0 = automático) para a quantidade efetiva de blocos. */
+static int resolve_thread_count(int n, int limit) {
+#ifdef _OPENMP
+    if (n <= 0) n = omp_get_num_procs();
+#else
+    if (n <= 0) n = 1;
+#endif
+    if (n > GA_MAX_THREADS) n = GA_MAX_THREADS;
+    if (n > limit) n = limit;
+    return (n < 1) ? 1 : n;
+}
+
+/**
+ * Avalia os indivíduos [begin, end) e conta as chamadas feitas no bloco.
+ * Indivíduos com fitness_known[i] já têm o fitness certo e não são reavaliados.
+ * Com fitness em lote, cada trecho contíguo a avaliar vira uma única chamada.
+ */
+static void evaluate_range(GAState* st, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch, const void* extra_param,
+                           int begin, int end, EvalPartial* out) {
+    double* fitness = st->fitness;
+    unsigned char* fitness_known = st->fitness_known;
+    if (fitness_batch) {
+        int i = begin;
+        while (i < end) {
+            while (i < end && fitness_known[i]) i++;
+            int run_begin = i;
+            while (i < end && !fitness_known[i]) i++;
+            if (i > run_begin) fitness_batch(&st->pop_buffers[st->cur_buffer], run_begin, i, fitness, extra_param);
+        }
+    }
+
+    out->evals = 0; out->invalid = 0;
+    for (int i = begin; i < end; i++) {
+        if (fitness_known[i]) continue;
+        if (!fitness_batch) fitness[i] = fitness_func(st->population[i], extra_param);
+        fitness_known[i] = 1;
+        out->evals++;
+        out->invalid += !(fitness[i] > -1e200);
+    }
+}
+
+/**
+ * Estatísticas do bloco [begin, end), depois que toda a população tem fitness
+ * (inclusive os filhos copiados de um igual avaliado em outro bloco).
+ */
+static void range_statistics(GAState* st, int begin, int end, EvalPartial* out) {
+    double* fitness = st->fitness;
+    out->total = 0.0; out->max_fit = -1e300; out->best_idx = begin; out->valid = 0;
+    for (int i = begin; i < end; i++) {
+        double f = fitness[i];
+        if (f > -1e200) {
+            fitness[i] = f;
+            out->total += f;
+            if (f > out->max_fit) { out->max_fit = f; out->best_idx = i; }
+            out->valid++;
+        } else {
+            fitness[i] = -1e300;
+        }
+    }
+}
+
+// =============================================================================
+// CACHE DE FITNESS
+// =============================================================================
+
+/** Chave dos genes do indivíduo i (bits exatos ou passo do quantum) e o seu hash. */
+static uint64_t fitness_cache_key(const GAState* st, int i, uint64_t* chave) {
+    uint64_t h = 0x9E3779B97F4A7C15ULL;
+    for (int j = 0; j < st->cfg.num_dimensions; j++) {
+        double g = IND_GENE(st->population[i], j);
+        uint64_t c;
+        if (st->cache_inv_q) c = (uint64_t)llround((g - st->cfg.gene_min[j]) * st->cache_inv_q[j]);
+        else memcpy(&c, &g, sizeof(c));
+        chave[j] = c;
+        h ^= c;
+        h *= 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+/**
+ * Antes da avaliação (serial): resolve pela tabela os filhos novos já vistos e
+ * liga cada filho igual a outro desta geração ao primeiro deles. Cada falha
+ * reserva uma posição (sondagem linear de até GA_CACHE_PROBES; cheia, a posição
+ * de origem é substituída) que fitness_cache_store preenche depois da avaliação.
+ */
+static void fitness_cache_lookup(GAState* st) {
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions;
+    uint64_t chave[dims];
+    st->cache_acertos = st->cache_falhas = 0;
+    for (int i = 0; i < n; i++) {
+        st->cache_slot[i] = st->cache_origem[i] = -1;
+        if (st->fitness_known[i]) continue;
+        uint64_t h = fitness_cache_key(st, i, chave);
+        int origem = (int)(h & st->cache_mask), achou = -1, vazia = -1;
+        for (int p = 0; p < GA_CACHE_PROBES; p++) {
+            int s = (origem + p) & st->cache_mask;
+            if (st->cache_estado[s] == CACHE_VAZIA) { vazia = s; break; }
+            if (memcmp(st->cache_chaves + (size_t)s * dims, chave, sizeof(uint64_t) * dims) == 0) { achou = s; break; }
+        }
+        if (achou >= 0 && st->cache_dono[achou] >= 0) {
+            // Igual a um filho desta geração: copia o fitness dele depois da avaliação
+            st->cache_origem[i] = st->cache_dono[achou];
+            st->fitness_known[i] = 1;
+            st->cache_acertos++;
+            continue;
+        }
+        if (achou >= 0 && st->cache_estado[achou] == CACHE_VALIDA) {
+            st->fitness[i] = st->cache_fit[achou];
+            st->fitness_known[i] = 1;
+            st->cache_acertos++;
+            continue;
+        }
+        st->cache_falhas++;
+        int s = (achou >= 0) ? achou : (vazia >= 0) ? vazia : origem;
+        if (st->cache_dono[s] >= 0) continue; // Reservada por outro filho: este fica fora da tabela
+        memcpy(st->cache_chaves + (size_t)s * dims, chave, sizeof(uint64_t) * dims);
+        st->cache_estado[s] = CACHE_SEM_VALOR;
+        st->cache_dono[s] = i;
+        st->cache_slot[i] = s;
+    }
+    st->prof.cache_hits += st->cache_acertos;
+    st->prof.cache_misses += st->cache_falhas;
+}
+
+/** Depois da avaliação: copia o fitness para os filhos repetidos e preenche as posições reservadas. */
+static void fitness_cache_store(GAState* st) {
+    int n = st->cfg.population_size;
+    for (int i = 0; i < n; i++) {
+        if (st->cache_origem[i] >= 0) st->fitness[i] = st->fitness[st->cache_origem[i]];
+        int s = st->cache_slot[i];
+        if (s < 0) continue;
+        st->cache_dono[s] = -1;
+        // Descartado pelo modelo substituto: a chave fica, sem valor, até ser avaliada
+        if (st->cfg.surrogate.enabled && st->surr_marca[i] == SURR_DESCARTADO) continue;
+        st->cache_fit[s] = st->fitness[i];
+        st->cache_estado[s] = CACHE_VALIDA;
+    }
+}
+
+// =============================================================================
+// MODELO SUBSTITUTO (TRIAGEM DOS FILHOS)
+// =============================================================================
+
+/** Genes do indivíduo i normalizados pelos limites (0..1), com 'stride' entre genes. */
+static void surrogate_normalize(const GAState* st, int i, double* x, size_t stride) {
+    for (int j = 0; j < st->cfg.num_dimensions; j++)
+        x[j * stride] = (IND_GENE(st->population[i], j) - st->cfg.gene_min[j]) * st->surr_inv_range[j];
+}
+
+/**
+ * Previsão do fitness em x: média dos k vizinhos mais próximos do arquivo com
+ * pesos 1/d^2 (um vizinho à distância zero devolve o próprio fitness).
+ * As distâncias saem em blocos de GA_SURR_TILE amostras, gene a gene sobre o
+ * arquivo em colunas (laço vetorizável); só a seleção dos k tem desvios.
+ */
+static double surrogate_predict(const GAState* st, const double* x) {
+    int dims = st->cfg.num_dimensions, cap = st->cfg.surrogate.archive_size;
+    int k = st->cfg.surrogate.k;
+    double d2k[GA_SURR_MAX_K], fk[GA_SURR_MAX_K];
+    double d2[GA_SURR_TILE];
+    int m = 0;
+    for (int a0 = 0; a0 < st->surr_n; a0 += GA_SURR_TILE) {
+        int na = (st->surr_n - a0 < GA_SURR_TILE) ? st->surr_n - a0 : GA_SURR_TILE;
+        for (int a = 0; a < na; a++) d2[a] = 0.0;
+        for (int j = 0; j < dims; j++) {
+            const double* y = st->surr_genes + (size_t)j * cap + a0;
+            double xj = x[j];
+#ifdef _OPENMP
+            #pragma omp simd
+#endif
+            for (int a = 0; a < na; a++) { double t = xj - y[a]; d2[a] += t * t; }
+        }
+        for (int a = 0; a < na; a++) {
+            if (m == k && d2[a] >= d2k[k - 1]) continue;
+            int p = (m < k) ? m++ : k - 1; // Inserção ordenada entre os k mais próximos
+            while (p > 0 && d2k[p - 1] > d2[a]) { d2k[p] = d2k[p - 1]; fk[p] = fk[p - 1]; p--; }
+            d2k[p] = d2[a];
+            fk[p] = st->surr_fit[a0 + a];
+        }
+    }
+    if (m == 0) return -1e300;
+    if (d2k[0] <= 0.0) return fk[0];
+    double soma_w = 0.0, soma_f = 0.0;
+    for (int v = 0; v < m; v++) { double w = 1.0 / d2k[v]; soma_w += w; soma_f += w * fk[v]; }
+    return soma_f / soma_w;
+}
+
+/** Maior previsão primeiro; empate pelo menor índice (ordem total, então qsort é determinístico). */
+static int surrogate_rank_cmp(const void* a, const void* b) {
+    const SurrogateRank* x = (const SurrogateRank*)a;
+    const SurrogateRank* y = (const SurrogateRank*)b;
+    if (x->previsto != y->previsto) return (x->previsto > y->previsto) ? -1 : 1;
+    return x->idx - y->idx;
+}
+
+/**
+ * Antes da avaliação: marca os filhos novos e, com o arquivo cheio, deixa de
+ * fora da fitness os que a previsão põe abaixo do corte (fora a cota sorteada).
+ * As previsões são independentes (paralelas sem mudar o resultado); a ordem e o
+ * sorteio são seriais.
+ */
+static void surrogate_screen(GAState* st, int n_threads) {
+    const GaSurrogateConfig* sc = &st->cfg.surrogate;
+    int n = st->cfg.population_size;
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        st->surr_marca[i] = st->fitness_known[i] ? SURR_CONHECIDO : SURR_AVALIADO;
+        if (!st->fitness_known[i]) st->surr_ordem[m++].idx = i;
+    }
+    st->surr_triou = (st->surr_n >= sc->archive_size && m >= 2);
+    if (!st->surr_triou) return;
+
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) num_threads(n_threads) if(n_threads > 1)
+#endif
+    for (int c = 0; c < m; c++) {
+        double x[st->cfg.num_dimensions];
+        surrogate_normalize(st, st->surr_ordem[c].idx, x, 1);
+        st->surr_ordem[c].previsto = surrogate_predict(st, x);
+    }
+    qsort(st->surr_ordem, m, sizeof(SurrogateRank), surrogate_rank_cmp);
+
+    int n_aval = (int)ceil(sc->eval_fraction * m);
+    if (n_aval < 1) n_aval = 1;
+    if (n_aval > m) n_aval = m;
+    int n_sonda = (int)ceil(sc->explore_fraction * m);
+    if (n_sonda < 0) n_sonda = 0;
+    if (n_sonda > m - n_aval) n_sonda = m - n_aval;
+    // Cota de exploração: Fisher-Yates parcial sobre os descartados
+    for (int c = n_aval; c < n_aval + n_sonda; c++) {
+        int r = c + rng_below(&st->surr_rng, m - c);
+        SurrogateRank t = st->surr_ordem[c]; st->surr_ordem[c] = st->surr_ordem[r]; st->surr_ordem[r] = t;
+        st->surr_marca[st->surr_ordem[c].idx] = SURR_SONDA;
+    }
+    for (int c = n_aval + n_sonda; c < m; c++) {
+        int i = st->surr_ordem[c].idx;
+        st->surr_marca[i] = SURR_DESCARTADO;
+        st->fitness[i] = -1e300;
+        st->fitness_known[i] = 1;
+    }
+    st->prof.surrogate_candidates += m;
+    st->prof.surrogate_skipped += m - n_aval - n_sonda;
+}
+
+/**
+ * Depois da avaliação: guarda as avaliações válidas no arquivo (anel, na ordem
+ * dos índices) e confere as sondas contra a média real dos escolhidos.
+ */
+static void surrogate_update(GAState* st) {
+    const GaSurrogateConfig* sc = &st->cfg.surrogate;
+    int n = st->cfg.population_size;
+    double soma = 0.0;
+    int validos = 0;
+    for (int i = 0; i < n; i++) {
+        int marca = st->surr_marca[i];
+        if (marca != SURR_AVALIADO && marca != SURR_SONDA) continue;
+        if (!(st->fitness[i] > -1e200)) continue;
+        if (marca == SURR_AVALIADO) { soma += st->fitness[i]; validos++; }
+        surrogate_normalize(st, i, st->surr_genes + st->surr_next, (size_t)sc->archive_size); // Coluna por gene
+        st->surr_fit[st->surr_next] = st->fitness[i];
+        st->surr_next = (st->surr_next + 1) % sc->archive_size;
+        if (st->surr_n < sc->archive_size) st->surr_n++;
+    }
+    if (!st->surr_triou) return;
+    double media = (validos > 0) ? soma / validos : -1e300;
+    for (int i = 0; i < n; i++) {
+        if (st->surr_marca[i] != SURR_SONDA) continue;
+        st->prof.surrogate_probes++;
+        st->prof.surrogate_hits += !(st->fitness[i] > media);
+    }
+}
+
+/**
+ * Avalia a população inteira, dividida em blocos fixos, e calcula as
+ * estatísticas da geração.
+ * O tamanho dos blocos só depende da população (GA_EVAL_BLOCK, ou mais para
+ * caber em GA_MAX_THREADS blocos) e as threads vão pegando blocos. As parciais
+ * são combinadas na ordem dos blocos, então médias e desvios saem com os mesmos
+ * bits com qualquer número de threads. Em caso de empate, vence o menor índice
+ * (mesma regra do laço serial).
+ */
+static void ga_evaluate(GAState* st, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch, const void* extra_param) {
+    EvalPartial partial[GA_MAX_THREADS];
+    int n = st->cfg.population_size;
+    int bloco = (n + GA_MAX_THREADS - 1) / GA_MAX_THREADS;
+    if (bloco < GA_EVAL_BLOCK) bloco = GA_EVAL_BLOCK;
+    int n_blocks = (n + bloco - 1) / bloco;
+    int n_threads = resolve_thread_count(st->cfg.num_threads, n_blocks);
+
+    if (st->cache_chaves) {
+        GA_PROF_START(t_cache);
+        fitness_cache_lookup(st);
+        GA_PROF_STOP(&st->prof, GA_PROF_AVALIACAO, t_cache);
+    }
+    if (st->cfg.surrogate.enabled) {
+        GA_PROF_START(t_triagem);
+        surrogate_screen(st, n_threads);
+        GA_PROF_STOP(&st->prof, GA_PROF_SUBSTITUTO, t_triagem);
+    }
+
+    GA_PROF_START(t_avaliacao);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(n_threads) if(n_threads > 1)
+#endif
+    for (int b = 0; b < n_blocks; b++) {
+        int begin = b * bloco;
+        int end = (begin + bloco < n) ? begin + bloco : n;
+        evaluate_range(st, fitness_func, fitness_batch, extra_param, begin, end, &partial[b]);
+    }
+    GA_PROF_STOP(&st->prof, GA_PROF_AVALIACAO, t_avaliacao);
+
+    if (st->cache_chaves) {
+        GA_PROF_START(t_cache);
+        fitness_cache_store(st);
+        GA_PROF_STOP(&st->prof, GA_PROF_AVALIACAO, t_cache);
+    }
+    if (st->cfg.surrogate.enabled) {
+        GA_PROF_START(t_arquivo);
+        surrogate_update(st);
+        GA_PROF_STOP(&st->prof, GA_PROF_SUBSTITUTO, t_arquivo);
+    }
+
+    GA_PROF_START(t_estatisticas);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(n_threads) if(n_threads > 1)
+#endif
+    for (int b = 0; b < n_blocks; b++) {
+        int begin = b * bloco;
+        int end = (begin + bloco < n) ? begin + bloco : n;
+        range_statistics(st, begin, end, &partial[b]);
+    }
+    double total_fitness = 0.0;
+    int valid = 0;
+    st->max_fit = -1e300; st->best_idx = 0;
+    for (int b = 0; b < n_blocks; b++) {
+        total_fitness += partial[b].total;
+        valid += partial[b].valid;
+        st->total_evals += partial[b].evals;
+        st->prof.evaluations += partial[b].evals;
+        st->prof.invalid += partial[b].invalid;
+        if (partial[b].max_fit > st->max_fit) { st->max_fit = partial[b].max_fit; st->best_idx = partial[b].best_idx; }
+    }
+
+    // Estatísticas Básicas
+    st->avg_fit = (valid > 0) ? total_fitness/valid : 0.0;
+    double variance_fit = 0.0;
+    if (valid > 0) {
+        for (int i = 0; i < n; i++) {
+            if (st->fitness[i] > -1e200) variance_fit += pow(st->fitness[i] - st->avg_fit, 2.0);
+        }
+        variance_fit /= valid;
+    }
+    st->std_dev_fit = sqrt(variance_fit);
+    st->diversity = -1.0;
+    st->evento = GA_EVT_NENHUM;
+    GA_PROF_STOP(&st->prof, GA_PROF_ESTATISTICAS, t_estatisticas);
+}
+
+// =============================================================================
+// LÓGICA ADAPTATIVA (O Cérebro do Algoritmo)
+// =============================================================================
+
+/** Reset híbrido: troca metade da população por Frankenstein + EDA + aleatórios. */
+static void hybrid_reset(GAState* st) {
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions;
+    const double* gmin = st->cfg.gene_min;
+    const double* gmax = st->cfg.gene_max;
+    Individual* population = st->population;
+
+    if (st->dev_genes[0]) device_pull_population(st); // No dispositivo, só o reset vê a matriz inteira
+
+    int reset_cnt = (int)(n * RESET_PERCENTAGE); // 50%
+    int survivor_count = n - reset_cnt;
+    int current_fill_idx = survivor_count;
+
+    // --- 1. O FRANKENSTEIN ---
+    if (current_fill_idx < n) {
+        for (int d = 0; d < dims; d++) {
+            int random_parent = rng_below(&st->rng, survivor_count);
+            IND_GENE(population[current_fill_idx], d) = IND_GENE(population[random_parent], d);
+        }
+        st->fitness[current_fill_idx] = -1e300;
+        st->fitness_known[current_fill_idx] = 0;
+        current_fill_idx++;
+    }
+
+    // --- 2. O EDA (Estimation of Distribution) ---
+    if (current_fill_idx < n) {
+        for (int d = 0; d < dims; d++) {
+            // Estatísticas da Elite
+            double sum = 0.0, sum_sq = 0.0;
+            for(int k = 0; k < survivor_count; k++) {
+                double val = IND_GENE(population[k], d);
+                sum += val; sum_sq += val * val;
             }
+            double mean = sum / survivor_count;
+            double variance = (sum_sq / survivor_count) - (mean * mean);
+            double std_dev = (variance > 0) ? sqrt(variance) : 0.0;
+
+            // Box-Muller (Gaussiana)
+            double u1 = rng_uniform(&st->rng);
+            double u2 = rng_uniform(&st->rng);
+            if(u1 < 1e-9) u1 = 1e-9;
+            double z0 = sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+            double new_gene = mean + z0 * std_dev;
+
+            // Clamps
+            if(new_gene > gmax[d]) new_gene = gmax[d];
+            if(new_gene < gmin[d]) new_gene = gmin[d];
+
+            IND_GENE(population[current_fill_idx], d) = new_gene;
         }
-        
-        // Estatísticas Básicas
-        double avg_fit = (valid > 0) ? total_fitness/valid : 0.0;
-        double variance_fit = 0.0;
-        if (valid > 0) {
-            for (int i = 0; i < POPULATION_SIZE; i++) {
-                if (fitness[i] > -1e200) variance_fit += pow(fitness[i] - avg_fit, 2.0);
+        st->fitness[current_fill_idx] = -1e300;
+        st->fitness_known[current_fill_idx] = 0;
+        current_fill_idx++;
+    }
+
+    // --- 3. ALEATÓRIOS PUROS ---
+    for(int k = current_fill_idx; k < n; k++) {
+        for(int d = 0; d < dims; d++)
+            IND_GENE(population[k], d) = gmin[d] + rng_uniform(&st->rng)*(gmax[d]-gmin[d]);
+        st->fitness[k] = -1e300;
+        st->fitness_known[k] = 0;
+    }
+
+    // A população mudou: centróide e diversidade precisam ser refeitos
+    recompute_gene_sums(st);
+    st->diversity = -1.0;
+    st->resets_feitos++;
+    if (st->dev_genes[0]) device_push_population(st);
+}
+
+/**
+ * Estratégia hibrida (padrão): sem melhora por STAGNATION_LIMIT gerações, a
+ * chance de mutação sobe até o teto; no teto, entra a repulsão; repulsão sem
+ * sucesso por RESET_AFTER_REPULSION_GENS gerações dispara o reset híbrido.
+ */
+static void adapt_hibrida(GAState* st, int improved) {
+    if (st->post_reset_cnt > 0) {
+        // Proteção Pós-Reset: Alta mutação para misturar genes
+        st->post_reset_cnt--;
+        st->mutation_prob = st->baseline_mutation * 2.0;
+        st->crossover_mode = MODE_ATTRACTION;
+        st->evento = GA_EVT_POS_RESET;
+    } else {
+        if (improved) {
+            // SUCESSO: Algoritmo está avançando
+            st->stagnation_counter = 0;
+            st->repulsion_mode_counter = 0;
+            st->crossover_mode = MODE_ATTRACTION;
+
+            // Controle pela Dispersão com Buffer
+            if (current_diversity(st) < GENETIC_DIVERSITY_THRESHOLD) {
+                st->convergence_counter++; // Acumula consistência
+
+                if (st->convergence_counter >= CONVERGENCE_BUFFER) {
+                    st->mutation_prob /= 1.5; // Redução suave
+                    st->convergence_counter = 0; // Reseta buffer
+                }
+            } else {
+                st->mutation_prob = st->baseline_mutation; // Mantém ritmo normal
+                st->convergence_counter = 0;
             }
-            variance_fit /= valid;
-        }
-        double std_dev_fit = sqrt(variance_fit);
-
-        // Verifica Melhora (Elitismo Global)
-        Individual curr_best = clone_individual(&population[best_idx]);
-        int improved = 0;
-        if (prev_best.genes && max_fit > -1e200) {
-             double prev_f = fitness_func(prev_best, extra_param);
-             // Considera melhora se fitness aumentou E genes mudaram significativamente
-             if (max_fit > prev_f + 1e-9 && !are_individuals_equal(curr_best, prev_best)) improved = 1;
-        } else if (max_fit > -1e200) improved = 1;
-
-        // ---------------------------------------------------------
-        // 2. LÓGICA ADAPTATIVA (O Cérebro do Algoritmo)
-        // ---------------------------------------------------------
-        
-        if (post_reset_cnt > 0) {
-            // Proteção Pós-Reset: Alta mutação para misturar genes
-            post_reset_cnt--; 
-            mutation_prob = baseline_mutation * 2.0; 
-            crossover_mode = MODE_ATTRACTION;
-            strcpy(event_str, "POS-RESET");
+
         } else {
-            if (improved) {
-                // SUCESSO: Algoritmo está avançando
-                stagnation_counter = 0; 
-                repulsion_mode_counter = 0; 
-                crossover_mode = MODE_ATTRACTION;
-                
-                // Controle pela Dispersão com Buffer
-                if (calculate_genetic_diversity() < GENETIC_DIVERSITY_THRESHOLD) {
-                    convergence_counter++; // Acumula consistência
-                    
-                    if (convergence_counter >= CONVERGENCE_BUFFER) {
-                        mutation_prob /= 1.5; // Redução suave 
-                        convergence_counter = 0; // Reseta buffer
-                    }
-                } else {
-                    mutation_prob = baseline_mutation; // Mantém ritmo normal
-                    convergence_counter = 0;
-                }
+            // FRACASSO: Algoritmo travou
+            st->convergence_counter = 0; // Perdeu a consistência da convergência
+            st->stagnation_counter++;
 
-            } else {
-                // FRACASSO: Algoritmo travou
-                convergence_counter = 0; // Perdeu a consistência da convergência
-                stagnation_counter++;
-                
-                if (stagnation_counter >= STAGNATION_LIMIT) {
-                    // Começa a aumentar a chance de mutação
-                    mutation_prob *= 1.5; 
-                    
-                    // Se a chance de mutação bateu no teto (25%) -> Ativa REPULSÃO
-                    if (mutation_prob >= MUTATION_PROB_MAX) {
-                        mutation_prob = MUTATION_PROB_MAX; // Trava em 25%
-                        crossover_mode = MODE_REPULSION;
-                        repulsion_mode_counter++;
-                        strcpy(event_str, "REPULSAO");
-
-                        // Se Repulsão falhou por muito tempo -> RESET (PREDAÇÃO)
-                        if (repulsion_mode_counter >= RESET_AFTER_REPULSION_GENS) {
-                            strcpy(event_str, "RESET-HIBRIDO");
-                            
-                            int reset_cnt = (int)(POPULATION_SIZE * RESET_PERCENTAGE); // 50%
-                            int survivor_count = POPULATION_SIZE - reset_cnt; 
-                            int current_fill_idx = survivor_count; 
-
-                            // --- 1. O FRANKENSTEIN ---
-                            if (current_fill_idx < POPULATION_SIZE) {
-                                for (int d = 0; d < NUM_DIMENSIONS; d++) {
-                                    int random_parent = rand() % survivor_count; 
-                                    population[current_fill_idx].genes[d] = population[random_parent].genes[d];
-                                }
-                                fitness[current_fill_idx] = -1e300; 
-                                current_fill_idx++; 
-                            }
-                            
-                            // --- 2. O EDA (Estimation of Distribution) ---
-                            if (current_fill_idx < POPULATION_SIZE) {
-                                for (int d = 0; d < NUM_DIMENSIONS; d++) {
-                                    // Estatísticas da Elite
-                                    double sum = 0.0, sum_sq = 0.0;
-                                    for(int k = 0; k < survivor_count; k++) {
-                                        double val = population[k].genes[d];
-                                        sum += val; sum_sq += val * val;
-                                    }
-                                    double mean = sum / survivor_count;
-                                    double variance = (sum_sq / survivor_count) - (mean * mean);
-                                    double std_dev = (variance > 0) ? sqrt(variance) : 0.0;
-                                    
-                                    // Box-Muller (Gaussiana)
-                                    double u1 = ((double)rand() / RAND_MAX);
-                                    double u2 = ((double)rand() / RAND_MAX);
-                                    if(u1 < 1e-9) u1 = 1e-9;
-                                    double z0 = sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
-                                    double new_gene = mean + z0 * std_dev;
-                                    
-                                    // Clamps
-                                    if(new_gene > GENE_MAX_VALUE[d]) new_gene = GENE_MAX_VALUE[d];
-                                    if(new_gene < GENE_MIN_VALUE[d]) new_gene = GENE_MIN_VALUE[d];
-                                    
-                                    population[current_fill_idx].genes[d] = new_gene;
-                                }
-                                fitness[current_fill_idx] = -1e300; 
-                                current_fill_idx++;
-                            }
-
-                            // --- 3. ALEATÓRIOS PUROS ---
-                            for(int k = current_fill_idx; k < POPULATION_SIZE; k++) {
-                                for(int d = 0; d < NUM_DIMENSIONS; d++) 
-                                    population[k].genes[d] = GENE_MIN_VALUE[d] + ((double)rand()/RAND_MAX)*(GENE_MAX_VALUE[d]-GENE_MIN_VALUE[d]);
-                                fitness[k] = -1e300;
-                            }
-                            
-                            // Reseta contadores
-                            post_reset_cnt = 30; 
-                            repulsion_mode_counter = 0; 
-                            stagnation_counter = 0;
-                            mutation_prob = baseline_mutation; // Volta a chance normal
-                        }
+            if (st->stagnation_counter >= STAGNATION_LIMIT) {
+                // Começa a aumentar a chance de mutação
+                st->mutation_prob *= 1.5;
+
+                // Se a chance de mutação bateu no teto (25%) -> Ativa REPULSÃO
+                if (st->mutation_prob >= MUTATION_PROB_MAX) {
+                    st->mutation_prob = MUTATION_PROB_MAX; // Trava em 25%
+                    st->crossover_mode = MODE_REPULSION;
+                    st->repulsion_mode_counter++;
+                    st->evento = GA_EVT_REPULSAO;
+
+                    // Se Repulsão falhou por muito tempo -> RESET (PREDAÇÃO)
+                    if (st->repulsion_mode_counter >= RESET_AFTER_REPULSION_GENS) {
+                        st->evento = GA_EVT_RESET_HIBRIDO;
+                        GA_PROF_START(t_reset);
+                        hybrid_reset(st);
+                        GA_PROF_STOP(&st->prof, GA_PROF_RESET, t_reset);
+
+                        // Reseta contadores
+                        st->post_reset_cnt = 30;
+                        st->repulsion_mode_counter = 0;
+                        st->stagnation_counter = 0;
+                        st->mutation_prob = st->baseline_mutation; // Volta a chance normal
                     }
                 }
             }
         }
-        
-        // Travas de segurança da probabilidade
-        if(mutation_prob < MUTATION_PROB_MIN) mutation_prob = MUTATION_PROB_MIN;
-        if(mutation_prob > MUTATION_PROB_MAX) mutation_prob = MUTATION_PROB_MAX;
-
-        // Atualiza o melhor global
-        if (max_fit > -1e200) {
-            if (prev_best.genes) free(prev_best.genes);
-            prev_best = clone_individual(&curr_best);
-        }
-        free(curr_best.genes);
-
-        // CSV Log
-        double rep_fact = (crossover_mode == MODE_REPULSION) ? REPULSION_BASE_FACTOR * (1 + repulsion_mode_counter/(double)STAGNATION_LIMIT) : 0;
-        double current_div = calculate_genetic_diversity();
-        if (ga_csv_file != NULL) {
-            fprintf(ga_csv_file, "%d,%.5f,%.5f,%.5f,%.5f,%.2f,%.2f,%s\n", 
-                gen+1, max_fit > -1e200 ? max_fit : 0, avg_fit, std_dev_fit, current_div, mutation_prob, rep_fact, event_str);
-        }
-
-        // Progresso no Terminal
-        if (gen % (MAX_GENERATIONS/20) == 0) {
-            printf(" [GA] Progresso: %3d%% (Melhor Fit: %.2f) | Mut(Chance): %.1f%%\r", (gen*100)/MAX_GENERATIONS, max_fit, mutation_prob);
-            fflush(stdout);
-        }
-
-        // ---------------------------------------------------------
-        // 3. EVOLUÇÃO (CROSSOVER + MUTAÇÃO BIOLÓGICA)
-        // ---------------------------------------------------------
-        Individual* new_pop = (Individual*)malloc(sizeof(Individual)*POPULATION_SIZE);
-        Individual elite = clone_individual(&population[best_idx]);
-        if(max_fit < -1e200) { for(int d=0; d<NUM_DIMENSIONS; d++) elite.genes[d] = GENE_MIN_VALUE[d]; }
-        new_pop[0] = elite; // Elitismo
-        
-        for(int i=1; i<POPULATION_SIZE; i++) {
-            new_pop[i].genes = (double*)malloc(sizeof(double)*NUM_DIMENSIONS);
-            for(int j=0; j<NUM_DIMENSIONS; j++) {
-                
-                // A. CROSSOVER (Atração ou Repulsão)
-                double base_gene;
-                if(crossover_mode == MODE_ATTRACTION)
-                    base_gene = (elite.genes[j] + population[i].genes[j]) / 2.0;
-                else
-                    base_gene = population[i].genes[j] + rep_fact * (population[i].genes[j] - elite.genes[j]);
-                
-                new_pop[i].genes[j] = base_gene;
+    }
+
+    // Travas de segurança da probabilidade
+    if(st->mutation_prob < MUTATION_PROB_MIN) st->mutation_prob = MUTATION_PROB_MIN;
+    if(st->mutation_prob > MUTATION_PROB_MAX) st->mutation_prob = MUTATION_PROB_MAX;
+
+    st->rep_fact = (st->crossover_mode == MODE_REPULSION)
+                 ? REPULSION_BASE_FACTOR * (1 + st->repulsion_mode_counter/(double)STAGNATION_LIMIT) : 0;
+}
+
+/**
+ * Estratégia fisher: a chance de mutar é fixa e o que se adapta é o tamanho do
+ * passo (severidade). Cada melhora encolhe o passo (refinamento); a estagnação
+ * o amplia, e FISHER_CATASTROPHE_LIMIT ampliações sem melhora sorteiam toda a
+ * população de novo na próxima reprodução (só a elite fica).
+ */
+static void adapt_fisher(GAState* st, int improved) {
+    if (improved) {
+        st->stagnation_counter = 0;
+        st->expansion_events = 0;
+        st->severity *= FISHER_SEVERITY_DECAY;
+        if (st->severity < FISHER_SEVERITY_MIN) st->severity = FISHER_SEVERITY_MIN;
+    } else if (++st->stagnation_counter >= FISHER_STAGNATION_LIMIT) {
+        st->severity *= FISHER_SEVERITY_EXPAND;
+        if (st->severity > FISHER_SEVERITY_MAX) st->severity = FISHER_SEVERITY_MAX;
+        st->stagnation_counter = 0; // Tempo para a expansão funcionar
+        st->expansion_events++;
+        st->evento = GA_EVT_EXPANSAO;
 
+        if (st->expansion_events >= FISHER_CATASTROPHE_LIMIT) {
+            // Ótimo local profundo: a reprodução sorteia tudo de novo (mantendo a elite)
+            st->evento = GA_EVT_RESET_TOTAL;
+            st->severity = FISHER_SEVERITY_INITIAL;
+            st->expansion_events = 0;
+            st->reset_pendente = 1;
+            st->resets_feitos++;
+        }
+    }
+    st->mutation_prob = FISHER_MUTATION_RATE;
+    st->crossover_mode = MODE_ATTRACTION;
+    st->rep_fact = 0;
+}
+
+/**
+ * Estratégia por gene: todo gene muta, com passo de mutation_prob % do range.
+ * A taxa sobe x1.2 a cada POR_GENE_STAGNATION_LIMIT gerações paradas até o
+ * teto, depois vem a repulsão e o reset híbrido, com POR_GENE_POST_RESET_GENS
+ * gerações de taxa tripla; com a população convergida, a melhora reduz a taxa.
+ */
+static void adapt_por_gene(GAState* st, int improved) {
+    if (st->post_reset_cnt > 0) {
+        st->post_reset_cnt--;
+        st->mutation_prob = st->baseline_mutation * 3.0;
+        st->crossover_mode = MODE_ATTRACTION;
+        st->evento = GA_EVT_POS_RESET;
+    } else if (improved) {
+        st->stagnation_counter = 0;
+        st->repulsion_mode_counter = 0;
+        st->crossover_mode = MODE_ATTRACTION;
+        if (current_diversity(st) < GENETIC_DIVERSITY_THRESHOLD) st->mutation_prob /= POR_GENE_RATE_DOWN;
+        else st->mutation_prob = st->baseline_mutation;
+    } else if (++st->stagnation_counter >= POR_GENE_STAGNATION_LIMIT) {
+        if (st->mutation_prob < MUTATION_PROB_MAX) {
+            st->mutation_prob *= POR_GENE_RATE_UP;
+        } else {
+            st->crossover_mode = MODE_REPULSION;
+            st->repulsion_mode_counter++;
+            st->evento = GA_EVT_REPULSAO;
+            if (st->repulsion_mode_counter >= RESET_AFTER_REPULSION_GENS) {
+                st->evento = GA_EVT_RESET_HIBRIDO;
+                GA_PROF_START(t_reset);
+                hybrid_reset(st);
+                GA_PROF_STOP(&st->prof, GA_PROF_RESET, t_reset);
+                st->post_reset_cnt = POR_GENE_POST_RESET_GENS;
+                st->repulsion_mode_counter = 0;
+                st->stagnation_counter = 0;
+            }
+        }
+    }
+    if (st->mutation_prob < MUTATION_PROB_MIN) st->mutation_prob = MUTATION_PROB_MIN;
+    if (st->mutation_prob > MUTATION_PROB_MAX) st->mutation_prob = MUTATION_PROB_MAX;
+    st->rep_fact = (st->crossover_mode == MODE_REPULSION)
+                 ? REPULSION_BASE_FACTOR * (1 + st->repulsion_mode_counter / (double)POR_GENE_STAGNATION_LIMIT) : 0;
+}
+
+/** Detecta melhora, guarda o melhor e passa a vez ao controle da estratégia (que pode resetar). */
+static void ga_adapt(GAState* st) {
+    int dims = st->cfg.num_dimensions;
+    GA_PROF_START(t_adapt);
+#ifdef GA_PROFILE
+    double reset_antes = st->prof.seconds[GA_PROF_RESET];
+#endif
+
+    // Verifica Melhora (Elitismo Global)
+    int improved = 0;
+    if (st->has_prev_best && st->max_fit > -1e200) {
+         // Considera melhora se fitness aumentou E genes mudaram significativamente
+         if (st->max_fit > st->prev_best_fit + 1e-9 &&
+             !are_individuals_equal(st->population[st->best_idx], st->prev_best, dims)) improved = 1;
+    } else if (st->max_fit > -1e200) improved = 1;
+    st->gens_sem_melhora = improved ? 0 : st->gens_sem_melhora + 1;
+
+    // Atualiza o melhor global (cópia no buffer fixo, com o fitness junto).
+    // Feito antes do reset, que pode sobrescrever o slot best_idx.
+    if (st->max_fit > -1e200) {
+        for (int d = 0; d < dims; d++) st->prev_best.genes[d] = IND_GENE(st->population[st->best_idx], d);
+        st->prev_best_fit = st->max_fit;
+        st->has_prev_best = 1;
+    }
+
+    st->ops->adapt(st, improved);
+
+#ifdef GA_PROFILE
+    // O reset tem o seu próprio trecho
+    st->prof.seconds[GA_PROF_ADAPTATIVO] += (wall_seconds() - t_adapt) - (st->prof.seconds[GA_PROF_RESET] - reset_antes);
+#endif
+}
+
+/**
+ * Log (Dashboard), telemetria e progresso no terminal da geração 'gen'.
+ * 'ultima' = a execução para nesta geração: ela sempre entra no log, mesmo com
+ * --log-every, para o log terminar no estado final.
+ */
+static void ga_report(GAState* st, int gen, int ultima) {
+    // Duração do ciclo desde o relatório anterior (reprodução + avaliação + adaptação)
+    double tempo_us = 0.0;
+#ifdef GA_PROFILE
+    double t_log = wall_seconds();
+    tempo_us = (t_log - st->t_ultimo_relatorio) * 1e6;
+    st->t_ultimo_relatorio = t_log;
+#endif
+
+    // Log: só copia os números para o bloco em memória do ga_log
+    GaLog* log = st->cfg.log;
+    int log_this_gen = (st->evento != st->prev_evento) || gen == 0 || ultima ||
+                       (st->cfg.log_every > 0 && (gen + 1) % st->cfg.log_every == 0);
+    st->prev_evento = st->evento;
+    // Chance e passo da mutação em colunas separadas (unidades em ga_log.h)
+    double chance = st->mutation_prob, passo = MUTATION_SEVERITY;
+    if (st->cfg.strategy == GA_STRATEGY_FISHER) passo = st->severity * 100.0;
+    else if (st->cfg.strategy == GA_STRATEGY_POR_GENE) { chance = 100.0; passo = st->mutation_prob; }
+    int publish_this_gen = st->report && st->cfg.telemetry_phase > 0 && telemetry_enabled(); // Ao vivo: toda geração
+    if ((log != NULL && log_this_gen) || publish_this_gen) {
+        GaLogRow row = {gen + 1, st->max_fit > -1e200 ? st->max_fit : 0, st->avg_fit, st->std_dev_fit,
+                        current_diversity(st), chance, st->rep_fact, st->evento, tempo_us,
+                        st->cache_acertos, st->cache_falhas, passo};
+        if (log != NULL && log_this_gen) ga_log_append(log, &row);
+        if (publish_this_gen) telemetry_publish(st->cfg.telemetry_phase, &row);
+    }
+    if (st->report && st->cfg.on_generation && st->max_fit > -1e200)
+        st->cfg.on_generation(gen, st->population[st->best_idx], st->max_fit, st->cfg.hook_param);
+
+    // Progresso no Terminal
+    int max_gen = st->cfg.max_generations;
+    int passo_progresso = (max_gen >= 20) ? max_gen / 20 : 1;
+    if (st->report && st->cfg.verbose && gen % passo_progresso == 0) {
+        printf(" [GA] Progresso: %3d%% (Melhor Fit: %.2f) | Mut(Chance): %.1f%%\r", (gen*100)/max_gen, st->max_fit, chance);
+        fflush(stdout);
+    }
+    GA_PROF_STOP(&st->prof, GA_PROF_LOG, t_log);
+}
+
+// =============================================================================
+// CRITÉRIOS DE PARADA
+// =============================================================================
+
+const char* ga_stop_reason_name(GaStopReason reason) {
+    switch (reason) {
+        case GA_STOP_MAX_GENERATIONS: return "limite de geracoes";
+        case GA_STOP_STAGNATION:      return "estagnacao apos resets";
+        case GA_STOP_DIVERSITY:       return "diversidade abaixo do piso";
+        case GA_STOP_TIME:            return "orcamento de tempo";
+        case GA_STOP_EVALUATIONS:     return "orcamento de avaliacoes";
+        case GA_STOP_TARGET:          return "alvo de fitness atingido";
+    }
+    return "?";
+}
+
+/** Critérios que dependem só desta população: estagnação e piso de diversidade. */
+static int ga_local_stop(GAState* st, GaStopReason* reason) {
+    const GaStopCriteria* s = &st->cfg.stop;
+    if (s->stagnation_gens > 0 && st->resets_feitos >= s->min_resets &&
+        st->gens_sem_melhora >= s->stagnation_gens) { *reason = GA_STOP_STAGNATION; return 1; }
+    if (s->diversity_floor > 0 && current_diversity(st) < s->diversity_floor) { *reason = GA_STOP_DIVERSITY; return 1; }
+    return 0;
+}
+
+/** Alvo de fitness: o melhor desta geração já chegou lá (vale antes de qualquer outro critério). */
+static int ga_target_stop(const GAState* st, GaStopReason* reason) {
+    const GaStopCriteria* s = &st->cfg.stop;
+    if (s->target_enabled && st->max_fit > -1e200 && st->max_fit >= s->target_fitness) { *reason = GA_STOP_TARGET; return 1; }
+    return 0;
+}
+
+/** Orçamentos da execução inteira: avaliações feitas e tempo de relógio. */
+static int ga_budget_stop(const GaStopCriteria* s, long long evals, double t_inicio, GaStopReason* reason) {
+    if (s->max_evaluations > 0 && evals >= s->max_evaluations) { *reason = GA_STOP_EVALUATIONS; return 1; }
+    if (s->max_seconds > 0 && wall_seconds() - t_inicio >= s->max_seconds) { *reason = GA_STOP_TIME; return 1; }
+    return 0;
+}
+
+// =============================================================================
+// EVOLUÇÃO (CROSSOVER + MUTAÇÃO BIOLÓGICA)
+// =============================================================================
+
+/**
+ * Corpo da reprodução (ping-pong, sem alocações). Sempre expandido em linha:
+ * chamado com 'dims' constante, o compilador gera uma versão com os laços de
+ * genes desenrolados e elite/limites em registradores (ver ga_breed).
+ */
+static inline __attribute__((always_inline)) void breed_generation(GAState* st, const int dims, const int por_gene) {
+    int n = st->cfg.population_size;
+    Individual* population = st->population;
+    double* elite = st->elite.genes;
+    double mutation_prob = st->mutation_prob;
+    double rep_fact = st->rep_fact;
+    int crossover_mode = st->crossover_mode;
+    int best_idx = st->best_idx;
+
+    // Cópias locais de tamanho fixo (quando dims é constante)
+    double gmin[dims], gmax[dims], elite_l[dims];
+    for(int d=0; d<dims; d++) { gmin[d] = st->cfg.gene_min[d]; gmax[d] = st->cfg.gene_max[d]; }
+
+    Individual* new_pop = st->pop_views[st->cur_buffer ^ 1];
+    double* new_fitness = st->fitness_buffers[st->cur_buffer ^ 1];
+    unsigned char* new_known = st->known_buffers[st->cur_buffer ^ 1];
+    double* new_sums = st->sum_buffers[st->cur_buffer ^ 1];
+    for(int d=0; d<dims; d++)
+        elite_l[d] = (st->max_fit < -1e200) ? gmin[d] : IND_GENE(population[best_idx], d);
+    for(int d=0; d<dims; d++) elite[d] = elite_l[d];
+    for(int d=0; d<dims; d++) IND_GENE(new_pop[0], d) = elite_l[d]; // Elitismo
+    for(int d=0; d<dims; d++) new_sums[d] = elite_l[d];
+
+    // O fitness da elite já é conhecido (a menos que o reset tenha trocado o slot)
+    int elite_known = (st->max_fit > -1e200) && st->fitness_known[best_idx];
+    double elite_fit = st->fitness[best_idx];
+    new_known[0] = (unsigned char)elite_known;
+    new_fitness[0] = elite_fit;
+
+    for(int i=1; i<n; i++) {
+        int same_as_elite = elite_known;
+        for(int j=0; j<dims; j++) {
+
+            // A. CROSSOVER (Atração ou Repulsão)
+            double base_gene;
+            if(crossover_mode == MODE_ATTRACTION)
+                base_gene = (elite_l[j] + IND_GENE(population[i], j)) / 2.0;
+            else
+                base_gene = IND_GENE(population[i], j) + rep_fact * (IND_GENE(population[i], j) - elite_l[j]);
+
+            double gene = base_gene;
+
+            if (por_gene) {
+                // B'. MUTAÇÃO EM TODO GENE (estratégia por gene): passo de mutation_prob % do range
+                double range = gmax[j] - gmin[j];
+                gene += (rng_uniform(&st->rng) - 0.5) * (range * mutation_prob / 100.0);
+            } else {
                 // B. MUTAÇÃO BIOLÓGICA (Probabilística)
-                double chance_roll = (double)rand() / RAND_MAX * 100.0;
-                
+                double chance_roll = rng_uniform(&st->rng) * 100.0;
+
                 if (chance_roll < mutation_prob) {
                     // A MUTAÇÃO OCORRE
-                    double range = GENE_MAX_VALUE[j] - GENE_MIN_VALUE[j];
-                    double change = ((double)rand()/RAND_MAX - 0.5) * (range * MUTATION_SEVERITY / 100.0);
-                    new_pop[i].genes[j] += change;
+                    double range = gmax[j] - gmin[j];
+                    double change = (rng_uniform(&st->rng) - 0.5) * (range * MUTATION_SEVERITY / 100.0);
+                    gene += change;
                 }
-                
-                // C. CLAMPS (Travas de Segurança Físicas)
-                if(new_pop[i].genes[j] > GENE_MAX_VALUE[j]) new_pop[i].genes[j] = GENE_MAX_VALUE[j];
-                if(new_pop[i].genes[j] < GENE_MIN_VALUE[j]) new_pop[i].genes[j] = GENE_MIN_VALUE[j];
             }
+
+            // C. CLAMPS (Travas de Segurança Físicas)
+            if(gene > gmax[j]) gene = gmax[j];
+            if(gene < gmin[j]) gene = gmin[j];
+            if(gene != elite_l[j]) same_as_elite = 0;
+            IND_GENE(new_pop[i], j) = gene;
+            new_sums[j] += gene; // Centróide da próxima geração, na mesma passada
         }
-        free_population();
-        population = new_pop;
-        fitness = (double*)malloc(sizeof(double)*POPULATION_SIZE);
+        // Filho idêntico à elite: herda o fitness dela em vez de ser reavaliado
+        new_known[i] = (unsigned char)same_as_elite;
+        if (same_as_elite) new_fitness[i] = elite_fit;
     }
-    printf("\n"); 
+    swap_gene_buffers(st);
+}
 
-    int best = 0;
-    for(int i=1; i<POPULATION_SIZE; i++) 
-        if(fitness[i] > fitness[best]) best = i;
-    
-    Individual final_res = clone_individual(&population[best]);
-    if(prev_best.genes) free(prev_best.genes);
-    free_population();
+/** Chave dos sorteios sem estado da reprodução da geração 'gen' (um fluxo por ilha). */
+static uint64_t breed_key(const GAState* st, long long gen) {
+    return rng_counter_key(rng_counter_key(st->cfg.seed, st->rng_stream), (uint64_t)gen);
+}
+
+/**
+ * Reprodução em blocos (cfg.parallel_breeding): as mesmas fórmulas de
+ * breed_generation, com o sorteio do gene j do indivíduo i na posição
+ * k = i * dims + j do gerador sem estado da geração (32 bits para a chance
+ * de mutação e 32 para o delta). Cada
+ * linha sorteia as suas máscaras e deltas de uma vez e aplica cruzamento,
+ * mutação e clamps (min/max) em laços SIMD sobre os genes. Os blocos de
+ * GA_BREED_CHUNK indivíduos se dividem entre as threads e as somas parciais
+ * do centróide são juntadas na ordem dos blocos (mesmos bits com qualquer
+ * número de threads).
+ */
+static inline __attribute__((always_inline)) void breed_generation_parallel(GAState* st, const int dims, long long gen,
+                                                                           const int por_gene) {
+    int n = st->cfg.population_size;
+    Individual* population = st->population;
+    double* elite = st->elite.genes;
+    double mutation_prob = st->mutation_prob;
+    double rep_fact = st->rep_fact;
+    int atracao = (st->crossover_mode == MODE_ATTRACTION);
+    int best_idx = st->best_idx;
+    uint64_t chave = breed_key(st, gen);
+
+    double gmin[dims], gmax[dims], escala[dims];
+    for (int d = 0; d < dims; d++) {
+        gmin[d] = st->cfg.gene_min[d];
+        gmax[d] = st->cfg.gene_max[d];
+        escala[d] = (gmax[d] - gmin[d]) * (por_gene ? mutation_prob : MUTATION_SEVERITY) / 100.0;
+    }
+
+    Individual* new_pop = st->pop_views[st->cur_buffer ^ 1];
+    double* new_fitness = st->fitness_buffers[st->cur_buffer ^ 1];
+    unsigned char* new_known = st->known_buffers[st->cur_buffer ^ 1];
+    double* new_sums = st->sum_buffers[st->cur_buffer ^ 1];
+    for (int d = 0; d < dims; d++)
+        elite[d] = (st->max_fit < -1e200) ? gmin[d] : IND_GENE(population[best_idx], d);
+    for (int d = 0; d < dims; d++) IND_GENE(new_pop[0], d) = elite[d]; // Elitismo
+
+    int elite_known = (st->max_fit > -1e200) && st->fitness_known[best_idx];
+    double elite_fit = st->fitness[best_idx];
+    new_known[0] = (unsigned char)elite_known;
+    new_fitness[0] = elite_fit;
+
+    int n_chunks = (n - 1 + GA_BREED_CHUNK - 1) / GA_BREED_CHUNK;
+    double* partial = st->breed_sums;
+#ifdef _OPENMP
+    int n_threads = resolve_thread_count(st->cfg.num_threads, n_chunks);
+    #pragma omp parallel for schedule(static) num_threads(n_threads) if(n_threads > 1)
+#endif
+    for (int c = 0; c < n_chunks; c++) {
+        int i0 = 1 + c * GA_BREED_CHUNK;
+        int i1 = (i0 + GA_BREED_CHUNK < n) ? i0 + GA_BREED_CHUNK : n;
+        double soma[dims], pai[dims], filho[dims], u_chance[dims], u_delta[dims];
+        for (int d = 0; d < dims; d++) soma[d] = 0.0;
+        for (int i = i0; i < i1; i++) {
+            // Um sorteio de 64 bits por gene: metade alta decide a mutação, a baixa dá o delta
+            uint64_t k0 = (uint64_t)i * dims;
+#ifdef _OPENMP
+            #pragma omp simd
+#endif
+            for (int j = 0; j < dims; j++) {
+                uint64_t z = rng_counter_next(chave, k0 + j);
+                u_chance[j] = (double)(z >> 32) * 0x1.0p-32;
+                u_delta[j] = (double)(uint32_t)z * 0x1.0p-32;
+            }
+            for (int j = 0; j < dims; j++) pai[j] = IND_GENE(population[i], j);
+            int diferentes = 0;
+#ifdef _OPENMP
+            #pragma omp simd reduction(+: diferentes)
+#endif
+            for (int j = 0; j < dims; j++) {
+                // Atração: (elite + pai) / 2 | Repulsão: pai + rep_fact * (pai - elite)
+                double base_gene = atracao ? (elite[j] + pai[j]) / 2.0 : pai[j] + rep_fact * (pai[j] - elite[j]);
+                double gene = base_gene + ((por_gene || u_chance[j] * 100.0 < mutation_prob) ? (u_delta[j] - 0.5) * escala[j] : 0.0);
+                gene = (gene > gmax[j]) ? gmax[j] : gene; // Clamps como min/max (sem chamada à libm)
+                gene = (gene < gmin[j]) ? gmin[j] : gene;
+                filho[j] = gene;
+                soma[j] += gene;
+                diferentes += (gene != elite[j]);
+            }
+            for (int j = 0; j < dims; j++) IND_GENE(new_pop[i], j) = filho[j];
+            // Filho idêntico à elite: herda o fitness dela em vez de ser reavaliado
+            int same_as_elite = elite_known && diferentes == 0;
+            new_known[i] = (unsigned char)same_as_elite;
+            if (same_as_elite) new_fitness[i] = elite_fit;
+        }
+        for (int d = 0; d < dims; d++) partial[(size_t)c * dims + d] = soma[d];
+    }
+    for (int d = 0; d < dims; d++) {
+        double sum = elite[d];
+        for (int c = 0; c < n_chunks; c++) sum += partial[(size_t)c * dims + d];
+        new_sums[d] = sum;
+    }
+    swap_gene_buffers(st);
+}
+
+/**
+ * Reprodução da estratégia fisher: cada filho cruza, gene a gene (moeda), um
+ * pai vindo de um torneio de dois com a elite, e cada gene muta com chance
+ * FISHER_MUTATION_RATE por um passo gaussiano de desvio severity x range. Com
+ * reset_pendente, todos menos a elite são sorteados de novo nos limites.
+ */
+static inline __attribute__((always_inline)) void breed_generation_fisher(GAState* st, const int dims) {
+    int n = st->cfg.population_size;
+    Individual* population = st->population;
+    const double* fit = st->fitness;
+    double* elite = st->elite.genes;
+    double severity = st->severity;
+    int reset = st->reset_pendente;
+    int best_idx = st->best_idx;
+
+    double gmin[dims], gmax[dims], elite_l[dims];
+    for(int d=0; d<dims; d++) { gmin[d] = st->cfg.gene_min[d]; gmax[d] = st->cfg.gene_max[d]; }
+
+    Individual* new_pop = st->pop_views[st->cur_buffer ^ 1];
+    double* new_fitness = st->fitness_buffers[st->cur_buffer ^ 1];
+    unsigned char* new_known = st->known_buffers[st->cur_buffer ^ 1];
+    double* new_sums = st->sum_buffers[st->cur_buffer ^ 1];
+    for(int d=0; d<dims; d++)
+        elite_l[d] = (st->max_fit < -1e200) ? gmin[d] : IND_GENE(population[best_idx], d);
+    for(int d=0; d<dims; d++) elite[d] = elite_l[d];
+    for(int d=0; d<dims; d++) IND_GENE(new_pop[0], d) = elite_l[d]; // Elitismo
+    for(int d=0; d<dims; d++) new_sums[d] = elite_l[d];
+
+    int elite_known = (st->max_fit > -1e200) && st->fitness_known[best_idx];
+    double elite_fit = st->fitness[best_idx];
+    new_known[0] = (unsigned char)elite_known;
+    new_fitness[0] = elite_fit;
+
+    for(int i=1; i<n; i++) {
+        int same_as_elite = elite_known && !reset;
+        if (reset) {
+            // Reset total: sangue novo em toda a população
+            for(int j=0; j<dims; j++) {
+                double gene = gmin[j] + rng_uniform(&st->rng) * (gmax[j] - gmin[j]);
+                IND_GENE(new_pop[i], j) = gene;
+                new_sums[j] += gene;
+            }
+        } else {
+            // Torneio de dois (se os dois são inválidos, fica o primeiro)
+            int r1 = rng_below(&st->rng, n);
+            int r2 = rng_below(&st->rng, n);
+            int pai = (fit[r1] > fit[r2]) ? r1 : r2;
+            if (fit[r1] < -1e200 && fit[r2] < -1e200) pai = r1;
+
+            for(int j=0; j<dims; j++) {
+                // Cruzamento uniforme com a elite
+                double gene = (rng_next(&st->rng) >> 63) ? elite_l[j] : IND_GENE(population[pai], j);
+
+                // Mutação de Fisher: chance fixa, passo gaussiano (Box-Muller)
+                if (rng_uniform(&st->rng) * 100.0 < FISHER_MUTATION_RATE) {
+                    double u1 = rng_uniform(&st->rng);
+                    double u2 = rng_uniform(&st->rng);
+                    if(u1 < 1e-300) u1 = 1e-300;
+                    double z0 = sqrt(-2.0 * log(u1)) * cos(2.0 * PI * u2);
+                    gene += z0 * ((gmax[j] - gmin[j]) * severity);
+                }
+
+                if(gene > gmax[j]) gene = gmax[j];
+                if(gene < gmin[j]) gene = gmin[j];
+                if(gene != elite_l[j]) same_as_elite = 0;
+                IND_GENE(new_pop[i], j) = gene;
+                new_sums[j] += gene;
+            }
+        }
+        new_known[i] = (unsigned char)same_as_elite;
+        if (same_as_elite) new_fitness[i] = elite_fit;
+    }
+    if (reset) {
+        st->reset_pendente = 0;
+        st->diversity = -1.0;
+    }
+    swap_gene_buffers(st);
+}
+
+/**
+ * Geram a próxima população a partir da atual. Os números de genes do projeto
+ * (7 na Fase 1, 9 nas estratégias) têm versões especializadas em tempo de
+ * compilação; qualquer outro valor usa o caminho genérico. Todas fazem as
+ * mesmas operações na mesma ordem (mesmos bits, mesma sequência do gerador).
+ */
+static void breed_hibrida(GAState* st, int gen) {
+    if (st->cfg.parallel_breeding) {
+        switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+            case 7:  breed_generation_parallel(st, 7, gen, 0); break;
+            case 9:  breed_generation_parallel(st, 9, gen, 0); break;
+            default: breed_generation_parallel(st, st->cfg.num_dimensions, gen, 0); break;
+        }
+        return;
+    }
+    switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+        case 7:  breed_generation(st, 7, 0); break;
+        case 9:  breed_generation(st, 9, 0); break;
+        default: breed_generation(st, st->cfg.num_dimensions, 0); break;
+    }
+}
+
+static void breed_por_gene(GAState* st, int gen) {
+    if (st->cfg.parallel_breeding) {
+        switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+            case 7:  breed_generation_parallel(st, 7, gen, 1); break;
+            case 9:  breed_generation_parallel(st, 9, gen, 1); break;
+            default: breed_generation_parallel(st, st->cfg.num_dimensions, gen, 1); break;
+        }
+        return;
+    }
+    switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+        case 7:  breed_generation(st, 7, 1); break;
+        case 9:  breed_generation(st, 9, 1); break;
+        default: breed_generation(st, st->cfg.num_dimensions, 1); break;
+    }
+}
+
+static void breed_fisher(GAState* st, int gen) {
+    (void)gen; // Torneio sequencial: sempre em série
+    switch (GA_FIXED_DIMS(st->cfg.num_dimensions)) {
+        case 7:  breed_generation_fisher(st, 7); break;
+        case 9:  breed_generation_fisher(st, 9); break;
+        default: breed_generation_fisher(st, st->cfg.num_dimensions); break;
+    }
+}
+
+// =============================================================================
+// ESTRATÉGIAS (controle adaptativo + reprodução)
+// =============================================================================
+
+static const GaStrategyOps GA_STRATEGIES[GA_STRATEGY_COUNT] = {
+    {"hibrida",  adapt_hibrida,  breed_hibrida},
+    {"fisher",   adapt_fisher,   breed_fisher},
+    {"por-gene", adapt_por_gene, breed_por_gene},
+};
+
+static const GaStrategyOps* strategy_ops(GaStrategy s) {
+    return &GA_STRATEGIES[(s >= 0 && s < GA_STRATEGY_COUNT) ? s : GA_STRATEGY_HIBRIDA];
+}
+
+const char* ga_strategy_name(GaStrategy strategy) {
+    return strategy_ops(strategy)->nome;
+}
+
+int ga_strategy_from_name(const char* nome, GaStrategy* out) {
+    for (int s = 0; s < GA_STRATEGY_COUNT; s++) {
+        if (strcmp(nome, GA_STRATEGIES[s].nome) == 0) { *out = (GaStrategy)s; return 0; }
+    }
+    return -1;
+}
+
+/** Reprodução da estratégia da população (cronometrada como um trecho só). */
+static void ga_breed(GAState* st, int gen) {
+    GA_PROF_START(t_reproducao);
+    st->ops->breed(st, gen);
+    GA_PROF_STOP(&st->prof, GA_PROF_REPRODUCAO, t_reproducao);
+}
+
+// =============================================================================
+// CONTEXTO DE EXECUÇÃO
+// =============================================================================
+
+/**
+ * Uma ou mais populações (ilhas) com a sua configuração, buffers de migração
+ * e estatísticas. Com ilhas desligadas e um só processo, é o AG clássico.
+ */
+struct GAContext {
+    GAConfig cfg;
+    GaIslandConfig islands;
+    int modo_ilhas;          // 0 = uma população, sem migração
+    int rank, n_ranks;       // Posição no MPI_COMM_WORLD (0 e 1 sem MPI)
+    int n_local, n_total;    // Ilhas neste processo e em todos
+    int k_migrantes;         // Elites enviadas por ilha (já limitado ao tamanho da ilha)
+    GAState* pops;           // n_local populações
+
+    // Migração: linhas (genes + fitness) enviadas por este processo e tabela global
+    double* enviados;
+    double* tabela;
+    GaStopReason* motivos;
+    int* parou;
+
+    GaRunStats stats;
+    GaProfile profile;       // Soma dos perfis das ilhas (+ migração) da última execução
+    void* retomada;          // Checkpoint validado por ga_context_resume (consumido pela próxima execução)
+    size_t retomada_len;
+};
+
+int ga_mpi_rank() {
+#ifdef GA_USE_MPI
+    int iniciado = 0, rank = 0;
+    MPI_Initialized(&iniciado);
+    if (iniciado) MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+#else
+    return 0;
+#endif
+}
+
+int ga_mpi_size() {
+#ifdef GA_USE_MPI
+    int iniciado = 0, size = 1;
+    MPI_Initialized(&iniciado);
+    if (iniciado) MPI_Comm_size(MPI_COMM_WORLD, &size);
+    return size;
+#else
+    return 1;
+#endif
+}
+
+int ga_available_threads() {
+    return resolve_thread_count(0, GA_MAX_THREADS);
+}
+
+const char* ga_topology_name(GaTopology topology) {
+    return (topology == GA_TOPOLOGY_FULL) ? "completa" : "anel";
+}
+
+GAContext* ga_context_create(const GAConfig* cfg_pedida, const GaIslandConfig* islands) {
+    GAContext* ctx = (GAContext*)calloc(1, sizeof(GAContext));
+    if (ctx == NULL) return NULL;
+    ctx->cfg = *cfg_pedida;
+    const GAConfig* cfg = &ctx->cfg;
+    if (ctx->cfg.parallel_breeding && ctx->cfg.strategy == GA_STRATEGY_FISHER) {
+        // O torneio da fisher é sequencial: a reprodução dela é sempre em série
+        printf("AVISO: reproducao paralela nao vale com a estrategia fisher (reproducao em serie)\n");
+        ctx->cfg.parallel_breeding = 0;
+    }
+    ctx->islands = islands ? *islands : (GaIslandConfig){1, 0, 0, GA_TOPOLOGY_RING};
+    ctx->rank = ga_mpi_rank();
+    ctx->n_ranks = ga_mpi_size();
+    ctx->n_local = (ctx->islands.n_islands > 0) ? ctx->islands.n_islands : 1;
+    ctx->n_total = ctx->n_local * ctx->n_ranks;
+    ctx->modo_ilhas = (ctx->n_total > 1);
+
+    if (!ctx->modo_ilhas) {
+        ctx->pops = (GAState*)malloc(sizeof(GAState));
+        ga_state_alloc(&ctx->pops[0], cfg);
+        ctx->pops[0].report = 1;
+        return ctx;
+    }
+
+    // A população total é dividida entre as ilhas (mesmo custo por geração)
+    int pop_ilha = cfg->population_size / ctx->n_total;
+    if (pop_ilha < GA_ISLAND_MIN_POP) pop_ilha = GA_ISLAND_MIN_POP;
+    int k = ctx->islands.n_migrants;
+    if (k > pop_ilha / 2) k = pop_ilha / 2;
+    if (k > GA_MAX_MIGRANTS) k = GA_MAX_MIGRANTS;
+    if (k < 0) k = 0;
+    ctx->k_migrantes = k;
+
+    // Só a ilha global 0 escreve log, telemetria e progresso
+    ctx->pops = (GAState*)malloc(sizeof(GAState) * ctx->n_local);
+    for (int l = 0; l < ctx->n_local; l++) {
+        int g = ctx->rank * ctx->n_local + l;
+        GAConfig c = *cfg;
+        c.population_size = pop_ilha;
+        c.num_threads = 1; // O paralelismo é entre ilhas
+        if (g != 0) c.log = NULL;
+        ga_state_alloc(&ctx->pops[l], &c);
+        ctx->pops[l].report = (g == 0);
+    }
+
+    size_t linhas = (size_t)k * (cfg->num_dimensions + 1);
+    ctx->enviados = (double*)malloc(sizeof(double) * (linhas * ctx->n_local + 1));
+    ctx->tabela = (ctx->n_ranks > 1) ? (double*)malloc(sizeof(double) * (linhas * ctx->n_total + 1)) : ctx->enviados;
+    ctx->motivos = (GaStopReason*)malloc(sizeof(GaStopReason) * ctx->n_local);
+    ctx->parou = (int*)malloc(sizeof(int) * ctx->n_local);
+    return ctx;
+}
+
+void ga_context_free(GAContext* ctx) {
+    if (ctx == NULL) return;
+    for (int l = 0; l < (ctx->modo_ilhas ? ctx->n_local : 1); l++) ga_state_free(&ctx->pops[l]);
+    free(ctx->pops);
+    if (ctx->tabela != ctx->enviados) free(ctx->tabela);
+    free(ctx->enviados);
+    free(ctx->motivos);
+    free(ctx->parou);
+    free(ctx->retomada);
+    free(ctx);
+}
+
+void ga_context_set_seed(GAContext* ctx, unsigned long long seed) {
+    ctx->cfg.seed = seed;
+}
+
+void ga_context_set_log(GAContext* ctx, GaLog* log) {
+    ctx->cfg.log = log;
+    ctx->pops[0].cfg.log = (ctx->rank == 0) ? log : NULL;
+}
+
+const GaRunStats* ga_context_stats(const GAContext* ctx) {
+    return &ctx->stats;
+}
+
+const GaProfile* ga_context_profile(const GAContext* ctx) {
+    return &ctx->profile;
+}
+
+const char* ga_prof_section_name(GaProfSection section) {
+    switch (section) {
+        case GA_PROF_AVALIACAO:    return "avaliacao";
+        case GA_PROF_ESTATISTICAS: return "estatisticas";
+        case GA_PROF_ADAPTATIVO:   return "adaptativo";
+        case GA_PROF_RESET:        return "reset";
+        case GA_PROF_LOG:          return "log";
+        case GA_PROF_REPRODUCAO:   return "reproducao";
+        case GA_PROF_SUBSTITUTO:   return "substituto";
+        case GA_PROF_MIGRACAO:     return "migracao";
+        case GA_PROF_COUNT:        break;
+    }
+    return "?";
+}
+
+void ga_print_profile(const GaProfile* p) {
+    double total = 0.0;
+    for (int k = 0; k < GA_PROF_COUNT; k++) total += p->seconds[k];
+    printf(" [GA] Perfil (s):");
+    for (int k = 0; k < GA_PROF_COUNT; k++)
+        printf(" %s %.3f (%.1f%%)%s", ga_prof_section_name((GaProfSection)k), p->seconds[k],
+               total > 0 ? 100.0 * p->seconds[k] / total : 0.0, k + 1 < GA_PROF_COUNT ? " |" : "\n");
+    printf(" [GA] Avaliacoes: %lld (invalidas: %lld = %.2f%%) | alocacoes: %lld\n", p->evaluations, p->invalid,
+           p->evaluations > 0 ? 100.0 * p->invalid / p->evaluations : 0.0, p->allocations);
+}
+
+/** Perfil do contexto: soma das ilhas, mais o tempo de migração medido fora delas. */
+static void collect_profile(GAContext* ctx) {
+    GaProfile* p = &ctx->profile;
+    double migracao = p->seconds[GA_PROF_MIGRACAO];
+    memset(p, 0, sizeof(*p));
+    p->seconds[GA_PROF_MIGRACAO] = migracao;
+    for (int l = 0; l < (ctx->modo_ilhas ? ctx->n_local : 1); l++) {
+        const GaProfile* q = &ctx->pops[l].prof;
+        p->enabled = q->enabled;
+        for (int k = 0; k < GA_PROF_COUNT; k++) p->seconds[k] += q->seconds[k];
+        p->evaluations += q->evaluations;
+        p->invalid += q->invalid;
+        p->allocations += q->allocations;
+        p->surrogate_candidates += q->surrogate_candidates;
+        p->surrogate_skipped += q->surrogate_skipped;
+        p->surrogate_probes += q->surrogate_probes;
+        p->surrogate_hits += q->surrogate_hits;
+        p->cache_hits += q->cache_hits;
+        p->cache_misses += q->cache_misses;
+    }
+}
+
+/** Imprime o motivo da parada e os totais (só no processo 0 e com verbose). */
+static void report_stop(const GAContext* ctx) {
+    if (!ctx->cfg.verbose || ctx->rank != 0) return;
+    const GaRunStats* s = &ctx->stats;
+    printf("\n");
+    printf(" [GA] Parada: %s (%d geracoes, %lld avaliacoes, %.1f s)\n",
+           ga_stop_reason_name(s->stop_reason), s->generations, s->evaluations, s->seconds);
+    if (ctx->cfg.surrogate.enabled) {
+        const GaProfile* p = &ctx->profile;
+        printf(" [GA] Substituto: %lld avaliacoes poupadas (%.1f%% de %lld filhos triados) | acerto da triagem: %.1f%% (%lld sondas)\n",
+               p->surrogate_skipped, p->surrogate_candidates > 0 ? 100.0 * p->surrogate_skipped / p->surrogate_candidates : 0.0,
+               p->surrogate_candidates, p->surrogate_probes > 0 ? 100.0 * p->surrogate_hits / p->surrogate_probes : 0.0,
+               p->surrogate_probes);
+    }
+    if (ctx->cfg.cache.entries > 0) {
+        const GaProfile* p = &ctx->profile;
+        long long total = p->cache_hits + p->cache_misses;
+        printf(" [GA] Cache de fitness: %lld acertos, %lld falhas (%.1f%% dos filhos novos)\n",
+               p->cache_hits, p->cache_misses, total > 0 ? 100.0 * p->cache_hits / total : 0.0);
+    }
+    if (ctx->profile.enabled) ga_print_profile(&ctx->profile);
+}
+
+// =============================================================================
+// CHECKPOINT / RETOMADA
+// =============================================================================
+// Formato (ordem de bytes nativa, tudo contíguo): as structs vão direto no fwrite,
+// então o checkpoint só retoma numa máquina com a mesma ordem de bytes.
+//   GaCkptHeader
+//   double log_pendente[GA_LOG_NCOLS][log_pending]   (bloco do log ainda em memória)
+//   concluído: double melhor[num_dimensions]
+//   senão, para cada ilha local: GaCkptIsland, genes[n][dims] (ordem de indivíduo,
+//   qualquer que seja o layout), fitness[n], fitness_known[n], gene_sums[dims], prev_best[dims]
+//   e, com o modelo substituto, surr_genes[dims][archive_size], surr_fit[archive_size];
+//   com o cache de fitness, cache_chaves[entries][dims], cache_fit[entries], cache_estado[entries]
+
+#define GA_CKPT_MAGIC "GACKPT1"
+#define GA_CKPT_VERSION 7
+#define GA_CKPT_FITNESS_ID_LEN 256
+
+typedef struct {
+    char magic[8];
+    int32_t version;
+    int32_t concluido;
+    int32_t num_dimensions;
+    int32_t population_size;   // Por ilha
+    int32_t n_local, n_total, rank;
+    int32_t next_gen;          // Concluído: gerações feitas
+    uint64_t seed;
+    uint64_t tamanho;          // Bytes do arquivo inteiro (detecta arquivo cortado)
+    double seconds;            // Tempo de relógio já gasto
+    int64_t evaluations;
+    int32_t stop_reason;
+    int32_t log_pending;       // Linhas do bloco do log ainda em memória
+    int64_t log_bin_offset, log_csv_offset;
+    int32_t surrogate_archive; // Tamanho do arquivo do modelo substituto (0 = desligado)
+    int32_t cache_entries;     // Posições do cache de fitness (0 = desligado)
+    int32_t strategy;          // GaStrategy das populações
+    int32_t parallel_breeding; // 1 = reprodução em blocos (outro gerador, outra evolução)
+    char fitness_id[GA_CKPT_FITNESS_ID_LEN]; // GAConfig.fitness_id (cortado, sempre com '\0')
+} GaCkptHeader;
+
+/** Escalares de uma ilha: controle adaptativo, gerador e contadores de parada. */
+typedef struct {
+    uint64_t rng[4];
+    double mutation_prob, baseline_mutation, prev_best_fit, severity;
+    int32_t stagnation_counter, convergence_counter, repulsion_mode_counter, crossover_mode;
+    int32_t post_reset_cnt, has_prev_best, prev_evento, gens_sem_melhora;
+    int32_t resets_feitos, expansion_events, reset_pendente, reservado;
+    int64_t total_evals;
+    uint64_t surr_rng[4];
+    int32_t surr_n, surr_next;
+} GaCkptIsland;
+
+/** Caminho do checkpoint deste processo (o processo r > 0 ganha o sufixo ".rank<r>"). */
+static void checkpoint_file(const char* base, int rank, char* out, size_t cap) {
+    if (rank == 0) snprintf(out, cap, "%s", base);
+    else snprintf(out, cap, "%s.rank%d", base, rank);
+}
+
+static unsigned char* ckpt_put(unsigned char* p, const void* src, size_t n) {
+    if (n > 0) memcpy(p, src, n);
+    return p + n;
+}
+
+/**
+ * Fotografa o contexto no começo da geração 'next_gen' (antes da avaliação) ou,
+ * com 'best', o resultado final. Só copia memória: a gravação é da outra thread.
+ */
+static void* ga_snapshot(const GAContext* ctx, int next_gen, const GaRunStats* s, const Individual* best, size_t* len) {
+    const GAState* p0 = &ctx->pops[0];
+    int n = p0->cfg.population_size, dims = p0->cfg.num_dimensions;
+    int n_pops = ctx->modo_ilhas ? ctx->n_local : 1;
+    GaLog* log = p0->cfg.log;
+
+    GaCkptHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GA_CKPT_MAGIC, sizeof(h.magic));
+    h.version = GA_CKPT_VERSION;
+    h.concluido = (best != NULL);
+    h.num_dimensions = dims;
+    h.population_size = n;
+    h.n_local = n_pops;
+    h.n_total = ctx->modo_ilhas ? ctx->n_total : 1;
+    h.rank = ctx->rank;
+    h.next_gen = next_gen;
+    h.seed = ctx->cfg.seed;
+    h.seconds = s->seconds;
+    h.evaluations = s->evaluations;
+    h.stop_reason = s->stop_reason;
+    long bin_off, csv_off;
+    ga_log_position(best ? NULL : log, &bin_off, &csv_off); // Concluído: o log já não importa
+    h.log_bin_offset = bin_off;
+    h.log_csv_offset = csv_off;
+    h.log_pending = (log && !best) ? log->n : 0;
+    int arq = p0->cfg.surrogate.enabled ? p0->cfg.surrogate.archive_size : 0;
+    h.surrogate_archive = arq;
+    size_t ent = (size_t)p0->cfg.cache.entries; // Já arredondado por ga_state_alloc
+    h.cache_entries = (int32_t)ent;
+    h.strategy = (int32_t)p0->cfg.strategy;
+    h.parallel_breeding = p0->cfg.parallel_breeding;
+    snprintf(h.fitness_id, sizeof(h.fitness_id), "%s", ctx->cfg.fitness_id ? ctx->cfg.fitness_id : "");
+
+    size_t por_ilha = sizeof(GaCkptIsland) + sizeof(double) * ((size_t)n * dims + n + 2 * dims + (size_t)arq * (dims + 1)) + n +
+                      ent * (sizeof(uint64_t) * dims + sizeof(double) + 1);
+    h.tamanho = sizeof(h) + sizeof(double) * GA_LOG_NCOLS * h.log_pending +
+                (best ? sizeof(double) * dims : por_ilha * n_pops);
+    unsigned char* buf = (unsigned char*)malloc(h.tamanho);
+    if (buf == NULL) return NULL;
+
+    unsigned char* p = ckpt_put(buf, &h, sizeof(h));
+    for (int c = 0; c < GA_LOG_NCOLS; c++) p = ckpt_put(p, log ? log->bloco[c] : NULL, sizeof(double) * h.log_pending);
+    if (best) {
+        for (int d = 0; d < dims; d++) { double g = IND_GENE(*best, d); p = ckpt_put(p, &g, sizeof(g)); }
+    } else {
+        for (int l = 0; l < n_pops; l++) {
+            const GAState* st = &ctx->pops[l];
+            GaCkptIsland e;
+            memset(&e, 0, sizeof(e));
+            memcpy(e.rng, st->rng.s, sizeof(e.rng));
+            e.mutation_prob = st->mutation_prob;
+            e.baseline_mutation = st->baseline_mutation;
+            e.prev_best_fit = st->prev_best_fit;
+            e.severity = st->severity;
+            e.stagnation_counter = st->stagnation_counter;
+            e.convergence_counter = st->convergence_counter;
+            e.repulsion_mode_counter = st->repulsion_mode_counter;
+            e.crossover_mode = st->crossover_mode;
+            e.post_reset_cnt = st->post_reset_cnt;
+            e.has_prev_best = st->has_prev_best;
+            e.prev_evento = st->prev_evento;
+            e.gens_sem_melhora = st->gens_sem_melhora;
+            e.resets_feitos = st->resets_feitos;
+            e.expansion_events = st->expansion_events;
+            e.reset_pendente = st->reset_pendente;
+            e.total_evals = st->total_evals;
+            memcpy(e.surr_rng, st->surr_rng.s, sizeof(e.surr_rng));
+            e.surr_n = st->surr_n;
+            e.surr_next = st->surr_next;
+            p = ckpt_put(p, &e, sizeof(e));
+            for (int i = 0; i < n; i++)
+                for (int d = 0; d < dims; d++) { double g = IND_GENE(st->population[i], d); p = ckpt_put(p, &g, sizeof(g)); }
+            p = ckpt_put(p, st->fitness, sizeof(double) * n);
+            p = ckpt_put(p, st->fitness_known, n);
+            p = ckpt_put(p, st->gene_sums, sizeof(double) * dims);
+            p = ckpt_put(p, st->prev_best.genes, sizeof(double) * dims);
+            p = ckpt_put(p, st->surr_genes, sizeof(double) * arq * dims);
+            p = ckpt_put(p, st->surr_fit, sizeof(double) * arq);
+            p = ckpt_put(p, st->cache_chaves, sizeof(uint64_t) * ent * dims);
+            p = ckpt_put(p, st->cache_fit, sizeof(double) * ent);
+            p = ckpt_put(p, st->cache_estado, ent);
+        }
+    }
+    *len = h.tamanho;
+    return buf;
+}
+
+/** Cabeçalho de um buffer de checkpoint, ou NULL se ele não for um checkpoint íntegro. */
+static const GaCkptHeader* ckpt_header(const void* data, size_t len) {
+    const GaCkptHeader* h = (const GaCkptHeader*)data;
+    if (data == NULL || len < sizeof(*h)) return NULL;
+    if (memcmp(h->magic, GA_CKPT_MAGIC, sizeof(h->magic)) != 0 || h->version != GA_CKPT_VERSION) return NULL;
+    if (h->tamanho != len || memchr(h->fitness_id, '\0', sizeof(h->fitness_id)) == NULL) return NULL;
+    return h;
+}
+
+int ga_checkpoint_probe(const char* path, GaCheckpointInfo* info) {
+    char arq[512];
+    checkpoint_file(path, ga_mpi_rank(), arq, sizeof(arq));
+    size_t len = 0;
+    void* data = checkpoint_read_file(arq, &len);
+    const GaCkptHeader* h = ckpt_header(data, len);
+    if (h) {
+        info->concluido = h->concluido;
+        info->geracao = h->next_gen;
+        info->seed = h->seed;
+        info->log_bin_offset = (long)h->log_bin_offset;
+        info->log_csv_offset = (long)h->log_csv_offset;
+    }
+    free(data);
+    return h ? 0 : -1;
+}
+
+void ga_checkpoint_remove(const char* path) {
+    char arq[512];
+    checkpoint_file(path, ga_mpi_rank(), arq, sizeof(arq));
+    remove(arq);
+}
+
+int ga_context_resume(GAContext* ctx, const char* path) {
+    char arq[512];
+    checkpoint_file(path, ctx->rank, arq, sizeof(arq));
+    size_t len = 0;
+    void* data = checkpoint_read_file(arq, &len);
+    const GaCkptHeader* h = ckpt_header(data, len);
+    char fitness_id[GA_CKPT_FITNESS_ID_LEN];
+    snprintf(fitness_id, sizeof(fitness_id), "%s", ctx->cfg.fitness_id ? ctx->cfg.fitness_id : "");
+    int ok = h && h->num_dimensions == ctx->cfg.num_dimensions && h->seed == ctx->cfg.seed &&
+             h->population_size == ctx->pops[0].cfg.population_size && h->rank == ctx->rank &&
+             h->n_local == (ctx->modo_ilhas ? ctx->n_local : 1) && h->n_total == (ctx->modo_ilhas ? ctx->n_total : 1) &&
+             h->surrogate_archive == (ctx->pops[0].cfg.surrogate.enabled ? ctx->pops[0].cfg.surrogate.archive_size : 0) &&
+             h->cache_entries == ctx->pops[0].cfg.cache.entries && h->strategy == (int32_t)ctx->pops[0].cfg.strategy &&
+             h->parallel_breeding == ctx->pops[0].cfg.parallel_breeding &&
+             strncmp(h->fitness_id, fitness_id, sizeof(fitness_id)) == 0;
+    if (!ok) { free(data); return -1; }
+
+    if (ctx->cfg.verbose && ctx->rank == 0) {
+        if (h->concluido) printf(" [GA] Checkpoint %s: execucao ja concluida (%d geracoes)\n", path, h->next_gen);
+        else printf(" [GA] Checkpoint %s: retomando na geracao %d\n", path, h->next_gen + 1);
+    }
+    free(ctx->retomada);
+    ctx->retomada = data;
+    ctx->retomada_len = len;
+    return 0;
+}
+
+/**
+ * Aplica o checkpoint de ga_context_resume às populações (no lugar de ga_state_reset).
+ * @return A geração em que a execução continua; *segundos recebe o tempo já gasto.
+ */
+static int ga_restore(GAContext* ctx, double* segundos) {
+    const GaCkptHeader* h = (const GaCkptHeader*)ctx->retomada;
+    const unsigned char* p = (const unsigned char*)ctx->retomada + sizeof(*h);
+    int n = h->population_size, dims = h->num_dimensions;
+
+    GaLog* log = ctx->pops[0].cfg.log;
+    for (int c = 0; c < GA_LOG_NCOLS; c++) {
+        if (log) memcpy(log->bloco[c], p, sizeof(double) * h->log_pending);
+        p += sizeof(double) * h->log_pending;
+    }
+    if (log) log->n = h->log_pending;
+
+    for (int l = 0; l < h->n_local; l++) {
+        GAState* st = &ctx->pops[l];
+        GaCkptIsland e;
+        memcpy(&e, p, sizeof(e));
+        p += sizeof(e);
+        st->cfg.seed = h->seed;
+        st->rng_stream = (unsigned long long)(ctx->rank * h->n_local + l);
+        memcpy(st->rng.s, e.rng, sizeof(e.rng));
+        for (int b = 0; b < 2; b++) memset(st->known_buffers[b], 0, n);
+        st->cur_buffer = 1;
+        swap_gene_buffers(st); // Matriz 0, como em ga_state_reset
+        for (int i = 0; i < n; i++)
+            for (int d = 0; d < dims; d++) { memcpy(&IND_GENE(st->population[i], d), p, sizeof(double)); p += sizeof(double); }
+        memcpy(st->fitness, p, sizeof(double) * n);                p += sizeof(double) * n;
+        memcpy(st->fitness_known, p, n);                           p += n;
+        memcpy(st->gene_sums, p, sizeof(double) * dims);           p += sizeof(double) * dims;
+        memcpy(st->prev_best.genes, p, sizeof(double) * dims);     p += sizeof(double) * dims;
+        if (h->surrogate_archive > 0) {
+            size_t arq = (size_t)h->surrogate_archive;
+            memcpy(st->surr_genes, p, sizeof(double) * arq * dims);  p += sizeof(double) * arq * dims;
+            memcpy(st->surr_fit, p, sizeof(double) * arq);           p += sizeof(double) * arq;
+        }
+        if (h->cache_entries > 0) {
+            size_t ent = (size_t)h->cache_entries;
+            memcpy(st->cache_chaves, p, sizeof(uint64_t) * ent * dims); p += sizeof(uint64_t) * ent * dims;
+            memcpy(st->cache_fit, p, sizeof(double) * ent);             p += sizeof(double) * ent;
+            memcpy(st->cache_estado, p, ent);                           p += ent;
+            for (size_t s = 0; s < ent; s++) st->cache_dono[s] = -1;
+        }
+
+        st->mutation_prob = e.mutation_prob;
+        st->baseline_mutation = e.baseline_mutation;
+        st->prev_best_fit = e.prev_best_fit;
+        st->severity = e.severity;
+        st->stagnation_counter = e.stagnation_counter;
+        st->convergence_counter = e.convergence_counter;
+        st->repulsion_mode_counter = e.repulsion_mode_counter;
+        st->crossover_mode = e.crossover_mode;
+        st->post_reset_cnt = e.post_reset_cnt;
+        st->has_prev_best = e.has_prev_best;
+        st->prev_evento = (GaEvent)e.prev_evento;
+        st->gens_sem_melhora = e.gens_sem_melhora;
+        st->resets_feitos = e.resets_feitos;
+        st->expansion_events = e.expansion_events;
+        st->reset_pendente = e.reset_pendente;
+        st->total_evals = e.total_evals;
+        memcpy(st->surr_rng.s, e.surr_rng, sizeof(e.surr_rng));
+        st->surr_n = e.surr_n;
+        st->surr_next = e.surr_next;
+        ga_prof_reset(st);
+    }
+    *segundos = h->seconds;
+    int gen = h->next_gen;
+    free(ctx->retomada);
+    ctx->retomada = NULL;
+    return gen;
+}
+
+/** Gravadora de checkpoints da execução (NULL se desligado). */
+static CheckpointWriter* ga_checkpoint_start(const GAContext* ctx) {
+    if (ctx->cfg.checkpoint_path == NULL || ctx->cfg.checkpoint_every <= 0) return NULL;
+    char arq[512];
+    checkpoint_file(ctx->cfg.checkpoint_path, ctx->rank, arq, sizeof(arq));
+    return checkpoint_writer_start(arq);
+}
+
+/** Entrega um snapshot à gravadora (não espera pelo disco). */
+static void ga_checkpoint_submit(CheckpointWriter* w, const GAContext* ctx, int next_gen, const GaRunStats* s,
+                                 const Individual* best) {
+    size_t len = 0;
+    void* data = ga_snapshot(ctx, next_gen, s, best, &len);
+    if (data) checkpoint_writer_submit(w, data, len);
+}
+
+/** Fim da execução: grava o checkpoint concluído (com o melhor) e espera a gravadora. */
+static void ga_checkpoint_finish(CheckpointWriter* w, const GAContext* ctx, const Individual* best) {
+    if (w == NULL) return;
+    ga_checkpoint_submit(w, ctx, ctx->stats.generations, &ctx->stats, best);
+    checkpoint_writer_stop(w);
+}
+
+/** Execução retomada de um checkpoint concluído: devolve o melhor guardado. */
+static Individual ga_restore_result(GAContext* ctx) {
+    const GaCkptHeader* h = (const GaCkptHeader*)ctx->retomada;
+    int dims = h->num_dimensions;
+    Individual best = {(double*)malloc(sizeof(double) * dims), 1};
+    memcpy(best.genes, (const unsigned char*)ctx->retomada + sizeof(*h), sizeof(double) * dims);
+    ctx->stats = (GaRunStats){(GaStopReason)h->stop_reason, h->next_gen, h->evaluations, h->seconds};
+    free(ctx->retomada);
+    ctx->retomada = NULL;
+    report_stop(ctx);
+    return best;
+}
+
+// =============================================================================
+// MOTOR PRINCIPAL (GA CYCLE)
+// =============================================================================
+
+/** Uma população só, do jeito clássico (sem ilhas). */
+static Individual run_single(GAContext* ctx, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                             const void* extra_param) {
+    GAState* st = &ctx->pops[0];
+    const GAConfig* cfg = &ctx->cfg;
+    int gen0 = 0;
+    double ja_gasto = 0.0;
+    if (ctx->retomada) gen0 = ga_restore(ctx, &ja_gasto);
+    else ga_state_reset(st, cfg->seed, 0);
+
+    CheckpointWriter* ckpt = ga_checkpoint_start(ctx);
+    double t_inicio = wall_seconds() - ja_gasto;
+    GaStopReason stop_reason = GA_STOP_MAX_GENERATIONS;
+    int gens_feitas = gen0;
+
+    for (int gen = gen0; gen < cfg->max_generations; gen++) {
+        ga_evaluate(st, fitness_func, fitness_batch, extra_param);
+        ga_adapt(st);
+
+        // Critérios de parada: a população avaliada desta geração é a final
+        gens_feitas = gen + 1;
+        int ultima = ga_target_stop(st, &stop_reason) || gen + 1 >= cfg->max_generations ||
+                     ga_local_stop(st, &stop_reason) || ga_budget_stop(&cfg->stop, st->total_evals, t_inicio, &stop_reason);
+        ga_report(st, gen, ultima);
+        if (ultima) break;
+
+        ga_breed(st, gen);
+        if (ckpt && (gen + 1) % cfg->checkpoint_every == 0) {
+            GaRunStats parcial = {stop_reason, gen + 1, st->total_evals, wall_seconds() - t_inicio};
+            ga_checkpoint_submit(ckpt, ctx, gen + 1, &parcial, NULL);
+        }
+    }
+    ctx->stats = (GaRunStats){stop_reason, gens_feitas, st->total_evals, wall_seconds() - t_inicio};
+    st->prof.allocations++; // A cópia do melhor, logo abaixo
+    collect_profile(ctx);
+    report_stop(ctx);
+
+    // O laço sai logo após avaliar a última geração (sem reproduzir de novo),
+    // então a matriz atual e o vetor de fitness descrevem a população final.
+    Individual best = clone_individual(&st->population[ga_best_index(st)], cfg->num_dimensions);
+    ga_checkpoint_finish(ckpt, ctx, &best);
+    return best;
+}
+
+// =============================================================================
+// MODELO DE ILHAS (MIGRAÇÃO ENTRE THREADS E PROCESSOS MPI)
+// =============================================================================
+
+static int select_extremes(const double* fit, int n, int k, int maior, int excluido, int* out) {
+    int m = 0;
+    for (int i = 0; i < n; i++) {
+        if (i == excluido) continue;
+        double f = maior ? fit[i] : -fit[i];
+        if (m == k && f <= (maior ? fit[out[m - 1]] : -fit[out[m - 1]])) continue;
+        int p = (m < k) ? m++ : m - 1;
+        while (p > 0 && f > (maior ? fit[out[p - 1]] : -fit[out[p - 1]])) { out[p] = out[p - 1]; p--; }
+        out[p] = i;
+    }
+    return m;
+}
+
+/**
+ * Recebe migrantes numa ilha: cada um (do melhor para o pior) substitui um
+ * dos piores indivíduos locais, se for melhor que ele. O melhor local nunca é
+ * trocado e cópias do melhor local são ignoradas. Os migrantes chegam com o
+ * fitness já conhecido, então não são reavaliados.
+ * @param migrantes Linhas de (dims genes + fitness), em ordem decrescente de fitness.
+ */
+static void receive_migrants(GAState* st, const double* const* migrantes, int k) {
+    int dims = st->cfg.num_dimensions;
+    int piores[GA_MAX_MIGRANTS];
+    int m = select_extremes(st->fitness, st->cfg.population_size, k, 0, st->best_idx, piores);
+    Individual melhor = st->population[st->best_idx];
+
+    int recebidos = 0;
+    for (int a = 0; a < k && recebidos < m; a++) {
+        const double* linha = migrantes[a];
+        double f = linha[dims];
+        int slot = piores[recebidos];
+        if (f <= -1e200 || f <= st->fitness[slot]) continue;
+        Individual mig = {(double*)linha, 1};
+        if (are_individuals_equal(mig, melhor, dims)) continue;
+
+        for (int d = 0; d < dims; d++) IND_GENE(st->population[slot], d) = linha[d];
+        st->fitness[slot] = f;
+        st->fitness_known[slot] = 1;
+        recebidos++;
+        if (f > st->max_fit) { st->max_fit = f; st->best_idx = slot; }
+    }
+    if (recebidos > 0) {
+        recompute_gene_sums(st);
+        st->diversity = -1.0;
+    }
+}
+
+/**
+ * Migração: cada ilha publica as suas k melhores numa tabela global (todas as
+ * ilhas de todos os processos, na ordem do índice global) e recebe de acordo
+ * com a topologia. Anel: as k melhores da ilha anterior. Completa: as k
+ * melhores entre todas as outras ilhas. A tabela é a mesma em todo processo,
+ * então o resultado não depende de quantas threads ou processos foram usados.
+ */
+static void migrate(GAState* ilhas, int n_local, int rank, int n_total, const GaIslandConfig* isl, int k,
+                    double* enviados, double* tabela) {
+    int dims = ilhas[0].cfg.num_dimensions;
+    int row = dims + 1;
+
+    for (int l = 0; l < n_local; l++) {
+        GAState* st = &ilhas[l];
+        int melhores[GA_MAX_MIGRANTS];
+        int m = select_extremes(st->fitness, st->cfg.population_size, k, 1, -1, melhores);
+        for (int a = 0; a < k; a++) {
+            double* linha = &enviados[((size_t)l * k + a) * row];
+            if (a < m) {
+                for (int d = 0; d < dims; d++) linha[d] = IND_GENE(st->population[melhores[a]], d);
+                linha[dims] = st->fitness[melhores[a]];
+            } else {
+                for (int d = 0; d < dims; d++) linha[d] = 0.0;
+                linha[dims] = -1e300; // Ilha com menos de k válidos: linha vazia
+            }
+        }
+    }
+#ifdef GA_USE_MPI
+    if (tabela != enviados)
+        MPI_Allgather(enviados, n_local * k * row, MPI_DOUBLE, tabela, n_local * k * row, MPI_DOUBLE, MPI_COMM_WORLD);
+#endif
+
+    for (int l = 0; l < n_local; l++) {
+        int g = rank * n_local + l;
+        const double* migrantes[GA_MAX_MIGRANTS];
+        if (isl->topology == GA_TOPOLOGY_FULL) {
+            // As k melhores linhas de todas as outras ilhas (empate: menor índice global)
+            int m = 0;
+            for (int r = 0; r < n_total * k; r++) {
+                if (r / k == g) continue;
+                const double* linha = &tabela[(size_t)r * row];
+                if (m == k && linha[dims] <= migrantes[m - 1][dims]) continue;
+                int p = (m < k) ? m++ : m - 1;
+                while (p > 0 && linha[dims] > migrantes[p - 1][dims]) { migrantes[p] = migrantes[p - 1]; p--; }
+                migrantes[p] = linha;
+            }
+            receive_migrants(&ilhas[l], migrantes, m);
+        } else {
+            int origem = (g + n_total - 1) % n_total;
+            for (int a = 0; a < k; a++) migrantes[a] = &tabela[((size_t)origem * k + a) * row];
+            receive_migrants(&ilhas[l], migrantes, k);
+        }
+    }
+}
+
+/** Todas as ilhas de um contexto, em passo sincronizado. */
+static Individual run_islands(GAContext* ctx, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                              const void* extra_param) {
+    const GAConfig* cfg = &ctx->cfg;
+    const GaIslandConfig* isl = &ctx->islands;
+    GAState* ilhas = ctx->pops;
+    int rank = ctx->rank, n_ranks = ctx->n_ranks;
+    int n_local = ctx->n_local, n_total = ctx->n_total;
+    int k = ctx->k_migrantes;
+    int migrar = (k > 0 && isl->migration_interval > 0);
+
+    if (rank == 0 && cfg->verbose) {
+        printf(" [GA] Ilhas: %d x %d individuos (%d processo(s)), migracao de %d a cada %d geracoes (topologia %s)\n",
+               n_total, ilhas[0].cfg.population_size, n_ranks, k, isl->migration_interval, ga_topology_name(isl->topology));
+    }
+
+    // Ilha g (índice global) usa o fluxo g do gerador: nenhuma sequência se repete
+    int gen0 = 0;
+    double ja_gasto = 0.0;
+    if (ctx->retomada) gen0 = ga_restore(ctx, &ja_gasto);
+    else for (int l = 0; l < n_local; l++) ga_state_reset(&ilhas[l], cfg->seed, (unsigned long long)(rank * n_local + l));
+
+    GaStopReason* motivos = ctx->motivos;
+    int* parou = ctx->parou;
+#ifdef _OPENMP
+    int n_threads = resolve_thread_count(cfg->num_threads, n_local);
+#endif
+    ctx->profile.seconds[GA_PROF_MIGRACAO] = 0.0;
+    CheckpointWriter* ckpt = ga_checkpoint_start(ctx);
+    double t_inicio = wall_seconds() - ja_gasto;
+    GaStopReason stop_reason = GA_STOP_MAX_GENERATIONS;
+    int gens_feitas = gen0;
+    long long total_evals = 0;
+    int parar = 0;
+
+#ifdef _OPENMP
+    #pragma omp parallel num_threads(n_threads) if(n_threads > 1)
+#endif
+    for (int gen = gen0; gen < cfg->max_generations; gen++) {
+        // Cada ilha avança uma geração, em paralelo e sem comunicação
+#ifdef _OPENMP
+        #pragma omp for schedule(static, 1)
+#endif
+        for (int l = 0; l < n_local; l++) {
+            ga_evaluate(&ilhas[l], fitness_func, fitness_batch, extra_param);
+            ga_adapt(&ilhas[l]);
+            parou[l] = ga_target_stop(&ilhas[l], &motivos[l]) || ga_local_stop(&ilhas[l], &motivos[l]);
+        }
+
+        // Decisão coletiva na thread principal (a única que fala MPI).
+        // Estagnação e piso de diversidade só param quando valem em todas as ilhas;
+        // os orçamentos valem para a soma de todas e o alvo, para qualquer uma.
+#ifdef _OPENMP
+        #pragma omp master
+#endif
+        {
+            long long soma[5] = {0, 0, 0, 0, 0}; // avaliações, ilhas estagnadas, ilhas sem diversidade, tempo esgotado, ilhas no alvo
+            for (int l = 0; l < n_local; l++) {
+                soma[0] += ilhas[l].total_evals;
+                if (parou[l]) soma[motivos[l] == GA_STOP_TARGET ? 4 : motivos[l] == GA_STOP_STAGNATION ? 1 : 2]++;
+            }
+            soma[3] = (cfg->stop.max_seconds > 0 && wall_seconds() - t_inicio >= cfg->stop.max_seconds);
+#ifdef GA_USE_MPI
+            if (n_ranks > 1) MPI_Allreduce(MPI_IN_PLACE, soma, 5, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
+            total_evals = soma[0];
+            gens_feitas = gen + 1;
+            if (soma[4] > 0) { stop_reason = GA_STOP_TARGET; parar = 1; }
+            else if (gen + 1 >= cfg->max_generations) parar = 1;
+            else if (soma[1] + soma[2] == n_total) { stop_reason = soma[1] ? GA_STOP_STAGNATION : GA_STOP_DIVERSITY; parar = 1; }
+            else if (cfg->stop.max_evaluations > 0 && total_evals >= cfg->stop.max_evaluations) { stop_reason = GA_STOP_EVALUATIONS; parar = 1; }
+            else if (soma[3] > 0) { stop_reason = GA_STOP_TIME; parar = 1; }
+        }
+#ifdef _OPENMP
+        #pragma omp barrier
+#endif
+
+        // Relatório depois da decisão (a geração que para sempre entra no log)
+        // e antes da migração (o log mostra a população que a ilha evoluiu)
+#ifdef _OPENMP
+        #pragma omp for schedule(static, 1)
+#endif
+        for (int l = 0; l < n_local; l++) ga_report(&ilhas[l], gen, parar);
+        if (parar) break;
+
+        if (migrar && (gen + 1) % isl->migration_interval == 0) {
+#ifdef _OPENMP
+            #pragma omp master
+#endif
+            {
+                GA_PROF_START(t_migracao);
+                migrate(ilhas, n_local, rank, n_total, isl, k, ctx->enviados, ctx->tabela);
+                GA_PROF_STOP(&ctx->profile, GA_PROF_MIGRACAO, t_migracao);
+            }
+#ifdef _OPENMP
+            #pragma omp barrier
+#endif
+        }
+
+#ifdef _OPENMP
+        #pragma omp for schedule(static, 1)
+#endif
+        for (int l = 0; l < n_local; l++) ga_breed(&ilhas[l], gen);
+
+        // Checkpoint entre gerações: todas as ilhas paradas no mesmo ponto
+        // (a condição é a mesma em toda thread, então a barreira é segura)
+        if (ckpt && (gen + 1) % cfg->checkpoint_every == 0) {
+#ifdef _OPENMP
+            #pragma omp master
+#endif
+            {
+                GaRunStats parcial = {stop_reason, gen + 1, total_evals, wall_seconds() - t_inicio};
+                ga_checkpoint_submit(ckpt, ctx, gen + 1, &parcial, NULL);
+            }
+#ifdef _OPENMP
+            #pragma omp barrier
+#endif
+        }
+    }
+
+    ctx->stats = (GaRunStats){stop_reason, gens_feitas, total_evals, wall_seconds() - t_inicio};
+    ilhas[0].prof.allocations++; // A cópia do melhor, logo abaixo
+    collect_profile(ctx);
+    report_stop(ctx);
+
+    // Melhor entre todas as ilhas (empate: menor índice global)
+    int melhor_ilha = 0, melhor_idx = ga_best_index(&ilhas[0]);
+    for (int l = 1; l < n_local; l++) {
+        int i = ga_best_index(&ilhas[l]);
+        if (ilhas[l].fitness[i] > ilhas[melhor_ilha].fitness[melhor_idx]) { melhor_ilha = l; melhor_idx = i; }
+    }
+    Individual final_res = clone_individual(&ilhas[melhor_ilha].population[melhor_idx], cfg->num_dimensions);
+#ifdef GA_USE_MPI
+    if (n_ranks > 1) {
+        struct { double fit; int rank; } local = {ilhas[melhor_ilha].fitness[melhor_idx], rank}, global;
+        MPI_Allreduce(&local, &global, 1, MPI_DOUBLE_INT, MPI_MAXLOC, MPI_COMM_WORLD);
+        MPI_Bcast(final_res.genes, cfg->num_dimensions, MPI_DOUBLE, global.rank, MPI_COMM_WORLD);
+    }
+#endif
+    ga_checkpoint_finish(ckpt, ctx, &final_res);
     return final_res;
-}
\ No newline at end of file
+}
+
+Individual ga_context_run(GAContext* ctx, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                          const void* extra_param) {
+    const GaCkptHeader* h = (const GaCkptHeader*)ctx->retomada;
+    if (h && h->concluido) return ga_restore_result(ctx);
+    if (ctx->modo_ilhas) return run_islands(ctx, fitness_func, fitness_batch, extra_param);
+    return run_single(ctx, fitness_func, fitness_batch, extra_param);
+}
+
+// =============================================================================
+// EXECUÇÃO NO DISPOSITIVO (OpenMP target, ver ga_device.h)
+// =============================================================================
+
+/**
+ * Fitness e estatísticas da geração no dispositivo. Voltam só os totais das
+ * reduções e a linha do melhor (empate: menor índice, como ga_best_index), que
+ * é tudo o que ga_adapt, ga_report e os critérios de parada leem.
+ */
+static void device_evaluate(GAState* st, FitnessDeviceFunc fitness_device, const void* extra_param) {
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions, dev = st->dev;
+    const double* pop = st->dev_genes[st->dev_cur];
+    double* fit = st->dev_fitness;
+
+    GA_PROF_START(t_avaliacao);
+    fitness_device(pop, n, dims, fit, extra_param, dev);
+    GA_PROF_STOP(&st->prof, GA_PROF_AVALIACAO, t_avaliacao);
+
+    GA_PROF_START(t_estatisticas);
+    double total = 0.0, max_fit = -1e300;
+    int valid = 0;
+    GA_DEVICE_FOR(dev, is_device_ptr(fit) map(tofrom: total, max_fit, valid),
+                  reduction(+: total, valid) reduction(max: max_fit))
+    for (int i = 0; i < n; i++) {
+        double f = fit[i];
+        if (f > -1e200) {
+            total += f;
+            valid++;
+            if (f > max_fit) max_fit = f;
+        } else {
+            fit[i] = -1e300;
+        }
+    }
+    int best = n;
+    GA_DEVICE_FOR(dev, is_device_ptr(fit) map(tofrom: best), reduction(min: best))
+    for (int i = 0; i < n; i++)
+        if (fit[i] == max_fit && i < best) best = i;
+    if (best >= n) best = 0;
+
+    double avg = (valid > 0) ? total / valid : 0.0, variance = 0.0;
+    GA_DEVICE_FOR(dev, is_device_ptr(fit) map(tofrom: variance), reduction(+: variance))
+    for (int i = 0; i < n; i++)
+        if (fit[i] > -1e200) variance += (fit[i] - avg) * (fit[i] - avg);
+
+    // Centróide gene a gene e diversidade exata (a amostra de diversity_sample_size não se aplica)
+    double centroid[dims];
+    for (int j = 0; j < dims; j++) {
+        double sum = 0.0;
+        GA_DEVICE_FOR(dev, is_device_ptr(pop) map(tofrom: sum), reduction(+: sum))
+        for (int i = 0; i < n; i++) sum += pop[(size_t)i * dims + j];
+        st->gene_sums[j] = sum;
+        centroid[j] = sum / n;
+    }
+    double total_distance = 0.0;
+    GA_DEVICE_FOR(dev, is_device_ptr(pop) map(to: centroid[0:dims]) map(tofrom: total_distance),
+                  reduction(+: total_distance))
+    for (int i = 0; i < n; i++) {
+        double sq_dist = 0.0;
+        for (int j = 0; j < dims; j++) {
+            double d = pop[(size_t)i * dims + j] - centroid[j];
+            sq_dist += d * d;
+        }
+        total_distance += sqrt(sq_dist);
+    }
+
+    ga_device_get(&IND_GENE(st->population[best], 0), pop + (size_t)best * dims, sizeof(double) * dims, dev);
+    st->fitness[best] = (valid > 0) ? max_fit : -1e300;
+    st->fitness_known[best] = 1;
+    st->max_fit = st->fitness[best];
+    st->best_idx = best;
+    st->avg_fit = avg;
+    st->std_dev_fit = (valid > 0) ? sqrt(variance / valid) : 0.0;
+    st->diversity = total_distance / n;
+    st->evento = GA_EVT_NENHUM;
+    st->total_evals += n;
+    st->prof.evaluations += n;
+    st->prof.invalid += n - valid;
+    GA_PROF_STOP(&st->prof, GA_PROF_ESTATISTICAS, t_estatisticas);
+}
+
+/**
+ * Reprodução no dispositivo: o cruzamento (atração/repulsão), a mutação e os
+ * clamps de breed_generation, com um sorteio sem estado por (geração, gene)
+ * no lugar do gerador sequencial. A elite vem da linha do melhor no hospedeiro
+ * (a mesma que breed_generation usaria, inclusive depois de um reset).
+ */
+static void device_breed(GAState* st) {
+    GA_PROF_START(t_reproducao);
+    int n = st->cfg.population_size, dims = st->cfg.num_dimensions;
+    const double* gmin = st->cfg.gene_min;
+    const double* gmax = st->cfg.gene_max;
+    double* elite = st->elite.genes;
+    for (int d = 0; d < dims; d++)
+        elite[d] = (st->max_fit < -1e200) ? gmin[d] : IND_GENE(st->population[st->best_idx], d);
+    double mutation_prob = st->mutation_prob;
+    double rep_fact = st->rep_fact;
+    int repulsao = (st->crossover_mode == MODE_REPULSION);
+    uint64_t chave = rng_counter_key(st->cfg.seed, (uint64_t)st->dev_geracao++);
+    const double* pop = st->dev_genes[st->dev_cur];
+    double* new_pop = st->dev_genes[st->dev_cur ^ 1];
+
+    GA_DEVICE_FOR(st->dev, is_device_ptr(pop, new_pop) map(to: elite[0:dims], gmin[0:dims], gmax[0:dims]))
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < dims; j++) {
+            size_t k = (size_t)i * dims + j;
+            if (i == 0) { new_pop[k] = elite[j]; continue; } // Elitismo
+            double gene = repulsao ? pop[k] + rep_fact * (pop[k] - elite[j])
+                                   : (elite[j] + pop[k]) / 2.0;
+            if (rng_counter_uniform(chave, 2 * k) * 100.0 < mutation_prob)
+                gene += (rng_counter_uniform(chave, 2 * k + 1) - 0.5) * ((gmax[j] - gmin[j]) * MUTATION_SEVERITY / 100.0);
+            if (gene > gmax[j]) gene = gmax[j];
+            if (gene < gmin[j]) gene = gmin[j];
+            new_pop[k] = gene;
+        }
+    }
+    st->dev_cur ^= 1;
+    GA_PROF_STOP(&st->prof, GA_PROF_REPRODUCAO, t_reproducao);
+}
+
+static void device_state_free(GAState* st) {
+    for (int b = 0; b < 2; b++) { ga_device_free(st->dev_genes[b], st->dev); st->dev_genes[b] = NULL; }
+    ga_device_free(st->dev_fitness, st->dev);
+    st->dev_fitness = NULL;
+}
+
+Individual ga_context_run_device(GAContext* ctx, FitnessDeviceFunc fitness_device, const void* extra_param) {
+    GAState* st = &ctx->pops[0];
+    const GAConfig* cfg = &ctx->cfg;
+    int n = cfg->population_size, dims = cfg->num_dimensions;
+    if (ctx->modo_ilhas || cfg->layout != GA_LAYOUT_AOS || cfg->strategy != GA_STRATEGY_HIBRIDA) {
+        printf("AVISO: o AG no dispositivo exige uma populacao so (sem ilhas), layout AoS e estrategia hibrida\n");
+        return (Individual){NULL, 0};
+    }
+    if (cfg->verbose && (cfg->surrogate.enabled || cfg->cache.entries > 0 || cfg->checkpoint_every > 0 || ctx->retomada))
+        printf("AVISO: modelo substituto, cache de fitness e checkpoints nao valem no dispositivo (ignorados)\n");
+
+    // População inicial sorteada no hospedeiro (a mesma de ga_context_run) e enviada uma vez
+    ga_state_reset(st, cfg->seed, 0);
+    st->dev = ga_device_resolve(cfg->device);
+    st->dev_genes[0] = (double*)ga_device_alloc(sizeof(double) * n * dims, st->dev);
+    st->dev_genes[1] = (double*)ga_device_alloc(sizeof(double) * n * dims, st->dev);
+    st->dev_fitness = (double*)ga_device_alloc(sizeof(double) * n, st->dev);
+    st->prof.allocations += 3;
+    if (!st->dev_genes[0] || !st->dev_genes[1] || !st->dev_fitness) {
+        printf("AVISO: sem memoria no dispositivo para %d individuos\n", n);
+        device_state_free(st);
+        return (Individual){NULL, 0};
+    }
+    st->dev_cur = 0;
+    st->dev_geracao = 0;
+    device_push_population(st);
+
+    double t_inicio = wall_seconds();
+    GaStopReason stop_reason = GA_STOP_MAX_GENERATIONS;
+    int gens_feitas = 0;
+    for (int gen = 0; gen < cfg->max_generations; gen++) {
+        device_evaluate(st, fitness_device, extra_param);
+        ga_adapt(st);
+
+        gens_feitas = gen + 1;
+        int ultima = ga_target_stop(st, &stop_reason) || gen + 1 >= cfg->max_generations ||
+                     ga_local_stop(st, &stop_reason) || ga_budget_stop(&cfg->stop, st->total_evals, t_inicio, &stop_reason);
+        ga_report(st, gen, ultima);
+        if (ultima) break;
+
+        device_breed(st);
+    }
+    ctx->stats = (GaRunStats){stop_reason, gens_feitas, st->total_evals, wall_seconds() - t_inicio};
+    st->prof.allocations++; // A cópia do melhor, logo abaixo
+    collect_profile(ctx);
+    report_stop(ctx);
+
+    // O melhor da última geração (ga_adapt o guardou antes de um eventual reset)
+    Individual best = clone_individual(st->has_prev_best ? &st->prev_best : &st->population[st->best_idx], dims);
+    device_state_free(st);
+    return best;
+}
+
+// =============================================================================
+// MEDIÇÃO DOS OPERADORES
+// =============================================================================
+
+int ga_measure_operators(const GAConfig* cfg, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                         const void* extra_param, int generations, GaOperatorTiming* out) {
+    if (cfg->population_size < 2 || cfg->num_dimensions < 1 || generations < 1) return -1;
+    GAConfig c = *cfg;
+    c.log = NULL;
+    c.telemetry_phase = 0;
+    c.verbose = 0;
+    c.on_generation = NULL;
+    c.checkpoint_path = NULL;
+    c.max_generations = generations;
+
+    GAState st;
+    ga_state_alloc(&st, &c);
+    ga_state_reset(&st, c.seed, 0);
+
+    double t_eval = 0.0, t_adapt = 0.0, t_breed = 0.0, t_div = 0.0;
+    volatile double sink = 0.0;
+    for (int gen = 0; gen < generations; gen++) {
+        double t0 = wall_seconds();
+        ga_evaluate(&st, fitness_func, fitness_batch, extra_param);
+        double t1 = wall_seconds();
+        ga_adapt(&st);
+        double t2 = wall_seconds();
+        sink += calculate_genetic_diversity(&st);
+        double t3 = wall_seconds();
+        ga_breed(&st, gen);
+        double t4 = wall_seconds();
+        t_eval += t1 - t0; t_adapt += t2 - t1; t_div += t3 - t2; t_breed += t4 - t3;
+    }
+    (void)sink;
+
+    out->evaluate_ns = t_eval * 1e9 / generations;
+    out->adapt_ns = t_adapt * 1e9 / generations;
+    out->breed_ns = t_breed * 1e9 / generations;
+    out->diversity_ns = t_div * 1e9 / generations;
+    out->evaluations = st.total_evals;
+    out->generations = generations;
+    ga_state_free(&st);
+    return 0;
+}
+
+// =============================================================================
+// API CLÁSSICA (CONFIGURAÇÃO PELAS VARIÁVEIS GLOBAIS)
+// =============================================================================
+
+Individual run_ga_cycle(FitnessFunc fitness_func, const void* extra_param, int is_shape_opt) {
+    return run_ga_cycle_batch(fitness_func, NULL, extra_param, is_shape_opt);
+}
+
+Individual run_ga_cycle_batch(FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                              const void* extra_param, int is_shape_opt) {
+    GAConfig cfg = ga_config_from_globals();
+    GAContext* ctx = ga_context_create(&cfg, &GA_ISLANDS);
+    Individual best = ga_context_run(ctx, fitness_func, fitness_batch, extra_param);
+    GA_LAST_STOP_REASON = ctx->stats.stop_reason;
+    GA_LAST_GENERATIONS = ctx->stats.generations;
+    GA_LAST_EVALUATIONS = ctx->stats.evaluations;
+    ga_context_free(ctx);
+    return best;
+}
@@ -11,6 +11,8 @@
  */
 
 #include <stdio.h> // Necessário para manipular o tipo FILE*
+#include "rng.h"   // Gerador reentrante (RngState)
+#include "ga_log.h" // Log da evolução (GaLog)
 
 // ============================================================================
 // ESTRUTURAS DE DADOS
@@ -23,9 +25,74 @@
  * - Na Fase 2: Os genes representam a Velocidade na hora 1, hora 2, etc.
  */
 typedef struct {
-    double* genes; // Vetor dinâmico contendo as variáveis de decisão
+    double* genes; // Primeiro gene (uma "visão" dentro da matriz da população)
+    int stride;    // Distância (em doubles) entre genes consecutivos: 1 = contíguo
 } Individual;
 
+/**
+ * @brief Acesso ao j-ésimo gene de um indivíduo, independente do layout.
+ * Use sempre este macro nas funções de fitness: na população os genes podem
+ * estar intercalados (layout SoA) e 'genes[j]' leria o gene errado.
+ */
+#define IND_GENE(ind, j) ((ind).genes[(size_t)(j) * (ind).stride])
+
+/**
+ * @brief Layout da matriz de genes da população.
+ * - AoS (Array of Structures): cada indivíduo é uma linha contígua (genes lado a lado).
+ * - SoA (Structure of Arrays): cada gene é uma coluna contígua (indivíduos lado a lado),
+ *   formato ideal para laços vetorizados que percorrem a população gene a gene.
+ */
+typedef enum {
+    GA_LAYOUT_AOS = 0,
+    GA_LAYOUT_SOA = 1
+} GeneLayout;
+
+/**
+ * @brief Matriz contígua com os genes de toda a população (uma única alocação).
+ * O elemento (i, j) fica em data[i * ind_stride + j * gene_stride].
+ */
+typedef struct {
+    double* data;    // n * dims doubles contíguos
+    int n;           // Número de indivíduos (linhas)
+    int dims;        // Número de genes (colunas)
+    int ind_stride;  // AoS: dims | SoA: 1
+    int gene_stride; // AoS: 1    | SoA: n
+} GeneMatrix;
+
+/** @brief Acesso ao gene j do indivíduo i de uma GeneMatrix (ponteiro). */
+#define GM_AT(m, i, j) ((m)->data[(size_t)(i) * (m)->ind_stride + (size_t)(j) * (m)->gene_stride])
+
+// ============================================================================
+// FUNÇÕES DE AVALIAÇÃO (FITNESS)
+// ============================================================================
+
+/**
+ * @brief Fitness escalar: avalia um único indivíduo.
+ * @return Quanto maior, melhor. Valores <= -1e200 marcam indivíduos inválidos.
+ */
+typedef double (*FitnessFunc)(Individual ind, const void* param);
+
+/**
+ * @brief Fitness em lote: avalia os indivíduos [begin, end) de uma só vez.
+ * * Evita uma chamada indireta por indivíduo e permite que a física amortize
+ * trabalho comum (tabelas ambientais, SIMD, GPU) sobre a população inteira.
+ * Deve produzir exatamente o mesmo valor que a versão escalar correspondente.
+ * @param genes Matriz da população (respeite ind_stride/gene_stride, ou use GM_AT).
+ * @param out   Vetor indexado pelo índice global: out[i] para i em [begin, end).
+ */
+typedef void (*FitnessBatchFunc)(const GeneMatrix* genes, int begin, int end,
+                                 double* out, const void* param);
+
+/**
+ * @brief Fitness no dispositivo: avalia os n indivíduos de uma matriz que já
+ * mora na memória do acelerador (ver ga_device.h e ga_context_run_device).
+ * @param genes  Matriz AoS (n x dims) no dispositivo 'device'.
+ * @param out    n fitness, no mesmo dispositivo.
+ * Deve produzir o mesmo valor que a versão escalar correspondente.
+ */
+typedef void (*FitnessDeviceFunc)(const double* genes, int n, int dims, double* out,
+                                  const void* param, int device);
+
 // ============================================================================
 // VARIÁVEIS DE CONFIGURAÇÃO (GLOBAIS)
 // ============================================================================
@@ -35,48 +102,453 @@ typedef struct {
 /** @brief Tamanho da População (ex: 1000 indivíduos). */
 extern int POPULATION_SIZE;
 
+/**
+ * @brief Número de threads usadas na avaliação da população.
+ * 1 = serial (padrão); <= 0 = detecta automaticamente os núcleos disponíveis.
+ * A população é dividida em NUM_THREADS blocos fixos, então a mesma semente
+ * com o mesmo NUM_THREADS sempre reproduz o mesmo resultado.
+ */
+extern int NUM_THREADS;
+
 /** @brief Critério de Parada: Número máximo de ciclos evolutivos. */
 extern int MAX_GENERATIONS;
 
+/** @brief Motivo pelo qual a última execução do AG parou. */
+typedef enum {
+    GA_STOP_MAX_GENERATIONS = 0, // Chegou a MAX_GENERATIONS
+    GA_STOP_STAGNATION,          // K gerações sem melhora depois de M resets
+    GA_STOP_DIVERSITY,           // Diversidade genética abaixo do piso
+    GA_STOP_TIME,                // Orçamento de tempo de relógio esgotado
+    GA_STOP_EVALUATIONS,         // Orçamento de avaliações de fitness esgotado
+    GA_STOP_TARGET               // O melhor fitness chegou ao alvo (tempo até a solução)
+} GaStopReason;
+
+/**
+ * @brief Critérios de parada antecipada (cada campo em 0 = desligado).
+ * Verificados ao fim de cada geração; o primeiro que disparar encerra a execução.
+ */
+typedef struct {
+    int stagnation_gens;       // K: gerações seguidas sem melhora do melhor indivíduo
+    int min_resets;            // M: a estagnação só conta depois de M resets híbridos
+    double diversity_floor;    // Para quando a diversidade genética cair abaixo deste valor
+    double max_seconds;        // Tempo máximo de relógio por execução (s)
+    long long max_evaluations; // Máximo de chamadas de fitness (reaproveitadas não contam)
+    int target_enabled;        // 1 = para quando o melhor fitness chegar a target_fitness
+    double target_fitness;     // Alvo (com ilhas, basta uma ilha chegar lá)
+} GaStopCriteria;
+
+/** @brief Critérios de parada usados por run_ga_cycle (todos desligados por padrão). */
+extern GaStopCriteria GA_STOP;
+
+/** @brief Resultado da última execução: motivo da parada, gerações e avaliações feitas. */
+extern GaStopReason GA_LAST_STOP_REASON;
+extern int GA_LAST_GENERATIONS;
+extern long long GA_LAST_EVALUATIONS;
+
+/** @brief Texto de um motivo de parada (para relatórios). */
+const char* ga_stop_reason_name(GaStopReason reason);
+
+/**
+ * @brief Triagem dos filhos por um modelo substituto (k vizinhos mais próximos).
+ * * A população guarda as últimas archive_size avaliações válidas (genes
+ * normalizados pelos limites + fitness). Com esse arquivo cheio, o fitness de
+ * cada filho novo é previsto pela média dos k vizinhos mais próximos (pesos
+ * 1/d^2) e só passam pela fitness de verdade a fração eval_fraction com as
+ * melhores previsões e uma cota explore_fraction sorteada entre as demais. Os
+ * descartados ficam como inválidos na geração: continuam na população e
+ * reproduzem, mas não entram nas estatísticas nem podem ser a elite.
+ * * Compensa quando a fitness é cara (ex: --route): a previsão custa
+ * ~archive_size x dims operações por filho.
+ */
+typedef struct {
+    int enabled;              // 0 = desligado (padrão): todos os filhos novos são avaliados
+    int archive_size;         // Avaliações guardadas; a triagem começa com o arquivo cheio
+    int k;                    // Vizinhos da previsão (até 32)
+    double eval_fraction;     // Fração dos filhos novos avaliada pela ordem da previsão
+    double explore_fraction;  // Cota extra sorteada entre os descartados (mede o acerto da triagem)
+} GaSurrogateConfig;
+
+/** @brief Modelo substituto usado por ga_config_from_globals (desligado por padrão). */
+extern GaSurrogateConfig GA_SURROGATE;
+
+/**
+ * @brief Cache de fitness por genes (tabela hash de endereçamento aberto, tamanho fixo).
+ * * Antes da avaliação, cada filho novo é procurado na tabela pela chave dos
+ * seus genes: um acerto reaproveita o fitness guardado e filhos iguais na
+ * mesma geração são avaliados uma vez só. Comuns com genes presos nos
+ * limites (clamps, repulsão) e com a população convergida.
+ * * Com quantum = 0 a chave são os bits exatos dos genes e o resultado do AG
+ * é o mesmo sem cache (fitness determinística), só com menos chamadas. Com
+ * quantum > 0, genes a menos de quantum x (max - min) caem na mesma chave
+ * (troca exatidão por mais acertos). A memória é entries x (dims + 2) x 8 bytes.
+ */
+typedef struct {
+    int entries;              // Posições da tabela (arredondado para potência de 2; 0 = desligado)
+    double quantum;           // Passo da chave, em fração do intervalo do gene (0 = bits exatos)
+} GaFitnessCacheConfig;
+
+/** @brief Cache usado por ga_config_from_globals (desligado por padrão). */
+extern GaFitnessCacheConfig GA_FITNESS_CACHE;
+
+/**
+ * @brief Acelerador de ga_context_run_device (OpenMP target, ver ga_device.h).
+ * -1 (padrão) = desligado: quem chama usa ga_context_run. Sem esse acelerador
+ * (ou num build sem offload) a execução cai no hospedeiro.
+ */
+extern int GA_DEVICE;
+
+/**
+ * @brief Reprodução em blocos paralelos (0 = serial, padrão).
+ * * Com 1, a população é reproduzida em blocos fixos de indivíduos divididos
+ * entre as threads de num_threads. Cada gene sorteia a mutação num gerador
+ * sem estado (rng_counter_uniform) indexado pela geração e pela posição, em
+ * vez do fluxo sequencial de RngState. Os sorteios e as fórmulas de
+ * atração/repulsão e clamps viram laços vetorizáveis sobre a linha de genes.
+ * O resultado só depende da semente (não do número de threads), mas é outra
+ * evolução que a da reprodução serial. Vale para as estratégias hibrida e
+ * por-gene; com a fisher (torneio sequencial), ga_context_create avisa e desliga.
+ */
+extern int GA_PARALLEL_BREEDING;
+
+/**
+ * @brief Estratégia de mutação e controle adaptativo do AG.
+ * * Cada uma traz o seu controle (como a mutação, a repulsão e os resets reagem
+ * à estagnação) e o seu laço de reprodução; a escolha é feita uma vez por
+ * execução, então o laço por gene não paga nenhum desvio a mais.
+ */
+typedef enum {
+    GA_STRATEGY_HIBRIDA = 0, // Padrão: chance de mutação adaptativa -> repulsão -> reset híbrido (Frankenstein/EDA)
+    GA_STRATEGY_FISHER,      // Severidade adaptativa (modelo de Fisher): chance fixa, passo gaussiano que
+                             // encolhe na melhora e cresce na estagnação; reset total da população
+    GA_STRATEGY_POR_GENE,    // Todo gene muta a cada geração, com passo proporcional à taxa adaptativa;
+                             // mesma escada de repulsão e reset híbrido da padrão, com outros limiares
+    GA_STRATEGY_COUNT
+} GaStrategy;
+
+/** @brief Estratégia usada por ga_config_from_globals (GA_STRATEGY_HIBRIDA por padrão). */
+extern GaStrategy GA_STRATEGY;
+
+/** @brief Nome de uma estratégia ("hibrida", "fisher", "por-gene"). */
+const char* ga_strategy_name(GaStrategy strategy);
+
+/** @brief Estratégia pelo nome. @return 0 em sucesso, -1 se o nome não existe. */
+int ga_strategy_from_name(const char* nome, GaStrategy* out);
+
 /** @brief Quantidade de genes por indivíduo (Dimensão do problema). */
 extern int NUM_DIMENSIONS;
 
+/** @brief Layout da matriz de genes (GA_LAYOUT_AOS por padrão). */
+extern GeneLayout GENE_LAYOUT;
+
+/**
+ * @brief Tamanho da amostra usada na métrica de diversidade genética.
+ * 0 (padrão) = exata, sobre toda a população. Um valor m > 0 estima a distância
+ * média ao centróide com m indivíduos igualmente espaçados (útil para populações
+ * muito grandes). O centróide é sempre exato.
+ */
+extern int DIVERSITY_SAMPLE_SIZE;
+
 /** @brief Vetores que definem os limites mínimos e máximos para cada gene. */
 extern double* GENE_MIN_VALUE;
 extern double* GENE_MAX_VALUE;
 
+/**
+ * @brief Semente do gerador aleatório usada por run_ga_cycle.
+ * Cada chamada de run_ga_cycle reinicia o seu RngState a partir deste valor,
+ * então a mesma semente reproduz a mesma evolução, bit a bit.
+ */
+extern unsigned long long GA_SEED;
+
 // ============================================================================
 // INTEGRAÇÃO COM LOGS E DASHBOARD
 // ============================================================================
 
 /**
- * @brief Ponteiro para o arquivo de log CSV.
- * * Se este ponteiro for diferente de NULL, o motor escreverá as métricas
- * (Melhor Fitness, Média, Diversidade) a cada geração.
- * Isso permite que o script Python gere os gráficos em tempo real.
+ * @brief Log da evolução (ver ga_log.h).
+ * * Se este ponteiro for diferente de NULL, o motor registra as métricas
+ * (Melhor Fitness, Média, Diversidade, ...) das gerações selecionadas por
+ * GA_LOG_EVERY. O dashboard em Python lê o arquivo binário (ou o CSV exportado).
+ */
+extern GaLog* ga_log;
+
+/**
+ * @brief Decimação do log: registra uma geração a cada GA_LOG_EVERY.
+ * 1 (padrão) = todas; 0 = só as gerações em que um evento começa ou termina.
+ * A primeira e a última geração e toda mudança de evento (início/fim de
+ * repulsão, reset...) são sempre registradas, qualquer que seja a decimação.
+ */
+extern int GA_LOG_EVERY;
+
+// ============================================================================
+// CONFIGURAÇÃO POR EXECUÇÃO E MODELO DE ILHAS
+// ============================================================================
+
+/**
+ * @brief Observador chamado ao fim de cada geração com o melhor indivíduo dela.
+ * A visão 'best' aponta para a população e só vale durante a chamada (copie os
+ * genes se precisar guardá-los). No modelo de ilhas, só a ilha 0 chama.
+ */
+typedef void (*GaGenerationHook)(int generation, Individual best, double best_fitness, void* param);
+
+/**
+ * @brief Configuração de uma execução do AG.
+ * * O motor trabalha só com esta cópia (nada de estado global), então várias
+ * populações podem evoluir ao mesmo tempo no mesmo processo (um GAContext
+ * para cada). As variáveis globais acima continuam valendo como padrão:
+ * run_ga_cycle() monta a sua GAConfig com ga_config_from_globals().
+ */
+typedef struct {
+    int population_size;
+    int num_dimensions;
+    int max_generations;
+    int num_threads;            // Blocos de avaliação (<= 0 = automático)
+    const double* gene_min;     // Limites de cada gene (num_dimensions valores)
+    const double* gene_max;
+    GeneLayout layout;
+    int diversity_sample_size;
+    unsigned long long seed;
+    GaStopCriteria stop;
+    GaLog* log;                 // NULL = sem log
+    int log_every;
+    int telemetry_phase;        // Fase nos registros de telemetria (0 = não publica)
+    int verbose;                // 1 = imprime progresso e motivo da parada
+    GaGenerationHook on_generation; // NULL = nenhum observador
+    void* hook_param;
+    const char* checkpoint_path; // Arquivo de checkpoint (NULL = desligado; ver ga_context_resume)
+    int checkpoint_every;        // Gerações entre checkpoints (0 = desligado)
+    GaSurrogateConfig surrogate; // Triagem dos filhos (ver GaSurrogateConfig)
+    GaFitnessCacheConfig cache;  // Cache de fitness (ver GaFitnessCacheConfig)
+    int device;                  // Acelerador de ga_context_run_device (ver GA_DEVICE)
+    int parallel_breeding;       // Reprodução em blocos paralelos (ver GA_PARALLEL_BREEDING)
+    GaStrategy strategy;         // Mutação e controle adaptativo (ver GaStrategy)
+    const char* fitness_id;      // Texto que identifica a fitness (física, rota...); NULL = ""
+                                 // Vai no checkpoint: a retomada exige o mesmo texto
+} GAConfig;
+
+/** @brief GAConfig com os valores atuais das variáveis globais de configuração. */
+GAConfig ga_config_from_globals();
+
+/** @brief Topologia de migração entre as ilhas. */
+typedef enum {
+    GA_TOPOLOGY_RING = 0, // Cada ilha recebe as elites da ilha anterior
+    GA_TOPOLOGY_FULL      // Cada ilha recebe as melhores elites de todas as outras
+} GaTopology;
+
+/**
+ * @brief Modelo de ilhas: várias subpopulações independentes com migração periódica.
+ * * Cada ilha roda a lógica completa (atração/repulsão/reset) sobre a sua fatia
+ * da população (population_size / total de ilhas) e com o seu próprio fluxo do
+ * gerador. A cada migration_interval gerações, as n_migrants melhores de cada
+ * ilha substituem os piores indivíduos das ilhas vizinhas (conforme a topologia).
+ * * As ilhas de um processo rodam em threads (até num_threads). Compilado com
+ * -DGA_USE_MPI (make mpi), cada processo MPI roda n_islands ilhas e a migração
+ * atravessa os processos. O resultado só depende da semente e do total de
+ * ilhas, não de quantas threads ou processos as executam.
+ */
+typedef struct {
+    int n_islands;          // Ilhas por processo (1 = AG clássico, sem migração)
+    int migration_interval; // Gerações entre migrações
+    int n_migrants;         // Elites enviadas por ilha em cada migração
+    GaTopology topology;
+} GaIslandConfig;
+
+/** @brief Ilhas usadas por run_ga_cycle (padrão: 1 ilha, ou seja, desligado). */
+extern GaIslandConfig GA_ISLANDS;
+
+/** @brief Texto de uma topologia (para relatórios). */
+const char* ga_topology_name(GaTopology topology);
+
+/** @brief Posição deste processo no MPI_COMM_WORLD (0 sem MPI). */
+int ga_mpi_rank();
+
+/** @brief Número de processos MPI (1 sem MPI). */
+int ga_mpi_size();
+
+/** @brief Núcleos disponíveis para a avaliação (o que num_threads <= 0 usaria). */
+int ga_available_threads();
+
+/** @brief Resultado de uma execução: motivo da parada, gerações, avaliações e tempo. */
+typedef struct {
+    GaStopReason stop_reason;
+    int generations;
+    long long evaluations;     // Soma sobre todas as ilhas (e processos)
+    double seconds;            // Tempo de relógio
+} GaRunStats;
+
+/** @brief Trechos cronometrados do laço do AG (ver GaProfile). */
+typedef enum {
+    GA_PROF_AVALIACAO = 0, // Chamadas de fitness (e o cache de fitness)
+    GA_PROF_ESTATISTICAS,  // Média, desvio e melhor da geração
+    GA_PROF_ADAPTATIVO,    // Controle adaptativo (sem o reset)
+    GA_PROF_RESET,         // Resets híbridos
+    GA_PROF_LOG,           // Log, telemetria, observador e progresso
+    GA_PROF_REPRODUCAO,    // Cruzamento + mutação
+    GA_PROF_SUBSTITUTO,    // Previsão, triagem e arquivo do modelo substituto
+    GA_PROF_MIGRACAO,      // Troca de elites entre ilhas (e processos)
+    GA_PROF_COUNT
+} GaProfSection;
+
+/**
+ * @brief Contadores de perfil da última execução de um contexto.
+ * * Os cronômetros só existem num build com -DGA_PROFILE (make PROFILE=1):
+ * sem ele nem são compilados, 'enabled' = 0 e a coluna TempoGeracaoUs do log
+ * fica em zero. Os contadores valem sempre. No modelo de ilhas os tempos são
+ * somados sobre as ilhas (tempo de thread, não de relógio).
+ */
+typedef struct {
+    int enabled;
+    double seconds[GA_PROF_COUNT];
+    long long evaluations;     // Chamadas de fitness
+    long long invalid;         // Avaliações que devolveram <= -1e200 (indivíduo inválido)
+    long long allocations;     // Alocações do contexto até aqui (buffers + cópia do melhor; o laço não aloca)
+    // Modelo substituto (zeros se desligado)
+    long long surrogate_candidates; // Filhos novos que passaram pela triagem
+    long long surrogate_skipped;    // Dos quais ficaram sem avaliação (avaliações poupadas)
+    long long surrogate_probes;     // Sorteados entre os descartados e avaliados mesmo assim
+    long long surrogate_hits;       // Sondas que não superaram a média dos escolhidos (triagem acertou)
+    // Cache de fitness (zeros se desligado)
+    long long cache_hits;           // Filhos novos resolvidos pela tabela ou por um igual na mesma geração
+    long long cache_misses;         // Filhos novos que foram para a fitness
+} GaProfile;
+
+/** @brief Nome de um trecho cronometrado (para relatórios). */
+const char* ga_prof_section_name(GaProfSection section);
+
+/** @brief Imprime o resumo (tempo por trecho, avaliações, inválidos e alocações). */
+void ga_print_profile(const GaProfile* profile);
+
+/**
+ * @brief Contexto de execução do AG: configuração, matrizes da população,
+ * gerador, log e estatísticas (ou várias populações, no modelo de ilhas).
+ * * Opaco e independente de qualquer estado global: contextos diferentes podem
+ * rodar ao mesmo tempo em threads diferentes (ex: os Estágios 2 e 3).
+ * A memória é alocada uma vez em ga_context_create() e reaproveitada por
+ * todas as chamadas de ga_context_run().
  */
-extern FILE* ga_csv_file;
+typedef struct GAContext GAContext;
+
+/**
+ * @brief Cria um contexto (aloca os buffers; a população é sorteada em cada execução).
+ * @param cfg     Configuração copiada para o contexto (gene_min/gene_max devem
+ *                continuar válidos enquanto o contexto existir).
+ * @param islands Modelo de ilhas (NULL = uma população). Com MPI, ga_context_run
+ *                precisa ser chamada por todos os processos.
+ */
+GAContext* ga_context_create(const GAConfig* cfg, const GaIslandConfig* islands);
+
+/** @brief Libera o contexto e todos os seus buffers. */
+void ga_context_free(GAContext* ctx);
+
+/** @brief Troca a semente das próximas execuções (a mesma semente reproduz a evolução). */
+void ga_context_set_seed(GAContext* ctx, unsigned long long seed);
+
+/** @brief Troca o log das próximas execuções (NULL = sem log). */
+void ga_context_set_log(GAContext* ctx, GaLog* log);
+
+/**
+ * @brief Executa o AG no contexto (equivalente a run_ga_cycle_batch, sem globais).
+ * Com ilhas, só o processo 0 imprime, e só a ilha 0 escreve no log e na telemetria.
+ * @return O melhor indivíduo encontrado (libere com free(genes)).
+ */
+Individual ga_context_run(GAContext* ctx, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                          const void* extra_param);
+
+/**
+ * @brief Executa o AG com a população morando no acelerador cfg.device.
+ * * Reprodução, fitness e estatísticas de cada geração rodam no dispositivo e
+ * só voltam as estatísticas e a linha do melhor indivíduo; o controle
+ * adaptativo, o log e os critérios de parada continuam no hospedeiro. A
+ * população inteira só atravessa nos resets híbridos.
+ * * A mutação usa um gerador sem estado (rng_counter_uniform) e todo indivíduo
+ * é avaliado em toda geração (ninguém herda o fitness da elite), então a
+ * evolução difere da de ga_context_run, mas só depende da semente. A média,
+ * o desvio e a diversidade do log são reduções paralelas (podem variar no
+ * último bit); o melhor indivíduo não.
+ * * Exige uma população só (sem ilhas), layout AoS e a estratégia hibrida. Modelo substituto, cache
+ * de fitness e checkpoints não valem aqui (são ignorados, com aviso).
+ * @return O melhor indivíduo (libere com free(genes)); genes = NULL se o
+ *         contexto não é compatível ou falta memória no dispositivo.
+ */
+Individual ga_context_run_device(GAContext* ctx, FitnessDeviceFunc fitness_device, const void* extra_param);
+
+/** @brief Estatísticas da última execução do contexto. */
+const GaRunStats* ga_context_stats(const GAContext* ctx);
+
+/**
+ * @brief Perfil da última execução do contexto.
+ * Com GA_PROFILE e verbose, ga_context_run já imprime o resumo ao terminar.
+ */
+const GaProfile* ga_context_profile(const GAContext* ctx);
 
 // ============================================================================
-// API PÚBLICA (FUNÇÕES)
+// CHECKPOINT / RETOMADA
 // ============================================================================
+// Com checkpoint_path e checkpoint_every, ga_context_run grava o estado
+// completo (genes, fitness, controle adaptativo, gerador, posição do log) a
+// cada checkpoint_every gerações, numa thread à parte e de forma atômica (ver
+// checkpoint.h). Ao terminar, grava um checkpoint "concluído" com o melhor
+// indivíduo e as estatísticas. Com MPI, o processo r > 0 usa "<path>.rank<r>".
+// Retomar um checkpoint reproduz a mesma evolução, bit a bit, da execução
+// que não foi interrompida (o orçamento de tempo conta o tempo já gasto).
+
+/** @brief O que um arquivo de checkpoint contém (para decidir como retomar). */
+typedef struct {
+    int concluido;              // 1 = a execução terminou (o melhor está guardado)
+    int geracao;                // Próxima geração a rodar (ou total feito, se concluído)
+    unsigned long long seed;    // Semente da execução
+    long log_bin_offset;        // Onde o log foi cortado (ga_log_reopen), -1 = sem log
+    long log_csv_offset;
+} GaCheckpointInfo;
+
+/** @brief Lê o cabeçalho de um checkpoint. @return 0 se existe e é válido, -1 caso contrário. */
+int ga_checkpoint_probe(const char* path, GaCheckpointInfo* info);
 
 /**
- * @brief Aloca memória para a população inicial.
- * Deve ser chamada após definir POPULATION_SIZE e NUM_DIMENSIONS.
+ * @brief Faz a próxima ga_context_run continuar do checkpoint (em vez de sortear a
+ * população). Se ele estiver concluído, ga_context_run só devolve o melhor guardado.
+ * O log do contexto deve ter sido reaberto com ga_log_reopen nas posições do checkpoint.
+ * @return 0 em sucesso, -1 se o arquivo não existe ou não bate com o contexto
+ *         (dimensões, população, ilhas, semente ou fitness_id diferentes).
  */
-void initialize_population();
+int ga_context_resume(GAContext* ctx, const char* path);
+
+/** @brief Apaga o checkpoint deste processo (para uma execução nova não retomar um antigo). */
+void ga_checkpoint_remove(const char* path);
+
+// ============================================================================
+// MEDIÇÃO DOS OPERADORES (bench.c)
+// ============================================================================
+
+/** @brief Tempo médio de cada operador do AG, em nanossegundos por geração. */
+typedef struct {
+    double evaluate_ns;   // Avaliação da população + estatísticas da geração
+    double adapt_ns;      // Controle adaptativo (inclui a diversidade quando ele a pede)
+    double breed_ns;      // Cruzamento + mutação + centróide da próxima geração
+    double diversity_ns;  // Uma medição completa da diversidade genética (sem cache)
+    long long evaluations;// Chamadas de fitness feitas
+    int generations;
+} GaOperatorTiming;
 
 /**
- * @brief Libera toda a memória alocada pelo AG.
- * Fundamental para evitar vazamento de memória (memory leaks) entre as fases.
+ * @brief Roda 'generations' gerações cronometrando cada operador separadamente.
+ * Sem log, telemetria, critérios de parada nem checkpoint. O AG evolui normalmente
+ * (inclusive repulsão e resets), então os tempos incluem esses caminhos.
+ * @return 0 em sucesso, -1 se os parâmetros forem inválidos.
  */
-void free_population();
+int ga_measure_operators(const GAConfig* cfg, FitnessFunc fitness_func, FitnessBatchFunc fitness_batch,
+                         const void* extra_param, int generations, GaOperatorTiming* out);
+
+// ============================================================================
+// API PÚBLICA (FUNÇÕES)
+// ============================================================================
 
 /**
  * @brief O Ciclo Principal da Evolução (The Main Loop).
  * Executa a sequência: Seleção -> Cruzamento -> Mutação -> Avaliação.
  * * 
+ * * O fitness viaja com os genes: a elite (slot 0) e qualquer filho idêntico a
+ * ela herdam o fitness já calculado e não são reavaliados. Por isso a fitness
+ * deve ser determinística (mesmos genes -> mesmo valor), como todas do projeto.
  * * @param fitness_func Ponteiro para a função que avalia quão bom é um indivíduo.
  * Isso permite plugar lógicas diferentes (Design ou Estratégia)
  * sem reescrever o motor.
@@ -85,9 +557,23 @@ void free_population();
  * @param is_shape_opt Flag booleana (0 ou 1) para indicar se estamos otimizando
  * forma (para logs específicos) ou estratégia.
  * * @return Individual O melhor indivíduo encontrado após todas as gerações.
+ * É uma cópia contígua (stride = 1) que pertence a quem chamou: libere com free(genes).
  */
-Individual run_ga_cycle(double (*fitness_func)(Individual, const void*), 
+Individual run_ga_cycle(FitnessFunc fitness_func, 
                         const void* extra_param, 
                         int is_shape_opt);
 
+/**
+ * @brief Variante de run_ga_cycle que usa uma fitness em lote quando disponível.
+ * * Cria um GAContext temporário com ga_config_from_globals() e GA_ISLANDS,
+ * executa e copia as estatísticas para GA_LAST_*.
+ * * A avaliação da população passa a chamar 'fitness_batch' uma vez por bloco
+ * de threads (um trecho por chamada, pulando quem já tem fitness conhecido).
+ * @param fitness_batch Versão em lote de 'fitness_func' (NULL = usa só a escalar).
+ */
+Individual run_ga_cycle_batch(FitnessFunc fitness_func,
+                              FitnessBatchFunc fitness_batch,
+                              const void* extra_param,
+                              int is_shape_opt);
+
 #endif // GA_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,138 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "ga_log.h"
+
+// Nomes das colunas (iguais ao cabeçalho CSV histórico que o dashboard lê)
+static const char* COL_NAMES[GA_LOG_NCOLS] = {
+    "Geracao", "MelhorFitness", "FitnessMedio", "DesvioPadraoFit",
+    "DiversidadeGenetica", "TaxaMutacao", "FatorRepulsao", "Evento", "TempoGeracaoUs",
+    "CacheAcertos", "CacheFalhas", "Severidade"
+};
+
+static const char* EVENT_NAMES[GA_EVT_COUNT] = {
+    "-", "POS-RESET", "REPULSAO", "RESET-HIBRIDO", "EXPANSAO", "RESET-TOTAL"
+};
+
+// Buffer grande do CSV: o sistema só é chamado a cada ~1 MB de texto
+#define GA_LOG_CSV_BUFFER (1 << 20)
+
+const char* ga_log_event_name(GaEvent ev) {
+    return (ev >= 0 && ev < GA_EVT_COUNT) ? EVENT_NAMES[ev] : "?";
+}
+
+GaLog* ga_log_open(const char* bin_path, const char* csv_path) {
+    GaLog* log = (GaLog*)calloc(1, sizeof(GaLog));
+    if (log == NULL) return NULL;
+
+    if (bin_path) {
+        log->bin = fopen(bin_path, "wb");
+        if (log->bin) {
+            GaLogHeader h;
+            memset(&h, 0, sizeof(h));
+            memcpy(h.magic, GA_LOG_MAGIC, sizeof(h.magic));
+            h.version = GA_LOG_VERSION;
+            h.header_size = GA_LOG_HEADER_SIZE;
+            h.n_cols = GA_LOG_NCOLS;
+            h.block_rows = GA_LOG_BLOCK_ROWS;
+            h.n_events = GA_EVT_COUNT;
+            for (int c = 0; c < GA_LOG_NCOLS; c++) strncpy(h.col_names[c], COL_NAMES[c], GA_LOG_NAME_LEN - 1);
+            for (int e = 0; e < GA_EVT_COUNT; e++) strncpy(h.event_names[e], EVENT_NAMES[e], GA_LOG_NAME_LEN - 1);
+            fwrite(&h, sizeof(h), 1, log->bin);
+        }
+    }
+    if (csv_path) {
+        log->csv = fopen(csv_path, "w");
+        if (log->csv) {
+            setvbuf(log->csv, NULL, _IOFBF, GA_LOG_CSV_BUFFER);
+            for (int c = 0; c < GA_LOG_NCOLS; c++) fprintf(log->csv, "%s%c", COL_NAMES[c], c + 1 < GA_LOG_NCOLS ? ',' : '\n');
+        }
+    }
+
+    if (log->bin == NULL && log->csv == NULL) { free(log); return NULL; }
+    return log;
+}
+
+/** Abre um arquivo existente para escrita, cortado em 'offset' bytes. */
+static FILE* reopen_truncated(const char* path, long offset) {
+    FILE* f = fopen(path, "r+b");
+    if (f == NULL) return NULL;
+    fseek(f, 0, SEEK_END);
+    if (ftell(f) < offset || ftruncate(fileno(f), offset) != 0) { fclose(f); return NULL; }
+    fseek(f, offset, SEEK_SET);
+    return f;
+}
+
+GaLog* ga_log_reopen(const char* bin_path, const char* csv_path, long bin_offset, long csv_offset) {
+    if (bin_path == NULL || bin_offset < GA_LOG_HEADER_SIZE) return NULL;
+    GaLog* log = (GaLog*)calloc(1, sizeof(GaLog));
+    if (log == NULL) return NULL;
+    log->bin = reopen_truncated(bin_path, bin_offset);
+    if (log->bin == NULL) { free(log); return NULL; }
+    if (csv_path && csv_offset >= 0) {
+        log->csv = reopen_truncated(csv_path, csv_offset);
+        if (log->csv) setvbuf(log->csv, NULL, _IOFBF, GA_LOG_CSV_BUFFER);
+    }
+    return log;
+}
+
+void ga_log_position(GaLog* log, long* bin_offset, long* csv_offset) {
+    *bin_offset = -1;
+    *csv_offset = -1;
+    if (log == NULL) return;
+    if (log->bin) { fflush(log->bin); *bin_offset = ftell(log->bin); }
+    if (log->csv) { fflush(log->csv); *csv_offset = ftell(log->csv); }
+}
+
+void ga_log_append(GaLog* log, const GaLogRow* row) {
+    int n = log->n;
+    log->bloco[GA_COL_GERACAO][n] = row->geracao;
+    log->bloco[GA_COL_MELHOR_FITNESS][n] = row->melhor_fitness;
+    log->bloco[GA_COL_FITNESS_MEDIO][n] = row->fitness_medio;
+    log->bloco[GA_COL_DESVIO_PADRAO_FIT][n] = row->desvio_padrao_fit;
+    log->bloco[GA_COL_DIVERSIDADE][n] = row->diversidade;
+    log->bloco[GA_COL_TAXA_MUTACAO][n] = row->taxa_mutacao;
+    log->bloco[GA_COL_FATOR_REPULSAO][n] = row->fator_repulsao;
+    log->bloco[GA_COL_EVENTO][n] = row->evento;
+    log->bloco[GA_COL_TEMPO_GERACAO][n] = row->tempo_geracao_us;
+    log->bloco[GA_COL_CACHE_ACERTOS][n] = row->cache_acertos;
+    log->bloco[GA_COL_CACHE_FALHAS][n] = row->cache_falhas;
+    log->bloco[GA_COL_SEVERIDADE][n] = row->severidade;
+    if (++log->n == GA_LOG_BLOCK_ROWS) ga_log_flush(log);
+}
+
+void ga_log_flush(GaLog* log) {
+    int n = log->n;
+    if (n == 0) return;
+
+    if (log->bin) {
+        // Bloco sempre de tamanho fixo: zera a cauda não usada de cada coluna
+        for (int c = 0; c < GA_LOG_NCOLS; c++)
+            memset(&log->bloco[c][n], 0, sizeof(double) * (GA_LOG_BLOCK_ROWS - n));
+        int64_t n_linhas = n;
+        fwrite(&n_linhas, sizeof(n_linhas), 1, log->bin);
+        fwrite(log->bloco, sizeof(log->bloco), 1, log->bin);
+        fflush(log->bin); // Blocos completos ficam visíveis para leitores ao vivo
+    }
+    if (log->csv) {
+        for (int i = 0; i < n; i++) {
+            fprintf(log->csv, "%d,%.5f,%.5f,%.5f,%.5f,%.2f,%.2f,%s,%.1f,%.0f,%.0f,%.2f\n",
+                (int)log->bloco[GA_COL_GERACAO][i], log->bloco[GA_COL_MELHOR_FITNESS][i],
+                log->bloco[GA_COL_FITNESS_MEDIO][i], log->bloco[GA_COL_DESVIO_PADRAO_FIT][i],
+                log->bloco[GA_COL_DIVERSIDADE][i], log->bloco[GA_COL_TAXA_MUTACAO][i],
+                log->bloco[GA_COL_FATOR_REPULSAO][i], ga_log_event_name((GaEvent)log->bloco[GA_COL_EVENTO][i]),
+                log->bloco[GA_COL_TEMPO_GERACAO][i], log->bloco[GA_COL_CACHE_ACERTOS][i],
+                log->bloco[GA_COL_CACHE_FALHAS][i], log->bloco[GA_COL_SEVERIDADE][i]);
+        }
+    }
+    log->n = 0;
+}
+
+void ga_log_close(GaLog* log) {
+    if (log == NULL) return;
+    ga_log_flush(log);
+    if (log->bin) fclose(log->bin);
+    if (log->csv) fclose(log->csv);
+    free(log);
+}
@@ -0,0 +1,132 @@
+#ifndef GA_LOG_H
+#define GA_LOG_H
+
+/**
+ * @file ga_log.h
+ * @brief Log da evolução geração a geração (binário colunar + CSV opcional).
+ * * O motor do AG só copia alguns números por geração para um bloco em memória.
+ * Quando o bloco enche (GA_LOG_BLOCK_ROWS linhas), ele é gravado de uma vez:
+ * no arquivo binário como colunas contíguas e, se pedido, exportado em CSV
+ * (a formatação de texto acontece toda fora do laço quente).
+ * * --- FORMATO BINÁRIO (.galog, ordem de bytes nativa) ---
+ * Gravado com fwrite direto; dashboard.py lê como little-endian (x86-64, ARM).
+ * Cabeçalho de GA_LOG_HEADER_SIZE bytes (GaLogHeader), seguido de blocos de
+ * tamanho fixo, um atrás do outro:
+ *   int64  n_linhas               (linhas válidas no bloco, <= block_rows)
+ *   double coluna[n_cols][block_rows]   (coluna por coluna; o resto é zero)
+ * Como todo bloco tem o mesmo tamanho, o arquivo pode ser mapeado direto em
+ * memória (ex: numpy.memmap, ver dashboard.py). Blocos completos podem ser
+ * lidos enquanto o AG ainda roda.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define GA_LOG_MAGIC "GALOG01"   // 8 bytes com o '\0'
+#define GA_LOG_VERSION 4 // 2: coluna TempoGeracaoUs; 3: CacheAcertos/CacheFalhas; 4: Severidade
+#define GA_LOG_HEADER_SIZE 512
+#define GA_LOG_BLOCK_ROWS 4096
+#define GA_LOG_NAME_LEN 24
+
+/**
+ * @brief Colunas do log, na ordem em que aparecem no arquivo (e no CSV).
+ * * As duas colunas da mutação têm a mesma unidade em todas as estratégias:
+ *   TaxaMutacao  chance (%) de cada gene de um filho mutar
+ *                (hibrida: adaptativa; fisher: fixa em 20; por-gene: sempre 100)
+ *   Severidade   tamanho do passo da mutação, em % do range do gene
+ *                (hibrida: fixo em 15, largura do passo uniforme; por-gene:
+ *                adaptativo, largura do passo uniforme; fisher: adaptativo,
+ *                desvio do passo gaussiano)
+ */
+typedef enum {
+    GA_COL_GERACAO = 0,
+    GA_COL_MELHOR_FITNESS,
+    GA_COL_FITNESS_MEDIO,
+    GA_COL_DESVIO_PADRAO_FIT,
+    GA_COL_DIVERSIDADE,
+    GA_COL_TAXA_MUTACAO,
+    GA_COL_FATOR_REPULSAO,
+    GA_COL_EVENTO,        // Código de GaEvent, gravado como double
+    GA_COL_TEMPO_GERACAO, // Duração do ciclo da geração em µs (0 sem GA_PROFILE)
+    GA_COL_CACHE_ACERTOS, // Filhos novos resolvidos pelo cache de fitness na geração (0 sem cache)
+    GA_COL_CACHE_FALHAS,  // Filhos novos que o cache não tinha (0 sem cache)
+    GA_COL_SEVERIDADE,    // Passo da mutação em % do range (ver acima)
+    GA_LOG_NCOLS
+} GaLogColumn;
+
+/** @brief Eventos do controle adaptativo (coluna Evento). */
+typedef enum {
+    GA_EVT_NENHUM = 0,    // "-"
+    GA_EVT_POS_RESET,     // "POS-RESET"
+    GA_EVT_REPULSAO,      // "REPULSAO"
+    GA_EVT_RESET_HIBRIDO, // "RESET-HIBRIDO"
+    GA_EVT_EXPANSAO,      // "EXPANSAO" (estratégia fisher: severidade ampliada)
+    GA_EVT_RESET_TOTAL,   // "RESET-TOTAL" (estratégia fisher: população sorteada de novo)
+    GA_EVT_COUNT
+} GaEvent;
+
+/** @brief Cabeçalho do arquivo binário (exatamente GA_LOG_HEADER_SIZE bytes). */
+typedef struct {
+    char magic[8];                                   // GA_LOG_MAGIC
+    int32_t version;                                 // GA_LOG_VERSION
+    int32_t header_size;                             // GA_LOG_HEADER_SIZE
+    int32_t n_cols;                                  // GA_LOG_NCOLS
+    int32_t block_rows;                              // Linhas por bloco
+    int32_t n_events;                                // GA_EVT_COUNT
+    char col_names[GA_LOG_NCOLS][GA_LOG_NAME_LEN];   // Mesmos nomes do cabeçalho CSV
+    char event_names[GA_EVT_COUNT][GA_LOG_NAME_LEN]; // Texto de cada código de evento
+    char reservado[GA_LOG_HEADER_SIZE - 28 - (GA_LOG_NCOLS + GA_EVT_COUNT) * GA_LOG_NAME_LEN];
+} GaLogHeader;
+
+/** @brief Uma linha do log (uma geração). */
+typedef struct {
+    int geracao;
+    double melhor_fitness, fitness_medio, desvio_padrao_fit;
+    double diversidade, taxa_mutacao, fator_repulsao;
+    GaEvent evento;
+    double tempo_geracao_us;
+    double cache_acertos, cache_falhas;
+    double severidade;
+} GaLogRow;
+
+/** @brief Log aberto: saídas e o bloco em memória ainda não gravado. */
+typedef struct {
+    FILE* bin;                                  // Arquivo .galog (NULL = desligado)
+    FILE* csv;                                  // Exportação CSV (NULL = desligada)
+    int n;                                      // Linhas no bloco atual
+    double bloco[GA_LOG_NCOLS][GA_LOG_BLOCK_ROWS];
+} GaLog;
+
+/** @brief Texto de um código de evento (o mesmo gravado no CSV). */
+const char* ga_log_event_name(GaEvent ev);
+
+/**
+ * @brief Abre um log. Qualquer um dos caminhos pode ser NULL (saída desligada).
+ * @return NULL se nenhuma saída pôde ser aberta.
+ */
+GaLog* ga_log_open(const char* bin_path, const char* csv_path);
+
+/** @brief Acrescenta uma linha ao bloco (grava o bloco quando enche). */
+void ga_log_append(GaLog* log, const GaLogRow* row);
+
+/** @brief Grava o bloco pendente (mesmo incompleto) nas saídas. */
+void ga_log_flush(GaLog* log);
+
+/**
+ * @brief Reabre um log interrompido para continuar a partir de um checkpoint.
+ * Os arquivos são cortados nas posições guardadas (ga_log_position) e as
+ * novas linhas entram depois delas. csv_offset < 0 = sem CSV na execução original.
+ * @return NULL se o arquivo binário não existir ou for menor que o cabeçalho.
+ */
+GaLog* ga_log_reopen(const char* bin_path, const char* csv_path, long bin_offset, long csv_offset);
+
+/**
+ * @brief Descarrega os buffers do sistema e informa até onde cada arquivo foi gravado
+ * (-1 para uma saída desligada). O bloco em memória (n linhas) não entra na conta.
+ */
+void ga_log_position(GaLog* log, long* bin_offset, long* csv_offset);
+
+/** @brief Grava o que falta, fecha os arquivos e libera o log. */
+void ga_log_close(GaLog* log);
+
+#endif // GA_LOG_H
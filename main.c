@@ -3,9 +3,18 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <pthread.h>
+#include <sys/resource.h>
 #include "ga_engine.h"
 #include "physics.h"
 #include "reports.h"
+#include "telemetry.h"
+#include "pipeline.h"
+#include "route.h"
+
+#ifdef GA_USE_MPI
+#include <mpi.h>
+#endif
 
 /**
  * @file main.c
@@ -14,20 +23,615 @@
  * 1. Design: Encontrar a melhor geometria física.
  * 2. Estratégia Longa: Encontrar o melhor perfil de velocidade para 3000km.
  * 3. Estratégia Curta: Otimizar o alcance diário com restrição de bateria.
- * * Também é responsável por gerar os logs CSV que alimentam o Dashboard em Python.
+ * * Também é responsável por gerar os logs (binário .galog e, com --csv, CSV)
+ * que alimentam o Dashboard em Python.
+ */
+
+/**
+ * @brief Lê a semente da linha de comando ("--seed N" ou "-s N").
+ * Sem a opção, usa o relógio (execução não reprodutível, mas a semente é
+ * impressa para que a rodada possa ser repetida depois).
+ */
+static unsigned long long parse_seed(int argc, char** argv) {
+    for (int i = 1; i < argc - 1; i++) {
+        if (strcmp(argv[i], "--seed") == 0 || strcmp(argv[i], "-s") == 0)
+            return strtoull(argv[i + 1], NULL, 10);
+    }
+    return (unsigned long long)time(NULL);
+}
+
+/** @brief Verifica se uma opção booleana (ex: "--fast-aero") foi passada. */
+static int has_flag(int argc, char** argv, const char* flag) {
+    for (int i = 1; i < argc; i++) if (strcmp(argv[i], flag) == 0) return 1;
+    return 0;
+}
+
+/** @brief Lê uma opção inteira ("--nome N"); devolve 'padrao' se ausente. */
+static int parse_int_option(int argc, char** argv, const char* nome, int padrao) {
+    for (int i = 1; i < argc - 1; i++) if (strcmp(argv[i], nome) == 0) return atoi(argv[i + 1]);
+    return padrao;
+}
+
+/** @brief Lê uma opção real ("--nome X"); devolve 'padrao' se ausente. */
+static double parse_double_option(int argc, char** argv, const char* nome, double padrao) {
+    for (int i = 1; i < argc - 1; i++) if (strcmp(argv[i], nome) == 0) return atof(argv[i + 1]);
+    return padrao;
+}
+
+/** @brief Lê uma opção de texto ("--nome valor"); devolve 'padrao' se ausente. */
+static const char* parse_string_option(int argc, char** argv, const char* nome, const char* padrao) {
+    for (int i = 1; i < argc - 1; i++) if (strcmp(argv[i], nome) == 0) return argv[i + 1];
+    return padrao;
+}
+
+/**
+ * @brief Abre o log de uma fase: sempre "<fase>.galog" e, se pedido, "<fase>.csv".
+ * Com MPI, só o processo 0 grava logs (nos demais devolve NULL).
+ */
+static GaLog* open_phase_log(const char* fase, int exportar_csv) {
+    if (ga_mpi_rank() != 0) return NULL;
+    char bin_path[64], csv_path[64];
+    snprintf(bin_path, sizeof(bin_path), "%s.galog", fase);
+    snprintf(csv_path, sizeof(csv_path), "%s.csv", fase);
+    GaLog* log = ga_log_open(bin_path, exportar_csv ? csv_path : NULL);
+    if (log == NULL) printf("AVISO: Nao foi possivel criar o log de %s\n", fase);
+    return log;
+}
+
+/**
+ * @brief Cria o contexto de um estágio com o seu log e o checkpoint "<fase>.ckpt".
+ * Com 'retomar' e um checkpoint compatível, o estágio continua de onde parou e o
+ * log é reaberto na posição gravada no checkpoint (ou nem é aberto, se o estágio
+ * já terminou). Sem checkpoint utilizável, o estágio começa do zero.
+ * @param ckpt_path Precisa continuar válido enquanto o contexto existir.
+ */
+static GAContext* create_stage(const char* fase, const char* ckpt_path, GAConfig cfg, int exportar_csv,
+                               int retomar, int checkpoint_every, GaLog** log) {
+    GaCheckpointInfo info;
+    int retomada = retomar && ga_checkpoint_probe(ckpt_path, &info) == 0;
+    *log = NULL;
+    if (!retomada) {
+        *log = open_phase_log(fase, exportar_csv);
+    } else if (!info.concluido && ga_mpi_rank() == 0) {
+        char bin_path[64], csv_path[64];
+        snprintf(bin_path, sizeof(bin_path), "%s.galog", fase);
+        snprintf(csv_path, sizeof(csv_path), "%s.csv", fase);
+        *log = ga_log_reopen(bin_path, exportar_csv ? csv_path : NULL, info.log_bin_offset, info.log_csv_offset);
+        if (*log == NULL) printf("AVISO: Nao foi possivel continuar o log de %s (o estagio segue sem log)\n", fase);
+    }
+    cfg.log = *log;
+    cfg.checkpoint_path = (checkpoint_every > 0) ? ckpt_path : NULL;
+    cfg.checkpoint_every = checkpoint_every;
+    GAContext* ctx = ga_context_create(&cfg, &GA_ISLANDS);
+    if (retomada && ga_context_resume(ctx, ckpt_path) != 0) {
+        printf("AVISO: %s nao corresponde a esta configuracao; %s recomeca do zero\n", ckpt_path, fase);
+        ga_log_close(*log);
+        *log = open_phase_log(fase, exportar_csv);
+        ga_context_set_log(ctx, *log);
+    } else if (retomada && !cfg.verbose) {
+        printf(" (%s retomado de %s)\n", fase, ckpt_path);
+    }
+    return ctx;
+}
+
+/** @brief Um estágio do AG pronto para rodar (na thread principal ou numa thread própria). */
+typedef struct {
+    GAContext* ctx;
+    FitnessFunc fitness;
+    FitnessBatchFunc fitness_batch;
+    FitnessDeviceFunc fitness_device; // Usada com --device (NULL = o estágio roda na CPU)
+    const void* param;
+    GaLog* log;
+    Individual best; // Preenchido por run_stage
+} StageJob;
+
+static void* run_stage(void* arg) {
+    StageJob* job = (StageJob*)arg;
+    job->best = (GA_DEVICE >= 0 && job->fitness_device)
+              ? ga_context_run_device(job->ctx, job->fitness_device, job->param)
+              : ga_context_run(job->ctx, job->fitness, job->fitness_batch, job->param);
+    ga_log_close(job->log); job->log = NULL;
+    return NULL;
+}
+
+/** @brief Cópia própria dos genes de uma estratégia (9 velocidades). */
+static Individual copy_strategy(const Individual* src) {
+    Individual dest = {(double*)malloc(sizeof(double) * 9), 1};
+    memcpy(dest.genes, src->genes, sizeof(double) * 9);
+    return dest;
+}
+
+/** @brief Motivo da parada de um estágio que rodou sem imprimir (em paralelo). */
+static void print_stage_stats(const GAContext* ctx) {
+    const GaRunStats* st = ga_context_stats(ctx);
+    printf(" [GA] Parada: %s (%d geracoes, %lld avaliacoes, %.1f s)\n",
+           ga_stop_reason_name(st->stop_reason), st->generations, st->evaluations, st->seconds);
+    if (ga_context_profile(ctx)->enabled) ga_print_profile(ga_context_profile(ctx));
+}
+
+/** @brief Carro físico a partir dos 7 genes do Estágio 1. */
+static CarDesignOutrigger car_from_shape(const double* g) {
+    CarDesignOutrigger car;
+    car.L_casco = g[0];
+    car.W_casco = g[1];
+    car.H_casco = g[2];
+    car.L_pod   = g[3];
+    car.D_pod   = g[4];
+    car.A_solar = g[5];
+    car.W_sep   = g[6];
+    return car;
+}
+
+// =============================================================================
+// BENCHMARK DE TEMPO ATÉ A SOLUÇÃO (--benchmark ARQ.json)
+// =============================================================================
+// Os três estágios, em série e sem logs, para cada semente fixa 1..N. Cada
+// estágio para ao chegar ao alvo (GA_STOP_TARGET) ou nos critérios de parada
+// de sempre, e o JSON guarda tempo, avaliações e gerações até lá, o melhor
+// resultado em unidades físicas, as alocações do motor e o pico de memória.
+// As chaves e a ordem delas são fixas (versão em BENCH_SCHEMA_VERSION), para
+// dar para comparar arquivos de commits e variantes do motor com um diff.
+
+#define BENCH_SCHEMA_VERSION 1
+
+/** @brief Alvos do benchmark em unidades físicas. */
+typedef struct {
+    double potencia_w; // Fase 1: potência líquida ao meio-dia (fitness direto)
+    double prova_h;    // Fase 2: tempo da prova de 3000 km, com as noites (h)
+    double alcance_km; // Fase 3: alcance de um dia terminando com >= 30% de bateria
+} BenchTargets;
+
+/** @brief Um estágio de uma rodada do benchmark. */
+typedef struct {
+    double alvo_fitness;
+    GaRunStats stats;
+    int atingido;
+    double melhor_fitness;
+    double metrica;      // Potência (W), tempo de prova (h) ou alcance (km) do melhor; NAN se não fechou a prova
+    long long alocacoes; // Alocações do motor (GaProfile)
+    long pico_rss_kb;    // Pico de memória residente do processo ao fim do estágio
+} BenchStage;
+
+typedef struct {
+    unsigned long long semente;
+    BenchStage fase[3];
+    double tempo_total_s;
+} BenchRun;
+
+static double bench_wall_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/** @brief Pico de memória residente do processo até agora (kB; 0 se indisponível). */
+static long peak_rss_kb() {
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+    return uso.ru_maxrss; // Linux: kB
+}
+
+/** @brief Roda um estágio até o alvo (sem log, checkpoint nem telemetria). */
+static Individual bench_stage(GAConfig cfg, double alvo, FitnessFunc f, FitnessBatchFunc fb, FitnessDeviceFunc fd,
+                              const void* param, BenchStage* out) {
+    cfg.stop.target_enabled = 1;
+    cfg.stop.target_fitness = alvo;
+    cfg.verbose = 0;
+    cfg.telemetry_phase = 0;
+    cfg.log = NULL;
+    cfg.checkpoint_path = NULL;
+    cfg.checkpoint_every = 0;
+    cfg.on_generation = NULL;
+    StageJob job = {ga_context_create(&cfg, &GA_ISLANDS), f, fb, fd, param, NULL};
+    run_stage(&job);
+    out->alvo_fitness = alvo;
+    out->stats = *ga_context_stats(job.ctx);
+    out->alocacoes = ga_context_profile(job.ctx)->allocations;
+    ga_context_free(job.ctx);
+    out->atingido = (out->stats.stop_reason == GA_STOP_TARGET);
+    out->melhor_fitness = job.best.genes ? f(job.best, param) : NAN;
+    out->metrica = NAN;
+    out->pico_rss_kb = peak_rss_kb();
+    return job.best;
+}
+
+/** @brief Uma rodada completa (Estágios 1, 2 e 3) da semente 'semente'. @return 0 se terminou. */
+static int bench_run(const GAConfig* cfg_forma, const GAConfig* cfg_estrategia, const BenchTargets* alvos,
+                     unsigned long long semente, BenchRun* run) {
+    double t0 = bench_wall_seconds();
+    run->semente = semente;
+
+    GAConfig c1 = *cfg_forma;
+    c1.seed = semente + 1; // Mesmas sementes derivadas da execução normal com --seed
+    double ref_speed_ms = 22.0;
+    Individual forma = bench_stage(c1, alvos->potencia_w, fitness_shape_wrapper, fitness_shape_batch,
+                                   fitness_shape_device, &ref_speed_ms, &run->fase[0]);
+    if (forma.genes == NULL) return -1;
+    run->fase[0].metrica = run->fase[0].melhor_fitness;
+    CarDesignOutrigger car = car_from_shape(forma.genes);
+    free(forma.genes);
+
+    RaceContext race_ctx;
+    race_context_init(&race_ctx, &car);
+
+    GAConfig c2 = *cfg_estrategia;
+    c2.seed = semente + 2;
+    Individual longa = bench_stage(c2, 3000.0 + 1000.0 / alvos->prova_h, fitness_strategy_wrapper, fitness_strategy_batch,
+                                   fitness_strategy_device, &race_ctx, &run->fase[1]);
+    if (longa.genes == NULL) return -1;
+    RaceState prova = race_simulate(&race_ctx, longa.genes, 3000.0, RACE_MAX_DIAS, NULL);
+    if (prova.dist_km >= 3000.0) run->fase[1].metrica = prova.tempo_h;
+    free(longa.genes);
+
+    // Fitness da Fase 3 = distância - penalidade da bateria que sobra acima de
+    // 30%: chegar ao alvo em fitness garante o alcance com a restrição cumprida
+    GAConfig c3 = *cfg_estrategia;
+    c3.seed = semente + 3;
+    Individual diaria = bench_stage(c3, alvos->alcance_km, fitness_strategy_daily_wrapper, fitness_strategy_daily_batch,
+                                    fitness_strategy_daily_device, &race_ctx, &run->fase[2]);
+    if (diaria.genes == NULL) return -1;
+    run->fase[2].metrica = race_simulate(&race_ctx, diaria.genes, INFINITY, 1, NULL).dist_km;
+    free(diaria.genes);
+
+    run->tempo_total_s = bench_wall_seconds() - t0;
+    return 0;
+}
+
+static int compare_doubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/** @brief Número JSON ("null" para NAN: estágio que não chegou ao alvo, prova não concluída). */
+static void json_number(FILE* f, double x) {
+    if (isnan(x)) fprintf(f, "null");
+    else fprintf(f, "%.10g", x);
+}
+
+/** @brief Tempo em segundos no JSON (microssegundos; "null" para NAN). */
+static void json_seconds(FILE* f, double x) {
+    if (isnan(x)) fprintf(f, "null");
+    else fprintf(f, "%.6f", x);
+}
+
+static void json_stage(FILE* f, int fase, const BenchStage* e) {
+    const GaRunStats* s = &e->stats;
+    fprintf(f, "        {\"fase\": %d, \"alvo_fitness\": ", fase);
+    json_number(f, e->alvo_fitness);
+    fprintf(f, ", \"atingido\": %s, \"tempo_ate_alvo_s\": ", e->atingido ? "true" : "false");
+    json_seconds(f, e->atingido ? s->seconds : NAN);
+    fprintf(f, ", \"avaliacoes_ate_alvo\": ");
+    json_number(f, e->atingido ? (double)s->evaluations : NAN);
+    fprintf(f, ", \"geracoes_ate_alvo\": ");
+    json_number(f, e->atingido ? (double)s->generations : NAN);
+    fprintf(f, ", \"tempo_s\": %.6f, \"avaliacoes\": %lld, \"geracoes\": %d, \"parada\": \"%s\", \"melhor_fitness\": ",
+            s->seconds, s->evaluations, s->generations, ga_stop_reason_name(s->stop_reason));
+    json_number(f, e->melhor_fitness);
+    fprintf(f, ", \"metrica\": ");
+    json_number(f, e->metrica);
+    fprintf(f, ", \"alocacoes\": %lld, \"pico_rss_kb\": %ld}", e->alocacoes, e->pico_rss_kb);
+}
+
+static int write_bench_json(const char* path, const GAConfig* cfg, const BenchTargets* alvos,
+                            const BenchRun* runs, int n_runs) {
+    FILE* f = fopen(path, "w");
+    if (f == NULL) return -1;
+    static const char* METRICAS[3] = {"potencia_liquida_w", "tempo_prova_h", "alcance_km"};
+    long long alocacoes = 0;
+    for (int r = 0; r < n_runs; r++)
+        for (int e = 0; e < 3; e++) alocacoes += runs[r].fase[e].alocacoes;
+
+    fprintf(f, "{\n  \"esquema\": \"projetosolar-tempo-ate-alvo\",\n  \"versao\": %d,\n", BENCH_SCHEMA_VERSION);
+    fprintf(f, "  \"configuracao\": {\"populacao\": %d, \"threads\": %d, \"estrategia\": \"%s\", \"layout\": \"%s\", "
+               "\"reproducao_paralela\": %s, \"ilhas\": %d, \"processos_mpi\": %d, \"dispositivo\": %d, "
+               "\"estagnacao\": %d, \"min_resets\": %d, \"max_segundos\": %g, \"max_avaliacoes\": %lld, "
+               "\"fast_aero\": %s, \"fisica_tabelada\": %s},\n",
+            cfg->population_size, ga_available_threads(), ga_strategy_name(cfg->strategy),
+            cfg->layout == GA_LAYOUT_SOA ? "soa" : "aos", cfg->parallel_breeding ? "true" : "false",
+            GA_ISLANDS.n_islands, ga_mpi_size(), GA_DEVICE, cfg->stop.stagnation_gens, cfg->stop.min_resets,
+            cfg->stop.max_seconds, cfg->stop.max_evaluations, PHYSICS_FAST_AERO ? "true" : "false",
+            PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA ? "true" : "false");
+    fprintf(f, "  \"alvos\": {\"fase1_potencia_liquida_w\": ");
+    json_number(f, alvos->potencia_w);
+    fprintf(f, ", \"fase2_tempo_prova_h\": ");
+    json_number(f, alvos->prova_h);
+    fprintf(f, ", \"fase3_alcance_km\": ");
+    json_number(f, alvos->alcance_km);
+    fprintf(f, "},\n  \"metricas\": [\"%s\", \"%s\", \"%s\"],\n", METRICAS[0], METRICAS[1], METRICAS[2]);
+
+    fprintf(f, "  \"execucoes\": [\n");
+    for (int r = 0; r < n_runs; r++) {
+        fprintf(f, "    {\"semente\": %llu, \"tempo_total_s\": %.6f, \"fases\": [\n", runs[r].semente, runs[r].tempo_total_s);
+        for (int e = 0; e < 3; e++) {
+            json_stage(f, e + 1, &runs[r].fase[e]);
+            fprintf(f, "%s\n", e < 2 ? "," : "");
+        }
+        fprintf(f, "    ]}%s\n", r < n_runs - 1 ? "," : "");
+    }
+    fprintf(f, "  ],\n");
+
+    // Resumo por estágio: medianas sobre as rodadas que chegaram ao alvo
+    double* tempos = (double*)malloc(sizeof(double) * (n_runs > 0 ? n_runs : 1));
+    double* avals = (double*)malloc(sizeof(double) * (n_runs > 0 ? n_runs : 1));
+    fprintf(f, "  \"resumo\": [\n");
+    for (int e = 0; e < 3; e++) {
+        int m = 0;
+        for (int r = 0; r < n_runs; r++) {
+            if (!runs[r].fase[e].atingido) continue;
+            tempos[m] = runs[r].fase[e].stats.seconds;
+            avals[m] = (double)runs[r].fase[e].stats.evaluations;
+            m++;
+        }
+        qsort(tempos, m, sizeof(double), compare_doubles);
+        qsort(avals, m, sizeof(double), compare_doubles);
+        double med_t = NAN, med_a = NAN, max_t = NAN;
+        if (m > 0) {
+            med_t = (m % 2) ? tempos[m / 2] : 0.5 * (tempos[m / 2 - 1] + tempos[m / 2]);
+            med_a = (m % 2) ? avals[m / 2] : 0.5 * (avals[m / 2 - 1] + avals[m / 2]);
+            max_t = tempos[m - 1];
+        }
+        fprintf(f, "    {\"fase\": %d, \"execucoes\": %d, \"atingidos\": %d, \"tempo_ate_alvo_mediano_s\": ", e + 1, n_runs, m);
+        json_seconds(f, med_t);
+        fprintf(f, ", \"avaliacoes_ate_alvo_medianas\": ");
+        json_number(f, med_a);
+        fprintf(f, ", \"tempo_ate_alvo_max_s\": ");
+        json_seconds(f, max_t);
+        fprintf(f, "}%s\n", e < 2 ? "," : "");
+    }
+    free(tempos);
+    free(avals);
+    fprintf(f, "  ],\n  \"alocacoes_total\": %lld,\n  \"pico_rss_kb\": %ld\n}\n", alocacoes, peak_rss_kb());
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief O modo --benchmark: N sementes fixas (1..N), um resumo por estágio no
+ * terminal e o JSON em 'path' (gravado só pelo processo 0).
  */
+static int run_benchmark(const char* path, int n_sementes, const BenchTargets* alvos,
+                         const GAConfig* cfg_forma, const GAConfig* cfg_estrategia) {
+    if (n_sementes < 1) n_sementes = 1;
+    BenchRun* runs = (BenchRun*)calloc(n_sementes, sizeof(BenchRun));
+    if (runs == NULL) return 1;
+    static const char* NOMES[3] = {"potencia liquida", "tempo de prova", "alcance diario"};
+    static const char* UNIDADES[3] = {"W", "h", "km"};
+    int erro = 0;
+    for (int r = 0; r < n_sementes && !erro; r++) {
+        if (bench_run(cfg_forma, cfg_estrategia, alvos, (unsigned long long)(r + 1), &runs[r]) != 0) {
+            printf("ERRO: o estagio nao rodou (ver AVISO acima)\n");
+            erro = 1;
+            break;
+        }
+        for (int e = 0; e < 3; e++) {
+            const BenchStage* b = &runs[r].fase[e];
+            printf(" [Bench] Semente %d, fase %d: %s (%lld avaliacoes, %.2f s) | %s %.2f %s\n", r + 1, e + 1,
+                   b->atingido ? "alvo atingido" : ga_stop_reason_name(b->stats.stop_reason),
+                   b->stats.evaluations, b->stats.seconds, NOMES[e], b->metrica, UNIDADES[e]);
+        }
+        fflush(stdout);
+    }
+    if (!erro && ga_mpi_rank() == 0) {
+        if (write_bench_json(path, cfg_forma, alvos, runs, n_sementes) != 0) {
+            printf("ERRO: nao foi possivel gravar %s\n", path);
+            erro = 1;
+        } else {
+            printf(">>> Benchmark gravado em %s (pico de memoria %ld kB)\n", path, peak_rss_kb());
+        }
+    }
+    free(runs);
+    return erro;
+}
+
+int main(int argc, char** argv) {
+#ifdef GA_USE_MPI
+    // As chamadas MPI do AG partem sempre da thread principal (ver ga_context_run)
+    int mpi_nivel;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_nivel);
+#endif
+    // Só o processo 0 fala no terminal; os outros só contribuem com as suas ilhas
+    int processo_raiz = (ga_mpi_rank() == 0);
+    if (!processo_raiz && freopen("/dev/null", "w", stdout) == NULL) return 1;
 
-int main() {
     // Alocação de estrutura auxiliar para uso posterior
     Individual final_strategy_3000km; 
     final_strategy_3000km.genes = (double*)malloc(sizeof(double) * 9);
 
-    // 1. Inicialização do Gerador de Números Aleatórios (Semente Temporal)
-    srand(time(NULL));
+    // --make-route ARQ: grava uma rota sintética (3000 km plana, clima de
+    // get_solar_data minuto a minuto por RACE_MAX_DIAS dias) e sai. Serve de
+    // modelo do formato e, simulada, reproduz o simulador hora a hora.
+    const char* nova_rota = parse_string_option(argc, argv, "--make-route", NULL);
+    if (nova_rota) {
+        int erro = !processo_raiz ? 0 : route_write_synthetic(nova_rota, 3000.0, 100.0, 60.0, RACE_MAX_DIAS);
+        if (processo_raiz) printf("%s %s\n", erro ? "ERRO ao gravar" : "Rota sintetica gravada em", nova_rota);
+#ifdef GA_USE_MPI
+        MPI_Finalize();
+#endif
+        return erro ? 1 : 0;
+    }
+
+    // 1. Semente do Gerador de Números Aleatórios (CLI ou Temporal)
+    // Cada estágio usa uma semente derivada, mas todas vêm desta base.
+    unsigned long long seed_base = parse_seed(argc, argv);
+
+    // Checkpoint/retomada: --checkpoint-every G grava faseN.ckpt a cada G
+    // gerações; --resume continua cada estágio de onde o seu checkpoint parou
+    // (estágios concluídos não rodam de novo) e usa a semente da execução original.
+    int retomar = has_flag(argc, argv, "--resume");
+    int checkpoint_every = parse_int_option(argc, argv, "--checkpoint-every", retomar ? 1000 : 0);
+    const char* checkpoints[3] = {"fase1.ckpt", "fase2.ckpt", "fase3.ckpt"};
+    if (retomar) {
+        GaCheckpointInfo info;
+        if (ga_checkpoint_probe(checkpoints[0], &info) == 0) {
+            seed_base = info.seed - 1; // O Estágio 1 usa seed_base + 1
+        } else {
+            printf("AVISO: %s nao encontrado; comecando do zero\n", checkpoints[0]);
+            retomar = 0;
+        }
+    }
+    if (!retomar && checkpoint_every > 0)
+        for (int f = 0; f < 3; f++) ga_checkpoint_remove(checkpoints[f]);
+#ifdef GA_USE_MPI
+    MPI_Bcast(&seed_base, 1, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD); // Mesma semente em todos
+#endif
+
+    // Aerodinâmica vetorial aproximada na Fase 1 (erro relativo ~1e-15, opcional)
+    PHYSICS_FAST_AERO = has_flag(argc, argv, "--fast-aero");
+
+    // Eficiência do motor e Crr por tabela (erro ~1e-16, opcional): --physics-fidelity tabulated
+    if (strcmp(parse_string_option(argc, argv, "--physics-fidelity", "exact"), "tabulated") == 0)
+        physics_set_fidelity(PHYSICS_FIDELITY_TABELADA);
+
+    // Logs: binário sempre; CSV só como exportação (--csv). Decimação com --log-every N.
+    int exportar_csv = has_flag(argc, argv, "--csv");
+    GA_LOG_EVERY = parse_int_option(argc, argv, "--log-every", 1);
+
+    // Parada antecipada (vale para os três estágios). Nos logs de 100k gerações
+    // o melhor de cada fase muda no máximo ~1e-5 depois das primeiras ~10k
+    // gerações, então por padrão paramos após 10k gerações sem melhora, desde
+    // que o AG já tenha tentado 20 resets híbridos. --no-early-stop desliga tudo.
+    if (!has_flag(argc, argv, "--no-early-stop")) {
+        GA_STOP.stagnation_gens = parse_int_option(argc, argv, "--stagnation", 10000);
+        GA_STOP.min_resets = parse_int_option(argc, argv, "--min-resets", 20);
+        GA_STOP.diversity_floor = parse_double_option(argc, argv, "--diversity-floor", 0.0);
+        GA_STOP.max_seconds = parse_double_option(argc, argv, "--max-seconds", 0.0);
+        GA_STOP.max_evaluations = (long long)parse_double_option(argc, argv, "--max-evals", 0.0);
+    }
+
+    // Modelo de ilhas: --islands N subpopulações por processo (com MPI, em
+    // cada processo), trocando --migrants elites a cada --migration-interval
+    // gerações pela --topology ring|full. A população total continua POPULATION_SIZE.
+    GA_ISLANDS.n_islands = parse_int_option(argc, argv, "--islands", 1);
+    GA_ISLANDS.migration_interval = parse_int_option(argc, argv, "--migration-interval", 50);
+    GA_ISLANDS.n_migrants = parse_int_option(argc, argv, "--migrants", 2);
+    GA_ISLANDS.topology = strcmp(parse_string_option(argc, argv, "--topology", "ring"), "full") == 0
+                        ? GA_TOPOLOGY_FULL : GA_TOPOLOGY_RING;
+
+    // Modelo substituto (--surrogate): um k-NN sobre as avaliações já feitas
+    // escolhe quais filhos novos passam pela fitness (vale para os três estágios)
+    GA_SURROGATE.enabled = has_flag(argc, argv, "--surrogate");
+    GA_SURROGATE.archive_size = parse_int_option(argc, argv, "--surrogate-archive", GA_SURROGATE.archive_size);
+    GA_SURROGATE.k = parse_int_option(argc, argv, "--surrogate-k", GA_SURROGATE.k);
+    GA_SURROGATE.eval_fraction = parse_double_option(argc, argv, "--surrogate-eval", GA_SURROGATE.eval_fraction);
+    GA_SURROGATE.explore_fraction = parse_double_option(argc, argv, "--surrogate-explore", GA_SURROGATE.explore_fraction);
+
+    // Cache de fitness (--fitness-cache N posições, --cache-quantum Q): filhos
+    // com genes repetidos reaproveitam o fitness em vez de chamar a física de novo
+    GA_FITNESS_CACHE.entries = parse_int_option(argc, argv, "--fitness-cache", 0);
+    GA_FITNESS_CACHE.quantum = parse_double_option(argc, argv, "--cache-quantum", 0.0);
+
+    // Reprodução em blocos paralelos com sorteios sem estado (outra evolução,
+    // reprodutível pela semente com qualquer número de threads)
+    GA_PARALLEL_BREEDING = has_flag(argc, argv, "--parallel-breeding");
+
+    // Estratégia de mutação/adaptação (--strategy hibrida|fisher|por-gene)
+    const char* estrategia = parse_string_option(argc, argv, "--strategy", "hibrida");
+    if (ga_strategy_from_name(estrategia, &GA_STRATEGY) != 0) {
+        printf("ERRO: estrategia desconhecida '%s' (use hibrida, fisher ou por-gene)\n", estrategia);
+        return 1;
+    }
+    if (GA_PARALLEL_BREEDING && GA_STRATEGY == GA_STRATEGY_FISHER) {
+        printf("AVISO: --parallel-breeding ignorado com --strategy fisher (a reproducao dela e serial)\n");
+        GA_PARALLEL_BREEDING = 0;
+    }
+
+    // AG no dispositivo (--device N): população, reprodução e fitness no
+    // acelerador N (OpenMP target; num build sem offload, na CPU). Só uma
+    // população por estágio, sem triagem, cache ou checkpoints.
+    GA_DEVICE = parse_int_option(argc, argv, "--device", -1);
+    if (GA_DEVICE >= 0) {
+        if (GA_ISLANDS.n_islands > 1 || ga_mpi_size() > 1) printf("AVISO: --islands ignorado com --device\n");
+        if (GA_SURROGATE.enabled || GA_FITNESS_CACHE.entries > 0)
+            printf("AVISO: --surrogate e --fitness-cache ignorados com --device\n");
+        if (checkpoint_every > 0 || retomar) printf("AVISO: checkpoints desligados com --device\n");
+        if (GA_STRATEGY != GA_STRATEGY_HIBRIDA) printf("AVISO: --strategy %s ignorado com --device\n", estrategia);
+        GA_STRATEGY = GA_STRATEGY_HIBRIDA;
+        GA_ISLANDS.n_islands = 1;
+        GA_SURROGATE.enabled = 0;
+        GA_FITNESS_CACHE.entries = 0;
+        checkpoint_every = 0;
+        retomar = 0;
+    }
+
+    // Benchmark de tempo até a solução (--benchmark ARQ.json): sementes fixas
+    // 1..--bench-seeds N, os três estágios em série, cada um até o seu alvo
+    // (--target-power W, --target-race-hours H, --target-range-km KM) ou até os
+    // critérios de parada de sempre. Valem as opções do motor (--strategy, --islands...).
+    const char* arquivo_benchmark = parse_string_option(argc, argv, "--benchmark", NULL);
+    int bench_sementes = parse_int_option(argc, argv, "--bench-seeds", 5);
+    BenchTargets alvos;
+    alvos.potencia_w = parse_double_option(argc, argv, "--target-power", -129.35);
+    alvos.prova_h = parse_double_option(argc, argv, "--target-race-hours", 121.0);
+    alvos.alcance_km = parse_double_option(argc, argv, "--target-range-km", 664.99);
+    if (arquivo_benchmark && (checkpoint_every > 0 || retomar)) {
+        printf("AVISO: checkpoints desligados com --benchmark\n");
+        checkpoint_every = 0;
+        retomar = 0;
+    }
+
+    // Pipeline: --top-k K designs distintos do Estágio 1 passam pelos Estágios 2
+    // e 3 em --pipeline-workers threads, e vence o mais rápido nos 3000 km.
+    // Com MPI fica desligado (as ilhas de cada candidato usariam o mesmo comunicador).
+    int top_k = parse_int_option(argc, argv, "--top-k", 1);
+    if (top_k > 1 && arquivo_benchmark) {
+        printf("AVISO: --top-k ignorado com --benchmark\n");
+        top_k = 1;
+    }
+    if (top_k > 1 && ga_mpi_size() > 1) {
+        printf("AVISO: --top-k ignorado com MPI\n");
+        top_k = 1;
+    }
+    if (top_k > 1 && (checkpoint_every > 0 || retomar)) {
+        // O hall da fama do pipeline não entra no checkpoint
+        printf("AVISO: checkpoints desligados com --top-k\n");
+        checkpoint_every = 0;
+        retomar = 0;
+    }
+
+    // Rota com passo fino (--route ARQ, passo --route-dt S, padrão 60 s): o
+    // Estágio 2 passa a correr na rota. O Estágio 3 (alcance de um dia) continua hora a hora.
+    Route rota;
+    const char* arquivo_rota = parse_string_option(argc, argv, "--route", NULL);
+    double rota_dt = parse_double_option(argc, argv, "--route-dt", 60.0);
+    if (arquivo_rota && arquivo_benchmark) {
+        printf("AVISO: --route ignorado com --benchmark\n");
+        arquivo_rota = NULL;
+    }
+    if (arquivo_rota && top_k > 1) {
+        printf("AVISO: --route ignorado com --top-k\n");
+        arquivo_rota = NULL;
+    }
+    if (arquivo_rota && route_open(&rota, arquivo_rota) != 0) return 1;
+
+    // Telemetria ao vivo (UDP) para 'python3 dashboard.py --follow'
+    int telemetria = has_flag(argc, argv, "--telemetry") && processo_raiz;
+    int porta_telemetria = parse_int_option(argc, argv, "--telemetry-port", TELEMETRY_DEFAULT_PORT);
+    if (telemetria && telemetry_start(NULL, porta_telemetria) != 0) {
+        printf("AVISO: Nao foi possivel iniciar a telemetria na porta %d\n", porta_telemetria);
+        telemetria = 0;
+    }
 
     printf("====================================================\n");
     printf(" PROJETO SOLAR - SUPER OTIMIZADOR MODULAR (v7.3 Dashboard)\n");
-    printf(" Integração: GA Engine + Physics + Reports + CSV Logs\n");
+    printf(" Integração: GA Engine + Physics + Reports + Logs (.galog%s)\n", exportar_csv ? " + CSV" : "");
+    printf(" Semente: %llu (repita com --seed %llu)\n", seed_base, seed_base);
+    if (PHYSICS_FAST_AERO) printf(" Aerodinamica vetorial: %s\n", physics_simd_backend());
+    if (PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA) {
+        double crr_err;
+        double eta_err = physics_tables_max_rel_error(2001, &crr_err);
+        printf(" Motor/Crr tabelados: erro rel. max. eta = %.1e | Crr = %.1e\n", eta_err, crr_err);
+    }
+    if (GA_ISLANDS.n_islands > 1 || ga_mpi_size() > 1)
+        printf(" Ilhas: %d por processo x %d processo(s), topologia %s\n",
+               GA_ISLANDS.n_islands, ga_mpi_size(), ga_topology_name(GA_ISLANDS.topology));
+    if (GA_PARALLEL_BREEDING && GA_DEVICE < 0) printf(" Reproducao em blocos paralelos (sorteios sem estado)\n");
+    if (GA_STRATEGY != GA_STRATEGY_HIBRIDA) printf(" Estrategia de mutacao: %s\n", ga_strategy_name(GA_STRATEGY));
+    if (telemetria) printf(" Telemetria ao vivo: udp://127.0.0.1:%d\n", porta_telemetria);
+    if (GA_DEVICE >= 0)
+        printf(" AG no dispositivo %d: %s (%d acelerador(es) visivel(is))%s\n", GA_DEVICE,
+               ga_device_name(ga_device_resolve(GA_DEVICE)), ga_device_count(),
+               arquivo_rota ? "; o Estagio 2 na rota fica na CPU" : "");
+    if (arquivo_benchmark)
+        printf(" Benchmark tempo-ate-alvo: sementes 1-%d -> %s\n", bench_sementes > 1 ? bench_sementes : 1, arquivo_benchmark);
     printf("====================================================\n\n");
 
     // ==================================================================
@@ -36,14 +640,12 @@ int main() {
     // Objetivo: Achar L, W, H, Pods e Área Solar que maximizem a sobra de energia.
     printf("### ESTAGIO 1: Otimizando Geometria do Carro (Item 19, 21) ###\n");
 
-    // --- SETUP DE LOG (Dashboard) ---
-    // Abre o arquivo para gravar a evolução frame a frame
-    ga_csv_file = fopen("fase1.csv", "w");
-    if (ga_csv_file == NULL) printf("AVISO: Nao foi possivel criar fase1.csv\n");
+    telemetry_set_phase(1);
     
     // --- CONFIGURAÇÃO DO AG (Geometria) ---
-    POPULATION_SIZE = 1000;      // População grande para explorar bem o espaço 3D
-    MAX_GENERATIONS = 100000;    // Gerações altas (critério de parada por estagnação ativa no engine)
+    POPULATION_SIZE = parse_int_option(argc, argv, "--population", 1000); // População grande para explorar bem o espaço 3D
+    NUM_THREADS = 0;             // 0 = usa todos os núcleos disponíveis na avaliação
+    MAX_GENERATIONS = 100000;    // Teto de gerações (a parada por estagnação costuma encerrar antes, ver GA_STOP)
     
     NUM_DIMENSIONS = 7; // 7 Genes: [L_casco, W_casco, H_casco, L_pod, D_pod, A_solar, W_sep]
     GENE_MIN_VALUE = (double*)malloc(NUM_DIMENSIONS * sizeof(double));
@@ -56,28 +658,120 @@ int main() {
     memcpy(GENE_MIN_VALUE, min_shape, NUM_DIMENSIONS * sizeof(double));
     memcpy(GENE_MAX_VALUE, max_shape, NUM_DIMENSIONS * sizeof(double));
 
+    GA_SEED = seed_base + 1;
+    GAConfig cfg_forma = ga_config_from_globals();
+
+    // --- CONFIGURAÇÃO BASE DOS ESTÁGIOS 2 E 3 (Estratégia) ---
+    // Agora o problema muda: genes não são mais metros, são m/s (velocidade).
+    // 9 Genes: Velocidade média para cada hora do dia (08h às 16h)
+    double v_min[9], v_max[9];
+    for (int i = 0; i < 9; i++) {
+        v_min[i] = 15.0; // ~54 km/h (Mínimo tático)
+        v_max[i] = 25.0; // ~90 km/h (Máximo seguro)
+    }
+    GAConfig cfg_estrategia = cfg_forma;
+    cfg_estrategia.num_dimensions = 9;
+    cfg_estrategia.gene_min = v_min;
+    cfg_estrategia.gene_max = v_max;
+    cfg_estrategia.log = NULL;
+    cfg_estrategia.checkpoint_path = NULL;
+
+    // Definição da fitness de cada estágio, gravada nos checkpoints: um --resume
+    // com outra física ou outra rota recomeça o estágio em vez de misturar fitness
+    char fitness_fisica[32], fitness_forma[64], fitness_rota[384];
+    snprintf(fitness_fisica, sizeof(fitness_fisica), "fidelidade=%s",
+             PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA ? "tabelada" : "exata");
+    snprintf(fitness_forma, sizeof(fitness_forma), "%s fast_aero=%d", fitness_fisica, PHYSICS_FAST_AERO);
+    snprintf(fitness_rota, sizeof(fitness_rota), "%s rota=%s dt=%.17g", fitness_fisica,
+             arquivo_rota ? arquivo_rota : "", rota_dt);
+    cfg_forma.fitness_id = fitness_forma;
+    cfg_estrategia.fitness_id = fitness_fisica;
+
+    if (arquivo_benchmark) {
+        int erro = run_benchmark(arquivo_benchmark, bench_sementes, &alvos, &cfg_forma, &cfg_estrategia);
+        telemetry_stop();
+        free(final_strategy_3000km.genes);
+        free(GENE_MIN_VALUE);
+        free(GENE_MAX_VALUE);
+#ifdef GA_USE_MPI
+        MPI_Finalize();
+#endif
+        return erro;
+    }
+
+    // --- PIPELINE (opcional) ---
+    // As threads consumidoras começam os Estágios 2 e 3 dos primeiros designs
+    // estáveis enquanto o Estágio 1 ainda está evoluindo.
+    Pipeline* pipeline = NULL;
+    if (top_k > 1) {
+        PipelineConfig pc;
+        pc.top_k = top_k;
+        pc.workers = parse_int_option(argc, argv, "--pipeline-workers", 2);
+        pc.stable_gens = parse_int_option(argc, argv, "--pipeline-stable", 1000);
+        pc.min_distance = parse_double_option(argc, argv, "--pipeline-distance", 0.01);
+        pc.shape_min = min_shape;
+        pc.shape_max = max_shape;
+        pc.strategy = cfg_estrategia;
+        int por_thread = ga_available_threads() / (pc.workers > 0 ? pc.workers : 1);
+        pc.strategy.num_threads = (por_thread > 0) ? por_thread : 1;
+        pc.seed_longa = seed_base + 2;
+        pc.seed_diaria = seed_base + 3;
+        pipeline = pipeline_start(&pc);
+        cfg_forma.on_generation = pipeline_observe;
+        cfg_forma.hook_param = pipeline;
+        printf(" Pipeline: top-%d designs, %d thread(s) consumidora(s)\n", pc.top_k, pc.workers);
+    }
+
     // EXECUÇÃO DO AG (Fase 1)
     // Passamos uma velocidade de referência fixa (22 m/s) para otimizar a forma
+    // O log (ou a retomada do checkpoint) grava a evolução frame a frame para o Dashboard
     double ref_speed_ms = 22.0; 
-    Individual best_shape_ind = run_ga_cycle(fitness_shape_wrapper, &ref_speed_ms, 1);
-
-    // Finalização do Log Fase 1
-    if (ga_csv_file) { fclose(ga_csv_file); ga_csv_file = NULL; }
+    StageJob estagio1 = {NULL, fitness_shape_wrapper, fitness_shape_batch, fitness_shape_device, &ref_speed_ms, NULL};
+    estagio1.ctx = create_stage("fase1", checkpoints[0], cfg_forma, exportar_csv, retomar, checkpoint_every, &estagio1.log);
+    run_stage(&estagio1); // Também fecha o log da Fase 1
+    Individual best_shape_ind = estagio1.best;
+    ga_context_free(estagio1.ctx);
 
     // --- CONSOLIDAÇÃO DO DESIGN ---
     // Transformamos os genes abstratos (array) em uma struct física utilizável
-    CarDesignOutrigger car;
-    car.L_casco = best_shape_ind.genes[0];
-    car.W_casco = best_shape_ind.genes[1];
-    car.H_casco = best_shape_ind.genes[2];
-    car.L_pod   = best_shape_ind.genes[3];
-    car.D_pod   = best_shape_ind.genes[4];
-    car.A_solar = best_shape_ind.genes[5];
-    car.W_sep   = best_shape_ind.genes[6];
-    
+    CarDesignOutrigger car = car_from_shape(best_shape_ind.genes);
+
     free(best_shape_ind.genes); // Limpa memória do indivíduo temporário
+
+    // Com pipeline, o carro é o candidato mais rápido nos 3000 km (que pode não
+    // ser o melhor do Estágio 1), e as suas estratégias já estão prontas
+    const PipelineCandidate* vencedor = NULL;
+    if (pipeline) {
+        printf(" [Pipeline] Estagio 1 encerrado, aguardando os candidatos na fila...\n");
+        pipeline_finish(pipeline);
+        pipeline_print_ranking(pipeline);
+        vencedor = pipeline_best(pipeline);
+        if (vencedor) {
+            car = vencedor->car;
+            printf(">>> Vencedor do pipeline: candidato %d\n", vencedor->id);
+        }
+    }
     printf(">>> Design Otimizado: Casco=%.2fm, Pod=%.2fm, Solar=%.2fm2\n\n", car.L_casco, car.D_pod, car.A_solar);
 
+    // Ambiente hora a hora do carro fixo: calculado uma vez e compartilhado por
+    // todas as avaliações de fitness dos Estágios 2 e 3
+    RaceContext race_ctx;
+    race_context_init(&race_ctx, &car);
+    {
+        double M_err;
+        double CdA_err = car_aero_max_rel_error(&race_ctx.aero, &car, 15.0, 25.0, 2001, &M_err);
+        printf(">>> Memoria aerodinamica: erro rel. max. CdA = %.1e | erro massa = %.1e kg\n", CdA_err, M_err);
+        int divergentes = race_simulate_check(&race_ctx, 15.0, 25.0, 1000);
+        printf(">>> Simulador de prova: %d de 1000 perfis divergem do laco hora a hora\n\n", divergentes);
+    }
+    RouteContext rota_ctx;
+    if (arquivo_rota) {
+        if (route_context_init(&rota_ctx, &race_ctx, &rota, rota_dt) != 0) return 1;
+        route_close(&rota); // O contexto já tem tudo o que a fitness usa
+        printf(">>> Rota %s: %.0f km em %d trechos, %d dia(s) de clima, passo de %g s\n\n",
+               arquivo_rota, rota_ctx.comprimento_km, rota_ctx.n_trechos, rota_ctx.n_dias, rota_ctx.dt_s);
+    }
+
 
     // ==================================================================
     // === ESTÁGIO 2: OTIMIZAR ESTRATÉGIA (Corrida Completa 3000 km) ===
@@ -85,37 +779,55 @@ int main() {
     // Objetivo: Usando o CARRO FIXO do Estágio 1, achar as melhores velocidades horárias.
     printf("### ESTAGIO 2: Otimizando Estrategia para 3000km (Item 31) ###\n");
 
-    // --- SETUP DE LOG (Dashboard) ---
-    ga_csv_file = fopen("fase2.csv", "w");
-    if (ga_csv_file == NULL) printf("AVISO: Nao foi possivel criar fase2.csv\n");
-
-    // --- RECONFIGURAÇÃO DO AG (Estratégia) ---
-    // Agora o problema mudou: genes não são mais metros, são m/s (velocidade)
-    POPULATION_SIZE = 1000;  
-    MAX_GENERATIONS = 100000;   
-    
-    free(GENE_MIN_VALUE);
-    free(GENE_MAX_VALUE);
-    NUM_DIMENSIONS = 9; // 9 Genes: Velocidade média para cada hora do dia (08h às 16h)
-    GENE_MIN_VALUE = (double*)malloc(NUM_DIMENSIONS * sizeof(double));
-    GENE_MAX_VALUE = (double*)malloc(NUM_DIMENSIONS * sizeof(double));
-    
-    // Define limites de velocidade permitidos (entre 15 m/s e 25 m/s)
-    for(int i=0; i<NUM_DIMENSIONS; i++) {
-        GENE_MIN_VALUE[i] = 15.0; // ~54 km/h (Mínimo tático)
-        GENE_MAX_VALUE[i] = 25.0; // ~90 km/h (Máximo seguro)
-    }
+    // --- CONTEXTOS DOS ESTÁGIOS 2 E 3 ---
+    // Os dois estágios só dependem do carro (race_ctx, somente leitura): cada um
+    // ganha o seu GAContext e, por padrão, rodam ao mesmo tempo com metade dos
+    // núcleos cada. --serial-stages volta a rodar um depois do outro. Com MPI são
+    // sempre em série (as ilhas dos dois usariam o mesmo comunicador).
+    StageJob estagio2 = {NULL}, estagio3 = {NULL};
+    pthread_t thread_estagio3;
+    int estagio3_em_paralelo = 0;
+    Individual best_strat_3000;
+    if (vencedor) {
+        printf(" (Estrategia do candidato %d, ja otimizada pelo pipeline)\n", vencedor->id);
+        best_strat_3000 = copy_strategy(&vencedor->estrategia_3000);
+    } else {
+        int estagios_paralelos = !has_flag(argc, argv, "--serial-stages") && ga_mpi_size() == 1;
+        GAConfig cfg_longa = cfg_estrategia;
+        cfg_longa.seed = seed_base + 2;
+        cfg_longa.telemetry_phase = 2;
+        if (arquivo_rota) cfg_longa.fitness_id = fitness_rota;
+        GAConfig cfg_diaria = cfg_estrategia; // Mesmos limites de velocidade, outra fitness
+        cfg_diaria.seed = seed_base + 3;
+        cfg_diaria.telemetry_phase = 3;
+        if (estagios_paralelos) {
+            int metade = ga_available_threads() / 2;
+            cfg_longa.num_threads = cfg_diaria.num_threads = (metade > 0) ? metade : 1;
+            cfg_longa.verbose = cfg_diaria.verbose = 0; // Progresso intercalado não se lê
+        }
 
-    // EXECUÇÃO DO AG (Fase 2)
-    // Passamos a struct 'car' como parâmetro, para a física calcular o arrasto correto
-    Individual best_strat_3000 = run_ga_cycle(fitness_strategy_wrapper, &car, 0);
+        // --- SETUP DE LOG (Dashboard) E CHECKPOINTS ---
+        estagio2 = arquivo_rota
+                 ? (StageJob){NULL, fitness_strategy_route_wrapper, fitness_strategy_route_batch, NULL, &rota_ctx, NULL}
+                 : (StageJob){NULL, fitness_strategy_wrapper, fitness_strategy_batch, fitness_strategy_device, &race_ctx, NULL};
+        estagio3 = (StageJob){NULL, fitness_strategy_daily_wrapper, fitness_strategy_daily_batch,
+                              fitness_strategy_daily_device, &race_ctx, NULL};
+        estagio2.ctx = create_stage("fase2", checkpoints[1], cfg_longa, exportar_csv, retomar, checkpoint_every, &estagio2.log);
+        estagio3.ctx = create_stage("fase3", checkpoints[2], cfg_diaria, exportar_csv, retomar, checkpoint_every, &estagio3.log);
 
-    // Finalização do Log Fase 2
-    if (ga_csv_file) { fclose(ga_csv_file); ga_csv_file = NULL; }
+        // EXECUÇÃO DO AG (Fase 2; a Fase 3 numa thread própria, se em paralelo)
+        // Passamos o contexto de corrida (carro + ambiente pré-calculado) como parâmetro
+        estagio3_em_paralelo = estagios_paralelos && pthread_create(&thread_estagio3, NULL, run_stage, &estagio3) == 0;
+        if (estagio3_em_paralelo) printf(" (Estagio 3 rodando em paralelo, %d thread(s) por estagio)\n", cfg_longa.num_threads);
+        run_stage(&estagio2);
+        if (estagio3_em_paralelo) print_stage_stats(estagio2.ctx);
+        best_strat_3000 = estagio2.best;
+    }
 
     // --- CÁLCULOS FINAIS PARA RELATÓRIO ---
-    // O AG nos dá os genes, mas precisamos recalcular a física detalhada (Massa, Cd, CdA)
-    // para imprimir no relatório final.
+    // O AG nos dá os genes, mas precisamos da física detalhada (Massa, Cd, CdA)
+    // para imprimir no relatório final. Usamos a mesma memória aerodinâmica
+    // (race_ctx.aero) que a fitness usou, garantindo os mesmos números.
     double M_total_final, Cd_final, CdA_total_final, A_frontal_final;
     {
         // 1. Calcula velocidade média da estratégia vencedora
@@ -123,30 +835,21 @@ int main() {
         for(int i=0; i<9; i++) avg_speed_ms += best_strat_3000.genes[i];
         avg_speed_ms = fmax(avg_speed_ms / 9.0, 1.0);
         
-        // 2. Recalcula Aerodinâmica com base nessa velocidade (Reynolds muda!)
-        double Am_c, Am_p;
-        double CdA_c = calcular_drag_body(car.L_casco, car.W_casco, car.H_casco, avg_speed_ms, &Am_c);
-        double CdA_p = calcular_drag_body(car.L_pod, car.D_pod, car.D_pod, avg_speed_ms, &Am_p);
-        
-        // Aerodinâmica da Asa
-        double L_chord = car.A_solar / car.W_sep;
-        double Re_w = fmax(1.0, (RHO_AIR * avg_speed_ms * L_chord) / MU_AIR);
-        double frac = fmin(0.3, RE_CRIT / Re_w);
-        double Cf_w = frac * (1.328/sqrt(Re_w)) + (1-frac)*(0.074/pow(Re_w, 0.2));
-        double CdA_w = Cf_w * (2.0 * car.A_solar) * 0.5;
-        
-        // Totais Físicos
-        CdA_total_final = (CdA_c + CdA_p + CdA_w) * 1.10;
+        // 2. Aerodinâmica nessa velocidade (Reynolds muda!) e totais físicos
+        CdA_total_final = car_aero_cda(&race_ctx.aero, avg_speed_ms);
         A_frontal_final = (PI/4 * car.W_casco * car.H_casco) + (PI/4 * car.D_pod * car.D_pod);
         Cd_final = (A_frontal_final > 1e-6) ? (CdA_total_final / A_frontal_final) : 0.0;
-        
-        // Massa estimada final
-        double M_est = (RHO_CARENAGEM * (Am_c + Am_p)) + ((RHO_CHASSI + RHO_PAINEL) * car.A_solar);
-        M_total_final = M_est + FIXED_MASS + 80.0;
+        M_total_final = race_ctx.aero.M_tot;
     }
 
     // Imprime o Relatório "Master" consolidando Carro + Estratégia Longa
-    print_final_summary(&car, &best_strat_3000, M_total_final, Cd_final, CdA_total_final, A_frontal_final);
+    print_final_summary(&race_ctx, &best_strat_3000, M_total_final, Cd_final, CdA_total_final, A_frontal_final);
+    if (arquivo_rota) {
+        RaceState na_rota = route_simulate(&rota_ctx, best_strat_3000.genes, 3000.0, RACE_MAX_DIAS);
+        printf("     Na rota (%s, passo %g s): %.1f km em %.1f h (%d dia(s))\n",
+               arquivo_rota, rota_ctx.dt_s, na_rota.dist_km, na_rota.tempo_h, na_rota.dias);
+        route_context_free(&rota_ctx);
+    }
 
 
     // ==================================================================
@@ -157,70 +860,37 @@ int main() {
     printf("### ESTAGIO 3: Otimizando Estrategia para Alcance Diario (Item 28) ###\n");
     printf("====================================================\n\n");
 
-    // --- SETUP DE LOG (Dashboard) ---
-    ga_csv_file = fopen("fase3.csv", "w");
-    if (ga_csv_file == NULL) printf("AVISO: Nao foi possivel criar fase3.csv\n");
-
-    // --- CONFIGURAÇÃO DO AG ---
-    // Mantém os mesmos limites de velocidade, mas muda a função de fitness
-    MAX_GENERATIONS = 100000; 
-    
-    Individual best_strat_daily = run_ga_cycle(fitness_strategy_daily_wrapper, &car, 0);
-
-    // Finalização do Log Fase 3
-    if (ga_csv_file) { fclose(ga_csv_file); ga_csv_file = NULL; }
+    // --- EXECUÇÃO DO AG (Fase 3) ---
+    // Mantém os mesmos limites de velocidade, mas muda a função de fitness.
+    // Em paralelo, só espera a thread que começou junto com o Estágio 2.
+    Individual best_strat_daily;
+    if (vencedor) {
+        printf(" (Estrategia do candidato %d, ja otimizada pelo pipeline)\n", vencedor->id);
+        best_strat_daily = copy_strategy(&vencedor->estrategia_diaria);
+    } else {
+        if (estagio3_em_paralelo) pthread_join(thread_estagio3, NULL);
+        else run_stage(&estagio3);
+        if (estagio3_em_paralelo) print_stage_stats(estagio3.ctx);
+        best_strat_daily = estagio3.best;
+        ga_context_free(estagio2.ctx);
+        ga_context_free(estagio3.ctx);
+    }
+    pipeline_free(pipeline);
 
     // --- RE-SIMULAÇÃO DETALHADA ---
     // Como a função de fitness só retorna um número (score), precisamos re-rodar
     // a física passo-a-passo usando os genes vencedores para extrair dados 
     // específicos para os Itens 28 e 35 (Consumo em Watts e Bateria Final).
+    // O rastro de race_simulate guarda 'P_bat' e a bateria a cada hora.
     double P_dreno_horario[9] = {0};
     double distancia_final_alcance = 0;
     double bateria_final_alcance = 0;
     {
-        double* perfil_v = best_strat_daily.genes;
-        double cap_bat_wh = CAPACIDADE_BATERIA_KWH * 1000.0;
-        double bat_atual = cap_bat_wh;
-        
-        for (int hora = 0; hora < 9; hora++) {
-            // ... [Lógica de simulação idêntica à fitness_strategy_daily_wrapper] ...
-            // Recriamos o loop aqui para capturar 'P_bat' e 'bat_atual' a cada hora.
-            
-            double v_ms = perfil_v[hora];
-            double v_kmh = v_ms * 3.6;
-            SolarData sol = get_solar_data(hora);
-            double P_sol = calcular_potencia_solar(sol.irradiance, car.A_solar, sol.T_amb);
-            double P_liq = P_sol * EFF_MPPT;
-
-            if (bat_atual <= 0.01 * cap_bat_wh) {
-                 bat_atual += P_liq;
-                 if (bat_atual > cap_bat_wh) bat_atual = cap_bat_wh;
-                 P_dreno_horario[hora] = 0; // Carro parado não gasta motor
-                 continue;
-            }
-            
-            double T_asf = temperatura_asfalto(hora, sol.T_amb);
-            double P_res = calcular_potencia_resistiva(v_ms, M_total_final, CdA_total_final, T_asf);
-            double eta = EFF_MPPT * EFF_DRIVER * eficiencia_motor(P_res) * EFF_TRANS;
-            double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
-            
-            // Guarda dado para o Relatório (Item 35)
-            P_dreno_horario[hora] = P_bat;
-
-            double balanco = P_liq - P_bat;
-            
-            // Integração de distância
-            if (balanco < 0 && fabs(balanco) > bat_atual) {
-                double frac = bat_atual / fabs(balanco);
-                distancia_final_alcance += v_kmh * frac;
-                bat_atual = 0;
-            } else {
-                bat_atual += balanco;
-                if (bat_atual > cap_bat_wh) bat_atual = cap_bat_wh;
-                distancia_final_alcance += v_kmh;
-            }
-        }
-        bateria_final_alcance = bat_atual;
+        RaceTrace rastro;
+        RaceState dia = race_simulate(&race_ctx, best_strat_daily.genes, INFINITY, 1, &rastro);
+        for (int k = 0; k < rastro.n; k++) P_dreno_horario[rastro.horas[k].hora] = rastro.horas[k].P_bat;
+        distancia_final_alcance = dia.dist_km;
+        bateria_final_alcance = dia.bat_wh;
     }
 
     // --- IMPRESSÃO DOS RESULTADOS DO ESTÁGIO 3 ---
@@ -241,11 +911,17 @@ int main() {
         printf("     %02d-%02d h: %.1f W\n", i + 8, i + 9, P_dreno_horario[i]);
     }
 
+    // Encerra a telemetria (envia o que ainda estiver no anel)
+    telemetry_stop();
+
     // Liberação de Memória (Boas práticas)
     free(final_strategy_3000km.genes);
     free(best_strat_daily.genes);
     free(GENE_MIN_VALUE);
     free(GENE_MAX_VALUE);
 
+#ifdef GA_USE_MPI
+    MPI_Finalize();
+#endif
     return 0; // Fim do programa com sucesso
 }
\ No newline at end of file
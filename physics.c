@@ -1,6 +1,13 @@
 #include <math.h>
 #include <float.h>
 #include "physics.h"
+#include "rng.h"
+
+int PHYSICS_FAST_AERO = 0;
+// Lida também pelas fitness no dispositivo (ver physics_device_sync)
+GA_DEVICE_BEGIN
+PhysicsFidelity PHYSICS_FIDELITY = PHYSICS_FIDELITY_EXATA;
+GA_DEVICE_END
 
 // --- DADOS SOLARES (Irradiância W/m2 e Temp Ambiente C) ---
 SolarData get_solar_data(int hora_do_dia) {
@@ -61,6 +68,77 @@ double eficiencia_motor(double P_resist) {
     return fmin(0.95, fmax(0.70, eta_m));
 }
 
+// --- TABELAS DE EFICIÊNCIA DO MOTOR E CRR (modo tabelado) ---
+
+#define MOTOR_TAB_DP (MOTOR_TAB_PMAX / MOTOR_TAB_N)
+#define CRR_TAB_DV (CRR_TAB_VMAX / CRR_TAB_NV)
+#define CRR_TAB_DT (CRR_TAB_TMAX / CRR_TAB_NT)
+
+// 1 nó extra no fim: P = MOTOR_TAB_PMAX cai no último intervalo com t = 0
+GA_DEVICE_BEGIN
+static double motor_tab[MOTOR_TAB_N + 2];
+static double crr_tab[CRR_TAB_NT + 2][CRR_TAB_NV + 2];
+GA_DEVICE_END
+static int tabelas_prontas = 0;
+
+void physics_tables_init() {
+    if (tabelas_prontas) return;
+    for (int k = 0; k <= MOTOR_TAB_N; k++) motor_tab[k] = eficiencia_motor(k * MOTOR_TAB_DP);
+    motor_tab[MOTOR_TAB_N + 1] = motor_tab[MOTOR_TAB_N];
+    for (int a = 0; a <= CRR_TAB_NT + 1; a++)
+        for (int b = 0; b <= CRR_TAB_NV + 1; b++)
+            crr_tab[a][b] = calcular_crr_dinamico(b * CRR_TAB_DV, a * CRR_TAB_DT);
+    tabelas_prontas = 1;
+}
+
+void physics_set_fidelity(PhysicsFidelity f) {
+    if (f == PHYSICS_FIDELITY_TABELADA) physics_tables_init();
+    PHYSICS_FIDELITY = f;
+}
+
+double eficiencia_motor_tab(double P_resist) {
+    if (!(P_resist >= 0.0 && P_resist <= MOTOR_TAB_PMAX)) return eficiencia_motor(P_resist);
+    double x = P_resist * (1.0 / MOTOR_TAB_DP);
+    int i = (int)x;
+    double t = x - i;
+    return motor_tab[i] + t * (motor_tab[i + 1] - motor_tab[i]);
+}
+
+double crr_dinamico_tab(double v_kmh, double T_asfalto_C) {
+    if (!(v_kmh >= 0.0 && v_kmh <= CRR_TAB_VMAX && T_asfalto_C >= 0.0 && T_asfalto_C <= CRR_TAB_TMAX))
+        return calcular_crr_dinamico(v_kmh, T_asfalto_C);
+    double x = v_kmh * (1.0 / CRR_TAB_DV), y = T_asfalto_C * (1.0 / CRR_TAB_DT);
+    int i = (int)x, j = (int)y;
+    double tx = x - i, ty = y - j;
+    const double* r0 = crr_tab[j];
+    const double* r1 = crr_tab[j + 1];
+    double c0 = r0[i] + tx * (r0[i + 1] - r0[i]);
+    double c1 = r1[i] + tx * (r1[i + 1] - r1[i]);
+    return c0 + ty * (c1 - c0);
+}
+
+double physics_tables_max_rel_error(int amostras, double* crr_err_out) {
+    physics_tables_init();
+    int n = (amostras > 1) ? amostras : 2;
+    double max_eta = 0.0, max_crr = 0.0;
+    for (int k = 0; k < n; k++) {
+        double P = MOTOR_TAB_PMAX * k / (n - 1);
+        double ref = eficiencia_motor(P);
+        double err = fabs(eficiencia_motor_tab(P) - ref) / ref;
+        if (err > max_eta) max_eta = err;
+
+        double v = CRR_TAB_VMAX * k / (n - 1);
+        for (int a = 0; a < n; a++) {
+            double T = CRR_TAB_TMAX * a / (n - 1);
+            double c_ref = calcular_crr_dinamico(v, T);
+            double c_err = fabs(crr_dinamico_tab(v, T) - c_ref) / c_ref;
+            if (c_err > max_crr) max_crr = c_err;
+        }
+    }
+    if (crr_err_out) *crr_err_out = max_crr;
+    return max_eta;
+}
+
 // --- AERODINÂMICA (ARRASTO) ---
 double calcular_drag_body(double L, double W, double H, double v_ms, double* A_molhada_out) {
     // 1. Área Frontal (Elipse aproximada)
@@ -107,7 +185,7 @@ double calcular_potencia_resistiva(double v_ms, double M_total, double CdA_total
     double F_arrasto = 0.5 * RHO_AIR * CdA_total * pow(v_ms, 2);
     
     // Força de Rolamento
-    double Crr = calcular_crr_dinamico(v_kmh, T_amb_pneu);
+    double Crr = physics_crr(v_kmh, T_amb_pneu);
     double F_rolamento = Crr * M_total * GRAVITY;
     
     // Potência = Força Total * Velocidade
@@ -119,35 +197,30 @@ double calcular_potencia_resistiva(double v_ms, double M_total, double CdA_total
 // =============================================================================
 
 // FASE 1: OTIMIZAÇÃO DA GEOMETRIA (SHAPE)
-double fitness_shape_wrapper(Individual ind, const void* param) {
-    double simulated_velocity_ms = *(double*)param; // Velocidade de referência (ex: 22 m/s)
-    
-    // Decodifica genes
-    double L_casco = ind.genes[0];
-    double W_casco = ind.genes[1];
-    double H_casco = ind.genes[2];
-    double L_pod = ind.genes[3];
-    double D_pod = ind.genes[4];
-    double A_solar = ind.genes[5];
-    double W_sep = ind.genes[6];
-
-    // Restrições Geométricas Rígidas (Penalidade Morte Súbita)
-    if (A_solar > MAX_SOLAR_AREA) return -DBL_MAX;
-    if (fmax(L_casco, L_pod) > MAX_VEHICLE_LENGTH) return -DBL_MAX;
-    if (H_casco > MAX_VEHICLE_HEIGHT) return -DBL_MAX;
-    if (W_sep > MAX_VEHICLE_WIDTH) return -DBL_MAX;
-    if (W_casco + D_pod + MIN_COMPONENT_SEP > W_sep) return -DBL_MAX;
+// Os núcleos abaixo são comuns às versões escalar e em lote e recebem os 7 genes
+// já decodificados (ShapeGenes): [L_casco, W_casco, H_casco, L_pod, D_pod, A_solar, W_sep].
 
-    // 1. Calcula Aerodinâmica e Massa dos Componentes
-    double Am_c, Am_p;
-    double CdA_c = calcular_drag_body(L_casco, W_casco, H_casco, simulated_velocity_ms, &Am_c);
-    double CdA_p = calcular_drag_body(L_pod, D_pod, D_pod, simulated_velocity_ms, &Am_p);
-    
-    // Asa de conexão (Painel Solar)
-    double L_chord = A_solar / W_sep; // Corda média
-    double Re_w = fmax(1.0, (RHO_AIR * simulated_velocity_ms * L_chord) / MU_AIR);
-    double frac = fmin(0.3, RE_CRIT / Re_w);
-    double Cf_w = frac * (1.328/sqrt(Re_w)) + (1-frac)*(0.074/pow(Re_w, 0.2));
+// Restrições Geométricas Rígidas (Penalidade Morte Súbita)
+static int shape_is_feasible(const ShapeGenes* s) {
+    const double* g = s->g;
+    if (g[5] > MAX_SOLAR_AREA) return 0;
+    if (fmax(g[0], g[3]) > MAX_VEHICLE_LENGTH) return 0;
+    if (g[2] > MAX_VEHICLE_HEIGHT) return 0;
+    if (g[6] > MAX_VEHICLE_WIDTH) return 0;
+    if (g[1] + g[4] + MIN_COMPONENT_SEP > g[6]) return 0;
+    return 1;
+}
+
+/** Reynolds da asa de conexão (painel solar) com corda média A_solar / W_sep. */
+static double shape_wing_reynolds(const ShapeGenes* s, double v_ms) {
+    double L_chord = s->g[5] / s->g[6]; // Corda média
+    return fmax(1.0, (RHO_AIR * v_ms * L_chord) / MU_AIR);
+}
+
+/** Saldo energético a partir da aerodinâmica já calculada (casco, pod e Cf da asa). */
+static double shape_net_power(const ShapeGenes* s, double simulated_velocity_ms,
+                              double CdA_c, double Am_c, double CdA_p, double Am_p, double Cf_w) {
+    double A_solar = s->g[5];
     double CdA_w = Cf_w * (2.0 * A_solar) * 0.5; // Fator 0.5 pois é placa plana fina
 
     // Soma tudo (com fator de interferência 10%)
@@ -158,7 +231,7 @@ double fitness_shape_wrapper(Individual ind, const void* param) {
     double M_tot = M_est + FIXED_MASS + 80.0; // +80kg Piloto
 
     // 2. Calcula Potências
-    double Crr = calcular_crr_dinamico(simulated_velocity_ms*3.6, 25.0);
+    double Crr = physics_crr(simulated_velocity_ms*3.6, 25.0);
     double F_res = (0.5*RHO_AIR*CdA_tot*pow(simulated_velocity_ms, 2)) + (Crr*M_tot*GRAVITY);
     double P_res = F_res * simulated_velocity_ms;
     
@@ -167,7 +240,7 @@ double fitness_shape_wrapper(Individual ind, const void* param) {
     double P_sol = calcular_potencia_solar(sol.irradiance, A_solar, sol.T_amb);
     
     // Eficiência da cadeia
-    double eta = EFF_MPPT * EFF_DRIVER * eficiencia_motor(P_res) * EFF_TRANS;
+    double eta = EFF_MPPT * EFF_DRIVER * physics_motor_eff(P_res) * EFF_TRANS;
     double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
     
     // 3. Resultado: Saldo Energético (Net Power)
@@ -177,21 +250,223 @@ double fitness_shape_wrapper(Individual ind, const void* param) {
     return net; 
 }
 
-// FASE 2: OTIMIZAÇÃO DE ESTRATÉGIA (3000km)
-double fitness_strategy_wrapper(Individual ind, const void* param) {
-    const CarDesignOutrigger* car = (CarDesignOutrigger*)param;
-    double* perfil_v = ind.genes; // 9 velocidades (uma por hora)
+static double shape_fitness_core(const ShapeGenes* s, double simulated_velocity_ms) {
+    if (!shape_is_feasible(s)) return -DBL_MAX;
+    const double* g = s->g;
+
+    // 1. Calcula Aerodinâmica e Massa dos Componentes
+    double Am_c, Am_p;
+    double CdA_c = calcular_drag_body(g[0], g[1], g[2], simulated_velocity_ms, &Am_c);
+    double CdA_p = calcular_drag_body(g[3], g[4], g[4], simulated_velocity_ms, &Am_p);
     
-    double dist = 0, tempo = 0;
-    double cap_bat = CAPACIDADE_BATERIA_KWH * 1000.0; // Wh
-    double bat_atual = cap_bat;
-    int dias = 0;
+    // Asa de conexão (Painel Solar)
+    double Re_w = shape_wing_reynolds(s, simulated_velocity_ms);
+    double frac = fmin(0.3, RE_CRIT / Re_w);
+    double Cf_w = frac * (1.328/sqrt(Re_w)) + (1-frac)*(0.074/pow(Re_w, 0.2));
 
-    // Recalcula física do carro fixo (uma única vez para economizar CPU)
-    double avg_v = 0;
-    for(int i=0; i<9; i++) avg_v += perfil_v[i];
-    avg_v = fmax(avg_v / 9.0, 1.0);
+    return shape_net_power(s, simulated_velocity_ms, CdA_c, Am_c, CdA_p, Am_p, Cf_w);
+}
+
+double fitness_shape_wrapper(Individual ind, const void* param) {
+    double simulated_velocity_ms = *(double*)param; // Velocidade de referência (ex: 22 m/s)
+    ShapeGenes g = shape_genes_load(ind);
+    return shape_fitness_core(&g, simulated_velocity_ms);
+}
+
+// Tamanho do sub-bloco do caminho vetorial (dimensiona os vetores na pilha)
+#define SHAPE_SIMD_CHUNK 128
+
+/**
+ * Caminho vetorial da Fase 1: separa casco, pod e asa de até SHAPE_SIMD_CHUNK
+ * indivíduos em vetores SoA, calcula a aerodinâmica com os kernels SIMD e
+ * finaliza o balanço energético de cada um com a mesma aritmética escalar.
+ */
+static void shape_batch_simd(const GeneMatrix* genes, int begin, int end, double* out, double v_ms) {
+    ShapeGenes g[SHAPE_SIMD_CHUNK];
+    double L[2 * SHAPE_SIMD_CHUNK], W[2 * SHAPE_SIMD_CHUNK], H[2 * SHAPE_SIMD_CHUNK];
+    double CdA[2 * SHAPE_SIMD_CHUNK], Am[2 * SHAPE_SIMD_CHUNK];
+    double Re_w[SHAPE_SIMD_CHUNK], Cf_w[SHAPE_SIMD_CHUNK];
+
+    for (int i0 = begin; i0 < end; i0 += SHAPE_SIMD_CHUNK) {
+        int n = (end - i0 < SHAPE_SIMD_CHUNK) ? end - i0 : SHAPE_SIMD_CHUNK;
+        for (int k = 0; k < n; k++) {
+            g[k] = shape_genes_at(genes, i0 + k);
+            L[k] = g[k].g[0];     W[k] = g[k].g[1];     H[k] = g[k].g[2]; // Casco
+            L[n + k] = g[k].g[3]; W[n + k] = g[k].g[4]; H[n + k] = g[k].g[4]; // Pod
+            Re_w[k] = shape_wing_reynolds(&g[k], v_ms);
+        }
+        calcular_drag_body_n(2 * n, L, W, H, v_ms, CdA, Am);
+        calcular_cf_misto_n(n, Re_w, Cf_w);
+
+        for (int k = 0; k < n; k++) {
+            out[i0 + k] = shape_is_feasible(&g[k])
+                ? shape_net_power(&g[k], v_ms, CdA[k], Am[k], CdA[n + k], Am[n + k], Cf_w[k])
+                : -DBL_MAX;
+        }
+    }
+}
+
+void fitness_shape_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param) {
+    double simulated_velocity_ms = *(const double*)param;
+    if (PHYSICS_FAST_AERO) { shape_batch_simd(genes, begin, end, out, simulated_velocity_ms); return; }
+
+    for (int i = begin; i < end; i++) {
+        ShapeGenes g = shape_genes_at(genes, i);
+        out[i] = shape_fitness_core(&g, simulated_velocity_ms);
+    }
+}
+
+/**
+ * No dispositivo, a fidelidade (e, no modo tabelado, as tabelas) vão junto a
+ * cada chamada: são poucos KB e podem ter mudado no hospedeiro desde a última.
+ */
+static void physics_device_sync(int device) {
+    GA_DEVICE_UPDATE(device, PHYSICS_FIDELITY);
+    if (PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA) {
+        GA_DEVICE_UPDATE(device, motor_tab, crr_tab);
+    }
+}
+
+// No dispositivo vale sempre a física exata de shape_fitness_core (sem PHYSICS_FAST_AERO)
+void fitness_shape_device(const double* genes, int n, int dims, double* out, const void* param, int device) {
+    double simulated_velocity_ms = *(const double*)param;
+    physics_device_sync(device);
+    GA_DEVICE_FOR(device, is_device_ptr(genes, out))
+    for (int i = 0; i < n; i++) {
+        ShapeGenes g;
+        for (int k = 0; k < SHAPE_NUM_GENES; k++) g.g[k] = genes[(size_t)i * dims + k];
+        out[i] = shape_fitness_core(&g, simulated_velocity_ms);
+    }
+}
+
+// --- AUXILIARES DAS FASES DE ESTRATÉGIA ---
+
+static void car_aero_mass(const CarDesignOutrigger* car, double avg_v, double* CdA_tot, double* M_tot);
+
+// --- MEMÓRIA AERODINÂMICA DO CARRO FIXO ---
+
+#define AERO_TAB_DV ((AERO_TAB_VMAX - AERO_TAB_VMIN) / AERO_TAB_N)
+
+void car_aero_init(CarAero* aero, const CarDesignOutrigger* car) {
+    // Arrasto de forma e área molhada: a velocidade não altera estes termos,
+    // basta avaliar calcular_drag_body uma vez com qualquer velocidade.
+    double Am_c, Am_p;
+    double A_f_c = PI/4 * car->W_casco * car->H_casco;
+    double A_f_p = PI/4 * car->D_pod * car->D_pod;
+    double finura[2] = { car->L_casco / sqrt(car->W_casco * car->H_casco),
+                         car->L_pod / sqrt(car->D_pod * car->D_pod) };
+    double A_f[2] = { A_f_c, A_f_p };
+    calcular_drag_body(car->L_casco, car->W_casco, car->H_casco, 20.0, &Am_c);
+    calcular_drag_body(car->L_pod, car->D_pod, car->D_pod, 20.0, &Am_p);
+
+    for (int b = 0; b < 2; b++) {
+        double Cd_forma;
+        if (finura[b] > 8.0) Cd_forma = 0.04;
+        else if (finura[b] > 4.0) Cd_forma = 0.04 + 0.02 * (8.0 - finura[b]) / 4.0;
+        else Cd_forma = 0.06 + 0.04 * (4.0 - finura[b]) / 2.0;
+        aero->CdA_forma[b] = (A_f[b] < 1e-6) ? 0.0 : Cd_forma * A_f[b];
+    }
+    aero->CdA_forma[2] = 0.0;
+    aero->A_molhada[0] = Am_c;
+    aero->A_molhada[1] = Am_p;
+    aero->A_molhada[2] = 2.0 * car->A_solar;
+    aero->S_atrito[0] = (A_f_c < 1e-6) ? 0.0 : Am_c;
+    aero->S_atrito[1] = (A_f_p < 1e-6) ? 0.0 : Am_p;
+    aero->S_atrito[2] = (2.0 * car->A_solar) * 0.5; // Placa plana fina
+
+    double L[3] = { car->L_casco, car->L_pod, car->A_solar / car->W_sep };
+    for (int s = 0; s < 3; s++) {
+        aero->kL[s] = (RHO_AIR * L[s]) / MU_AIR;
+        aero->inv_sqrt_kL[s] = 1.0 / sqrt(aero->kL[s]);
+        aero->inv_pow02_kL[s] = 1.0 / pow(aero->kL[s], 0.2);
+    }
+
+    double M_est = (RHO_CARENAGEM*(Am_c+Am_p)) + ((RHO_CHASSI+RHO_PAINEL)*car->A_solar);
+    aero->M_tot = M_est + FIXED_MASS + 80.0;
+
+    // Grade de v^-0.2: nó k está em AERO_TAB_VMIN + (k-1)*dv
+    for (int k = 0; k < AERO_TAB_N + 3; k++)
+        aero->tab_v_m02[k] = pow(AERO_TAB_VMIN + (k - 1) * AERO_TAB_DV, -0.2);
+}
+
+/** v^-0.2: Catmull-Rom na grade densa dentro da faixa, pow() fora dela. */
+static inline double aero_v_m02(const CarAero* aero, double v) {
+    if (v < AERO_TAB_VMIN || v >= AERO_TAB_VMAX) return pow(v, -0.2);
+    double x = (v - AERO_TAB_VMIN) / AERO_TAB_DV;
+    int i = (int)x;
+    double t = x - i;
+    const double* p = &aero->tab_v_m02[i]; // p[1] é o nó à esquerda de v
+    return p[1] + 0.5 * t * (p[2] - p[0] + t * (2.0*p[0] - 5.0*p[1] + 4.0*p[2] - p[3]
+                                             + t * (3.0*(p[1] - p[2]) + p[3] - p[0])));
+}
+
+void car_aero_breakdown(const CarAero* aero, double v_ms, double CdA_out[3]) {
+    double v_m05 = 1.0 / sqrt(v_ms);
+    double v_m02 = aero_v_m02(aero, v_ms);
+    for (int s = 0; s < 3; s++) {
+        double Re = aero->kL[s] * v_ms;
+        double Cf;
+        if (Re > 1.0) {
+            // Re^-1/2 e Re^-0.2 fatorados em (kL)^-n * v^-n
+            double frac = fmin(0.3, RE_CRIT / Re);
+            Cf = frac * 1.328 * aero->inv_sqrt_kL[s] * v_m05
+               + (1 - frac) * 0.074 * aero->inv_pow02_kL[s] * v_m02;
+        } else {
+            Cf = 0.3 * 1.328 + 0.7 * 0.074; // Re saturado em 1 (mesmo clamp de calcular_drag_body)
+        }
+        CdA_out[s] = aero->CdA_forma[s] + aero->S_atrito[s] * Cf;
+    }
+}
+
+double car_aero_cda(const CarAero* aero, double v_ms) {
+    double CdA[3];
+    car_aero_breakdown(aero, v_ms, CdA);
+    return (CdA[0] + CdA[1] + CdA[2]) * 1.10;
+}
+
+double car_aero_max_rel_error(const CarAero* aero, const CarDesignOutrigger* car,
+                              double v_min, double v_max, int amostras, double* M_err_out) {
+    double max_err = 0.0, max_M_err = 0.0;
+    for (int k = 0; k < amostras; k++) {
+        double v = v_min + (v_max - v_min) * k / (double)(amostras > 1 ? amostras - 1 : 1);
+        double CdA_ref, M_ref;
+        car_aero_mass(car, v, &CdA_ref, &M_ref);
+        double err = fabs(car_aero_cda(aero, v) - CdA_ref) / fabs(CdA_ref);
+        if (err > max_err) max_err = err;
+        if (fabs(aero->M_tot - M_ref) > max_M_err) max_M_err = fabs(aero->M_tot - M_ref);
+    }
+    if (M_err_out) *M_err_out = max_M_err;
+    return max_err;
+}
 
+void race_context_init(RaceContext* ctx, const CarDesignOutrigger* car) {
+    ctx->car = *car;
+    car_aero_init(&ctx->aero, car);
+    for (int hora = 0; hora < 9; hora++) {
+        SolarData sol = get_solar_data(hora);
+        ctx->P_sol_liq[hora] = calcular_potencia_solar(sol.irradiance, car->A_solar, sol.T_amb) * EFF_MPPT;
+        ctx->T_asf[hora] = temperatura_asfalto(hora, sol.T_amb);
+        ctx->crr_fator_temp[hora] = 1 + CR_TEMP_COEFF * (ctx->T_asf[hora] - 25);
+    }
+}
+
+/**
+ * Mesma conta de calcular_potencia_resistiva, mas com o fator térmico do Crr
+ * da hora já tabelado no contexto (produz exatamente o mesmo valor). Sai mais
+ * barato que a tabela v x T, então vale também no modo tabelado.
+ */
+static inline double race_potencia_resistiva(const RaceContext* ctx, int hora, double v_ms,
+                                             double M_total, double CdA_total) {
+    double F_arrasto = 0.5 * RHO_AIR * CdA_total * (v_ms * v_ms);
+    double Crr = CR_ROLLING_BASE * (1 + CR_SPEED_COEFF * (v_ms * 3.6)) * ctx->crr_fator_temp[hora];
+    return (F_arrasto + Crr * M_total * GRAVITY) * v_ms;
+}
+
+/**
+ * Caminho direto (sem memória): aerodinâmica e massa do carro na velocidade dada.
+ * Serve de referência para a verificação de precisão de CarAero.
+ */
+static void car_aero_mass(const CarDesignOutrigger* car, double avg_v, double* CdA_tot, double* M_tot) {
     double Am_c, Am_p;
     double CdA_c = calcular_drag_body(car->L_casco, car->W_casco, car->H_casco, avg_v, &Am_c);
     double CdA_p = calcular_drag_body(car->L_pod, car->D_pod, car->D_pod, avg_v, &Am_p);
@@ -202,128 +477,256 @@ double fitness_strategy_wrapper(Individual ind, const void* param) {
     double Cf_w = frac * (1.328/sqrt(Re_w)) + (1-frac)*(0.074/pow(Re_w, 0.2));
     double CdA_w = Cf_w * (2.0 * car->A_solar) * 0.5;
     
-    double CdA_tot = (CdA_c + CdA_p + CdA_w) * 1.10;
+    *CdA_tot = (CdA_c + CdA_p + CdA_w) * 1.10;
     double M_est = (RHO_CARENAGEM*(Am_c+Am_p)) + ((RHO_CHASSI+RHO_PAINEL)*car->A_solar);
-    double M_tot = M_est + FIXED_MASS + 80.0;
+    *M_tot = M_est + FIXED_MASS + 80.0;
+}
+
+// =============================================================================
+// SIMULADOR DE CORRIDA (Fases 2 e 3, relatórios)
+// =============================================================================
+
+/**
+ * Parte do dia que não depende da bateria: CdA na velocidade média e, para cada
+ * hora, a potência drenada andando e o saldo solar - motor. Todo dia da prova
+ * repete o mesmo perfil, então a física roda só RACE_HORAS_DIA vezes por
+ * perfil; os dias seguintes só integram a bateria e a distância.
+ */
+typedef struct {
+    double v_kmh[RACE_HORAS_DIA];
+    double P_bat[RACE_HORAS_DIA];    // Potência da bateria com o carro andando (W)
+    double balanco[RACE_HORAS_DIA];  // P_sol_liq - P_bat (W; < 0 = descarrega)
+} RaceDayPlan;
+
+static inline void race_day_plan(const RaceContext* ctx, const double* perfil_v, RaceDayPlan* d) {
+    // Aerodinâmica do carro fixo na velocidade média (uma única vez por perfil)
+    double avg_v = 0;
+    for(int i=0; i<RACE_HORAS_DIA; i++) avg_v += perfil_v[i];
+    avg_v = fmax(avg_v / RACE_HORAS_DIA, 1.0);
+
+    double CdA_tot = car_aero_cda(&ctx->aero, avg_v);
+    double M_tot = ctx->aero.M_tot;
+
+    for (int hora = 0; hora < RACE_HORAS_DIA; hora++) {
+        double v_ms = perfil_v[hora];
+        double P_res = race_potencia_resistiva(ctx, hora, v_ms, M_tot, CdA_tot);
+        double eta = EFF_MPPT * EFF_DRIVER * physics_motor_eff(P_res) * EFF_TRANS;
+        d->v_kmh[hora] = v_ms * 3.6;
+        d->P_bat[hora] = (eta > 1e-6) ? (P_res / eta) : 1e6;
+        d->balanco[hora] = ctx->P_sol_liq[hora] - d->P_bat[hora];
+    }
+}
+
+/**
+ * Laço horário de bateria/distância. 'static inline' de propósito: a fitness
+ * chama com trace == NULL constante e o compilador gera uma cópia sem o rastro.
+ * Faz as mesmas operações, na mesma ordem, de race_simulate_reference (o laço
+ * original, que recalcula a física a cada hora): os resultados são idênticos
+ * bit a bit, só que com 9 horas de física por perfil em vez de até 90.
+ */
+static inline RaceState race_simulate_core(const RaceContext* ctx, const double* perfil_v,
+                                           double meta_km, int max_dias, RaceTrace* trace) {
+    RaceState st = {0.0, 0.0, CAPACIDADE_BATERIA_KWH * 1000.0, 0};
+    const double cap_bat = st.bat_wh; // Wh
+    if (trace) trace->n = 0;
+    if (max_dias > RACE_MAX_DIAS) max_dias = RACE_MAX_DIAS;
+
+    RaceDayPlan d;
+    race_day_plan(ctx, perfil_v, &d);
 
-    // Simulação dia após dia até completar 3000km
-    while (dist < 3000.0 && dias < 10) { // Limite de 10 dias para não loopar infinito
-        dias++;
-        for (int hora = 0; hora < 9; hora++) {
+    // Simulação dia após dia até completar a meta
+    while (st.dist_km < meta_km && st.dias < max_dias) {
+        st.dias++;
+        for (int hora = 0; hora < RACE_HORAS_DIA; hora++) {
+            double P_bat = 0.0;
+
+            if (st.bat_wh <= 0.01 * cap_bat) {
+                // Bateria vazia (<1%): fica parado carregando
+                st.bat_wh += ctx->P_sol_liq[hora];
+                if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
+            } else {
+                P_bat = d.P_bat[hora];
+                double balanco = d.balanco[hora];
+
+                // Verifica se a bateria aguenta a hora inteira
+                if (balanco < 0 && fabs(balanco) > st.bat_wh) {
+                    // Morreu no meio da hora: anda a fração e fica parado o resto
+                    double f_h = st.bat_wh / fabs(balanco);
+                    st.dist_km += d.v_kmh[hora] * f_h;
+                    st.bat_wh = 0;
+                } else {
+                    // Hora completa
+                    st.bat_wh += balanco;
+                    if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
+                    st.dist_km += d.v_kmh[hora];
+                }
+            }
+            st.tempo_h += 1.0; // O tempo passa igual, andando ou parado
+
+            if (trace) {
+                RaceTraceHour* h = &trace->horas[trace->n++];
+                h->dia = st.dias;
+                h->hora = hora;
+                h->P_bat = P_bat;
+                h->bat_wh = st.bat_wh;
+                h->dist_km = st.dist_km;
+            }
+            if (st.dist_km >= meta_km) break;
+        }
+        // Penalidade noturna (15h de noite)
+        if (st.dist_km < meta_km) st.tempo_h += 15.0;
+    }
+    return st;
+}
+
+/** Laço original (física recalculada a cada hora): referência de race_simulate_check. */
+static RaceState race_simulate_reference(const RaceContext* ctx, const double* perfil_v,
+                                         double meta_km, int max_dias) {
+    RaceState st = {0.0, 0.0, CAPACIDADE_BATERIA_KWH * 1000.0, 0};
+    const double cap_bat = st.bat_wh;
+    if (max_dias > RACE_MAX_DIAS) max_dias = RACE_MAX_DIAS;
+
+    double avg_v = 0;
+    for(int i=0; i<RACE_HORAS_DIA; i++) avg_v += perfil_v[i];
+    avg_v = fmax(avg_v / RACE_HORAS_DIA, 1.0);
+    double CdA_tot = car_aero_cda(&ctx->aero, avg_v);
+    double M_tot = ctx->aero.M_tot;
+
+    while (st.dist_km < meta_km && st.dias < max_dias) {
+        st.dias++;
+        for (int hora = 0; hora < RACE_HORAS_DIA; hora++) {
             double v_ms = perfil_v[hora];
             double v_kmh = v_ms * 3.6;
-            
-            // Dados ambientais da hora
-            SolarData sol = get_solar_data(hora);
-            double P_sol_liq = calcular_potencia_solar(sol.irradiance, car->A_solar, sol.T_amb) * EFF_MPPT;
-
-            // Se bateria vazia (<1%), fica parado carregando
-            if (bat_atual <= 0.01 * cap_bat) {
-                 bat_atual += P_sol_liq;
-                 if (bat_atual > cap_bat) bat_atual = cap_bat;
-                 tempo += 1.0;
-                 continue;
-            }
+            double P_sol_liq = ctx->P_sol_liq[hora];
 
-            // Consumo
-            double T_asf = temperatura_asfalto(hora, sol.T_amb);
-            double P_res = calcular_potencia_resistiva(v_ms, M_tot, CdA_tot, T_asf);
-            double eta = EFF_MPPT * EFF_DRIVER * eficiencia_motor(P_res) * EFF_TRANS;
-            double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
-            
-            double balanco = P_sol_liq - P_bat;
-            
-            // Verifica se a bateria aguenta a hora inteira
-            if (balanco < 0 && fabs(balanco) > bat_atual) {
-                // Morreu no meio da hora
-                double f_h = bat_atual / fabs(balanco); // Fração da hora que andou
-                dist += v_kmh * f_h;
-                tempo += 1.0; // O tempo passa igual (ficou parado o resto da hora)
-                bat_atual = 0;
+            if (st.bat_wh <= 0.01 * cap_bat) {
+                st.bat_wh += P_sol_liq;
+                if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
             } else {
-                // Hora completa
-                bat_atual += balanco;
-                if (bat_atual > cap_bat) bat_atual = cap_bat;
-                dist += v_kmh;
-                tempo += 1.0;
+                double P_res = race_potencia_resistiva(ctx, hora, v_ms, M_tot, CdA_tot);
+                double eta = EFF_MPPT * EFF_DRIVER * physics_motor_eff(P_res) * EFF_TRANS;
+                double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
+                double balanco = P_sol_liq - P_bat;
+                if (balanco < 0 && fabs(balanco) > st.bat_wh) {
+                    double f_h = st.bat_wh / fabs(balanco);
+                    st.dist_km += v_kmh * f_h;
+                    st.bat_wh = 0;
+                } else {
+                    st.bat_wh += balanco;
+                    if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
+                    st.dist_km += v_kmh;
+                }
             }
-            if (dist >= 3000.0) break;
+            st.tempo_h += 1.0;
+            if (st.dist_km >= meta_km) break;
         }
-        // Penalidade noturna (15h de noite)
-        if (dist < 3000.0) tempo += 15.0;
+        if (st.dist_km < meta_km) st.tempo_h += 15.0;
     }
+    return st;
+}
+
+static int race_state_differs(RaceState a, RaceState b) {
+    return a.dist_km != b.dist_km || a.tempo_h != b.tempo_h || a.bat_wh != b.bat_wh || a.dias != b.dias;
+}
+
+int race_simulate_check(const RaceContext* ctx, double v_min, double v_max, int amostras) {
+    RngState rng;
+    rng_seed(&rng, 31);
+    int divergentes = 0;
+    for (int k = 0; k < amostras; k++) {
+        double perfil_v[RACE_HORAS_DIA];
+        for (int h = 0; h < RACE_HORAS_DIA; h++) perfil_v[h] = v_min + (v_max - v_min) * rng_uniform(&rng);
+        if (race_state_differs(race_simulate_core(ctx, perfil_v, 3000.0, RACE_MAX_DIAS, NULL),
+                               race_simulate_reference(ctx, perfil_v, 3000.0, RACE_MAX_DIAS)) ||
+            race_state_differs(race_simulate_core(ctx, perfil_v, INFINITY, 1, NULL),
+                               race_simulate_reference(ctx, perfil_v, INFINITY, 1)))
+            divergentes++;
+    }
+    return divergentes;
+}
+
+RaceState race_simulate(const RaceContext* ctx, const double* perfil_v,
+                        double meta_km, int max_dias, RaceTrace* trace) {
+    return race_simulate_core(ctx, perfil_v, meta_km, max_dias, trace);
+}
+
+// FASE 2: OTIMIZAÇÃO DE ESTRATÉGIA (3000km)
+static double strategy_fitness_core(const StrategyGenes* perfil, const RaceContext* ctx) {
+    RaceState st = race_simulate_core(ctx, perfil->v, 3000.0, RACE_MAX_DIAS, NULL);
 
     // Retorna pontuação baseada no tempo (Menor tempo = Maior Fitness)
     // Usamos inversão: Fitness = Constante - Tempo
     // Ou melhor: Fitness = Velocidade Média Global
-    if (dist >= 3000.0) return 3000.0 + (1000.0 / tempo); // Bônus por terminar rápido
-    return dist; // Se não terminou, o fitness é a distância (incentiva ir mais longe)
+    if (st.dist_km >= 3000.0) return 3000.0 + (1000.0 / st.tempo_h); // Bônus por terminar rápido
+    return st.dist_km; // Se não terminou, o fitness é a distância (incentiva ir mais longe)
 }
 
-// FASE 3: ALCANCE DIÁRIO (Item 28)
-double fitness_strategy_daily_wrapper(Individual ind, const void* param) {
-    const CarDesignOutrigger* car = (CarDesignOutrigger*)param;
-    double* perfil_v = ind.genes;
-    double dist = 0;
-    double cap_bat = CAPACIDADE_BATERIA_KWH * 1000.0;
-    double bat_atual = cap_bat;
-    
-    // Recálculo físico simplificado (copiado da lógica acima)
-    double avg_v = 0;
-    for(int i=0; i<9; i++) avg_v += perfil_v[i];
-    avg_v = fmax(avg_v / 9.0, 1.0);
-    double Am_c, Am_p;
-    double CdA_c = calcular_drag_body(car->L_casco, car->W_casco, car->H_casco, avg_v, &Am_c);
-    double CdA_p = calcular_drag_body(car->L_pod, car->D_pod, car->D_pod, avg_v, &Am_p);
-    double L_chord = car->A_solar / car->W_sep;
-    double Re_w = fmax(1.0, (RHO_AIR * avg_v * L_chord) / MU_AIR);
-    double frac = fmin(0.3, RE_CRIT / Re_w);
-    double Cf_w = frac * (1.328/sqrt(Re_w)) + (1-frac)*(0.074/pow(Re_w, 0.2));
-    double CdA_w = Cf_w * (2.0 * car->A_solar) * 0.5;
-    double CdA_tot = (CdA_c + CdA_p + CdA_w) * 1.10;
-    double M_est = (RHO_CARENAGEM*(Am_c+Am_p)) + ((RHO_CHASSI+RHO_PAINEL)*car->A_solar);
-    double M_tot = M_est + FIXED_MASS + 80.0;
-
-    // Simula apenas 1 dia (9h)
-    for (int hora = 0; hora < 9; hora++) {
-        double v_ms = perfil_v[hora];
-        double v_kmh = v_ms * 3.6;
-        SolarData sol = get_solar_data(hora);
-        double P_sol_liq = calcular_potencia_solar(sol.irradiance, car->A_solar, sol.T_amb) * EFF_MPPT;
+double fitness_strategy_wrapper(Individual ind, const void* param) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    StrategyGenes perfil = strategy_genes_load(ind); // 9 velocidades (uma por hora)
+    return strategy_fitness_core(&perfil, ctx);
+}
 
-        if (bat_atual <= 0.01 * cap_bat) {
-             bat_atual += P_sol_liq;
-             if (bat_atual > cap_bat) bat_atual = cap_bat;
-             continue;
-        }
+void fitness_strategy_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    for (int i = begin; i < end; i++) {
+        StrategyGenes perfil = strategy_genes_at(genes, i);
+        out[i] = strategy_fitness_core(&perfil, ctx);
+    }
+}
 
-        double T_asf = temperatura_asfalto(hora, sol.T_amb);
-        double P_res = calcular_potencia_resistiva(v_ms, M_tot, CdA_tot, T_asf);
-        double eta = EFF_MPPT * EFF_DRIVER * eficiencia_motor(P_res) * EFF_TRANS;
-        double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
-        
-        double balanco = P_sol_liq - P_bat;
-        if (balanco < 0 && fabs(balanco) > bat_atual) {
-            double f_h = bat_atual / fabs(balanco);
-            dist += v_kmh * f_h;
-            bat_atual = 0;
-        } else {
-            bat_atual += balanco;
-            if (bat_atual > cap_bat) bat_atual = cap_bat;
-            dist += v_kmh;
-        }
+void fitness_strategy_device(const double* genes, int n, int dims, double* out, const void* param, int device) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    physics_device_sync(device);
+    GA_DEVICE_FOR(device, is_device_ptr(genes, out) map(to: ctx[0:1]))
+    for (int i = 0; i < n; i++) {
+        StrategyGenes perfil;
+        for (int h = 0; h < RACE_HORAS_DIA; h++) perfil.v[h] = genes[(size_t)i * dims + h];
+        out[i] = strategy_fitness_core(&perfil, ctx);
     }
+}
+
+// FASE 3: ALCANCE DIÁRIO (Item 28)
+static double strategy_daily_core(const StrategyGenes* perfil, const RaceContext* ctx) {
+    // Simula apenas 1 dia (9h), sem meta de distância
+    RaceState st = race_simulate_core(ctx, perfil->v, INFINITY, 1, NULL);
+    double cap_bat = CAPACIDADE_BATERIA_KWH * 1000.0;
     
     // Penalidade se terminar com bateria < 30%
     double limite_minimo_wh = cap_bat * 0.30;
     
-    if (bat_atual >= limite_minimo_wh) {
+    if (st.bat_wh >= limite_minimo_wh) {
         // Cumpriu a meta: Fitness = Distância
-        double erro_positivo_wh = bat_atual - limite_minimo_wh;
+        double erro_positivo_wh = st.bat_wh - limite_minimo_wh;
         // Pequena penalidade por sobrar demais (queremos usar tudo até 30%)
-        return dist - (erro_positivo_wh * 0.1);
+        return st.dist_km - (erro_positivo_wh * 0.1);
     } else {
         // Falhou na meta: Penalidade negativa baseada na falta de energia
-        return (bat_atual - limite_minimo_wh); 
+        return (st.bat_wh - limite_minimo_wh); 
     }
-}
\ No newline at end of file
+}
+
+double fitness_strategy_daily_wrapper(Individual ind, const void* param) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    StrategyGenes perfil = strategy_genes_load(ind); // 9 velocidades (uma por hora)
+    return strategy_daily_core(&perfil, ctx);
+}
+
+void fitness_strategy_daily_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    for (int i = begin; i < end; i++) {
+        StrategyGenes perfil = strategy_genes_at(genes, i);
+        out[i] = strategy_daily_core(&perfil, ctx);
+    }
+}
+
+void fitness_strategy_daily_device(const double* genes, int n, int dims, double* out, const void* param, int device) {
+    const RaceContext* ctx = (const RaceContext*)param;
+    physics_device_sync(device);
+    GA_DEVICE_FOR(device, is_device_ptr(genes, out) map(to: ctx[0:1]))
+    for (int i = 0; i < n; i++) {
+        StrategyGenes perfil;
+        for (int h = 0; h < RACE_HORAS_DIA; h++) perfil.v[h] = genes[(size_t)i * dims + h];
+        out[i] = strategy_daily_core(&perfil, ctx);
+    }
+}
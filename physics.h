@@ -10,6 +10,7 @@
  */
 
 #include "ga_engine.h"
+#include "ga_device.h"
 
 // ============================================================================
 // --- CONSTANTES FÍSICAS E AMBIENTAIS ---
@@ -111,6 +112,123 @@ typedef struct {
     double T_amb;      // Temperatura Ambiente (°C)
 } SolarData;
 
+// Tabela densa de v^-0.2 usada por CarAero (interpolação cúbica de Catmull-Rom)
+#define AERO_TAB_N 4096      // Intervalos da grade
+#define AERO_TAB_VMIN 10.0   // Faixa tabelada (m/s); fora dela usa pow() direto
+#define AERO_TAB_VMAX 30.0
+
+/**
+ * @brief Aerodinâmica e massa memorizadas de um carro fixo, em função da velocidade.
+ * * Para o carro fixo só o Reynolds depende da velocidade (Re = kL * v). A área
+ * molhada, o arrasto de forma e a massa são calculados uma única vez; o Cf de
+ * cada superfície vira alguns produtos com v^-1/2 e v^-0.2, este último lido de
+ * uma tabela densa com interpolação cúbica. Substitui as duas chamadas de
+ * calcular_drag_body + o bloco da asa + M_est por avaliação de fitness.
+ * * Superfícies: [0] casco, [1] pod, [2] asa solar (placa plana).
+ */
+typedef struct {
+    double M_tot;              // Massa total (kg) - não depende da velocidade
+    double CdA_forma[3];       // Parcela de pressão Cd_forma * A_frontal (m^2; asa = 0)
+    double S_atrito[3];        // Área que multiplica o Cf (m^2): área molhada (asa: 2*A*0.5)
+    double A_molhada[3];       // Área molhada real de cada superfície (m^2), para relatórios
+    double kL[3];              // RHO_AIR * L / MU_AIR: Re = kL * v
+    double inv_sqrt_kL[3];     // kL^-1/2
+    double inv_pow02_kL[3];    // kL^-0.2
+    double tab_v_m02[AERO_TAB_N + 3]; // v^-0.2 na grade (com 1 nó extra antes e 2 depois)
+} CarAero;
+
+/**
+ * @brief Contexto de corrida pré-calculado para um carro fixo (Fases 2 e 3).
+ * * Nada aqui depende dos genes (velocidades): irradiância, temperatura do
+ * asfalto e o fator térmico do Crr de cada hora só dependem do carro e do dia.
+ * main.c monta este contexto uma vez e o passa como 'extra_param' do AG, então
+ * o laço horário da fitness vira aritmética pura.
+ */
+typedef struct {
+    CarDesignOutrigger car;   // Geometria fixa vinda da Fase 1
+    double P_sol_liq[9];      // Potência solar líquida que entra na bateria (W), já com EFF_MPPT
+    double T_asf[9];          // Temperatura do asfalto (°C)
+    double crr_fator_temp[9]; // Fator térmico do Crr: (1 + CR_TEMP_COEFF * (T_asf - 25))
+    CarAero aero;             // CdA_tot(v) e M_tot memorizados do carro
+} RaceContext;
+
+// Limites do simulador de corrida (race_simulate)
+#define RACE_HORAS_DIA 9   // Horas de corrida por dia (8h às 17h)
+#define RACE_MAX_DIAS 10   // Limite de dias para não loopar infinito
+
+// --- GENES DECODIFICADOS (tamanho fixo) ---
+// As fitness copiam os genes do indivíduo (que pode estar intercalado na matriz)
+// uma vez para estas estruturas: os núcleos da física recebem blocos de
+// tamanho conhecido em tempo de compilação, que ficam na pilha/registradores.
+
+#define SHAPE_NUM_GENES 7 // [L_casco, W_casco, H_casco, L_pod, D_pod, A_solar, W_sep]
+
+/** @brief Genes da Fase 1, na ordem de CarDesignOutrigger. */
+typedef struct {
+    double g[SHAPE_NUM_GENES];
+} ShapeGenes;
+
+/** @brief Genes das Fases 2 e 3: a velocidade de cada hora de corrida (m/s). */
+typedef struct {
+    double v[RACE_HORAS_DIA];
+} StrategyGenes;
+
+/** @brief Copia os genes da Fase 1 de um indivíduo (qualquer layout). */
+static inline ShapeGenes shape_genes_load(Individual ind) {
+    ShapeGenes s;
+    for (int k = 0; k < SHAPE_NUM_GENES; k++) s.g[k] = IND_GENE(ind, k);
+    return s;
+}
+
+/** @brief Copia os genes da Fase 1 do indivíduo i de uma GeneMatrix. */
+static inline ShapeGenes shape_genes_at(const GeneMatrix* m, int i) {
+    ShapeGenes s;
+    for (int k = 0; k < SHAPE_NUM_GENES; k++) s.g[k] = GM_AT(m, i, k);
+    return s;
+}
+
+/** @brief Copia o perfil de velocidades de um indivíduo (qualquer layout). */
+static inline StrategyGenes strategy_genes_load(Individual ind) {
+    StrategyGenes s;
+    for (int h = 0; h < RACE_HORAS_DIA; h++) s.v[h] = IND_GENE(ind, h);
+    return s;
+}
+
+/** @brief Copia o perfil de velocidades do indivíduo i de uma GeneMatrix. */
+static inline StrategyGenes strategy_genes_at(const GeneMatrix* m, int i) {
+    StrategyGenes s;
+    for (int h = 0; h < RACE_HORAS_DIA; h++) s.v[h] = GM_AT(m, i, h);
+    return s;
+}
+
+/**
+ * @brief Estado integrado da corrida (saída de race_simulate).
+ */
+typedef struct {
+    double dist_km;  // Distância percorrida (km)
+    double tempo_h;  // Tempo decorrido, incluindo as 15h de cada noite (h)
+    double bat_wh;   // Energia restante na bateria (Wh)
+    int dias;        // Dias (totais ou parciais) simulados
+} RaceState;
+
+/**
+ * @brief Uma hora simulada, registrada no rastro detalhado (relatórios).
+ */
+typedef struct {
+    int dia, hora;   // Dia (a partir de 1) e hora (0 = 08-09h)
+    double P_bat;    // Potência drenada da bateria pelo motor (W); 0 se parado carregando
+    double bat_wh;   // Bateria ao fim da hora (Wh)
+    double dist_km;  // Distância acumulada ao fim da hora (km)
+} RaceTraceHour;
+
+/**
+ * @brief Rastro hora a hora de uma simulação (opcional em race_simulate).
+ */
+typedef struct {
+    RaceTraceHour horas[RACE_MAX_DIAS * RACE_HORAS_DIA];
+    int n;           // Número de horas registradas
+} RaceTrace;
+
 // ============================================================================
 // --- PROTÓTIPOS DE FUNÇÕES ---
 // ============================================================================
@@ -157,18 +275,175 @@ double eficiencia_motor(double P_resist);
  */
 double calcular_drag_body(double L, double W, double H, double v_ms, double* A_molhada_out);
 
+/**
+ * @brief Versão vetorial de calcular_drag_body para n corpos de uma vez (SIMD).
+ * * Entradas e saídas em vetores separados (SoA). Escolhe AVX-512 (8 corpos por
+ * instrução), AVX2 (4) ou SSE2 genérico (2) conforme a CPU.
+ * @note Usa pow/log/exp polinomiais: erro relativo <= 1e-14 (medido ~1e-15)
+ * contra calcular_drag_body em CdA e A_molhada no domínio geométrico do carro.
+ * Todas as larguras devolvem os mesmos bits para o mesmo corpo.
+ */
+void calcular_drag_body_n(int n, const double* L, const double* W, const double* H,
+                          double v_ms, double* CdA_out, double* A_molhada_out);
+
+/**
+ * @brief Cf misto laminar/turbulento (o mesmo de calcular_drag_body) para n valores de Re.
+ * Usado na asa solar da Fase 1. Mesma precisão de calcular_drag_body_n.
+ */
+void calcular_cf_misto_n(int n, const double* Re, double* Cf_out);
+
+/** @brief Nome do back end vetorial ativo: "avx512", "avx2" ou "generico". */
+const char* physics_simd_backend();
+
+/**
+ * @brief Liga o caminho aerodinâmico vetorial/aproximado na fitness em lote da Fase 1.
+ * 0 (padrão) = física exata via libm, bit a bit igual à versão escalar.
+ * 1 = fitness_shape_batch usa calcular_drag_body_n (ver precisão acima).
+ */
+extern int PHYSICS_FAST_AERO;
+
+// Tabelas do modo PHYSICS_FIDELITY_TABELADA (interpolação linear/bilinear)
+#define MOTOR_TAB_PMAX 2250.0 // Fim da curva (carga 2.5); acima é saturação, sem tabela
+#define MOTOR_TAB_N 900       // Intervalos de 2.5 W: as quebras da curva (180, 720, 2250 W) caem em nós
+#define CRR_TAB_VMAX 144.0    // Faixa tabelada do Crr: v em [0, 144] km/h (40 m/s) ...
+#define CRR_TAB_TMAX 80.0     // ... e T_asfalto em [0, 80] °C; fora dela usa a função exata
+#define CRR_TAB_NV 32         // Intervalos em v
+#define CRR_TAB_NT 32         // Intervalos em T
+
+/** @brief Fidelidade das curvas de eficiência do motor e Crr usadas pelas fitness. */
+typedef enum {
+    PHYSICS_FIDELITY_EXATA = 0,    // eficiencia_motor / calcular_crr_dinamico (padrão)
+    PHYSICS_FIDELITY_TABELADA = 1  // Tabelas pré-calculadas (eficiencia_motor_tab / crr_dinamico_tab)
+} PhysicsFidelity;
+
+/** @brief Fidelidade ativa (mude com physics_set_fidelity, não diretamente). */
+extern PhysicsFidelity PHYSICS_FIDELITY;
+
+/**
+ * @brief Monta as tabelas a partir das funções exatas (só na primeira chamada).
+ * Não é thread-safe: chamar na inicialização, antes de iniciar os AGs.
+ */
+void physics_tables_init();
+
+/** @brief Escolhe a fidelidade (o modo tabelado chama physics_tables_init). */
+void physics_set_fidelity(PhysicsFidelity f);
+
+/**
+ * @brief eficiencia_motor por tabela (interpolação linear em P_resist).
+ * @note Como a curva é linear por partes com as quebras nos nós, o erro é só de
+ * arredondamento (<= 1e-15 relativo). Fora de [0, MOTOR_TAB_PMAX] usa a função exata.
+ * Exige physics_tables_init (o mesmo vale para crr_dinamico_tab).
+ */
+double eficiencia_motor_tab(double P_resist);
+
+/**
+ * @brief calcular_crr_dinamico por tabela (interpolação bilinear em v_kmh e T_asfalto).
+ * @note O modelo atual é bilinear, então o erro também é só de arredondamento;
+ * a tabela continua valendo (com erro de interpolação) se a curva ganhar termos não lineares.
+ */
+double crr_dinamico_tab(double v_kmh, double T_asfalto_C);
+
+/**
+ * @brief Verificação de precisão das tabelas contra as funções exatas, em 'amostras'
+ * pontos de cada faixa tabelada (e da grade v x T do Crr).
+ * @param crr_err_out [Saída opcional] Maior erro relativo do Crr.
+ * @return Maior erro relativo da eficiência do motor.
+ */
+double physics_tables_max_rel_error(int amostras, double* crr_err_out);
+
+/** @brief Eficiência do motor usada pelas fitness: exata ou tabelada, conforme PHYSICS_FIDELITY. */
+static inline double physics_motor_eff(double P_resist) {
+    return PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA ? eficiencia_motor_tab(P_resist) : eficiencia_motor(P_resist);
+}
+
+/** @brief Crr usado pelas fitness: exato ou tabelado, conforme PHYSICS_FIDELITY. */
+static inline double physics_crr(double v_kmh, double T_asfalto_C) {
+    return PHYSICS_FIDELITY == PHYSICS_FIDELITY_TABELADA ? crr_dinamico_tab(v_kmh, T_asfalto_C)
+                                                         : calcular_crr_dinamico(v_kmh, T_asfalto_C);
+}
+
 /**
  * @brief Calcula a potência total necessária para manter a velocidade constante.
  * Soma: P_arrasto_aerodinamico + P_atrito_rolamento.
  */
 double calcular_potencia_resistiva(double v_ms, double M_total, double CdA_total, double T_amb_pneu);
 
+/** @brief Monta a memória aerodinâmica (CarAero) de um carro. */
+void car_aero_init(CarAero* aero, const CarDesignOutrigger* car);
+
+/**
+ * @brief CdA total do carro (com 10% de interferência) na velocidade v_ms.
+ * @note Erro relativo <= 1e-12 (medido ~6e-13) contra o caminho direto (calcular_drag_body) em
+ * [AERO_TAB_VMIN, AERO_TAB_VMAX]; fora dessa faixa é exato até o arredondamento.
+ */
+double car_aero_cda(const CarAero* aero, double v_ms);
+
+/**
+ * @brief CdA de cada superfície, sem o fator de interferência (para relatórios).
+ * @param CdA_out [Saída] [0] casco, [1] pod, [2] asa.
+ */
+void car_aero_breakdown(const CarAero* aero, double v_ms, double CdA_out[3]);
+
+/**
+ * @brief Verificação de precisão: maior erro relativo de car_aero_cda contra o
+ * cálculo direto (calcular_drag_body + asa), amostrado em 'amostras' velocidades de [v_min, v_max].
+ * @param M_err_out [Saída opcional] Maior diferença absoluta de massa (kg).
+ */
+double car_aero_max_rel_error(const CarAero* aero, const CarDesignOutrigger* car,
+                              double v_min, double v_max, int amostras, double* M_err_out);
+
+/**
+ * @brief Pré-calcula o contexto de corrida (ambiente hora a hora) de um carro.
+ * Deve ser chamada uma vez por carro, antes de rodar as Fases 2 e 3.
+ */
+void race_context_init(RaceContext* ctx, const CarDesignOutrigger* car);
+
+/**
+ * @brief Simulador de corrida hora a hora (o único laço de bateria/distância do projeto).
+ * * Usado pelas fitness das Fases 2 e 3, pelo relatório final e pela
+ * re-simulação do Estágio 3: todos veem exatamente a mesma física.
+ * Corre dia após dia até atingir 'meta_km' ou completar 'max_dias'.
+ * O CdA vem de ctx->aero na velocidade média do perfil. Como todo dia repete
+ * o perfil, a potência de cada hora é calculada uma vez (9 horas de física por
+ * perfil); os dias seguintes só integram bateria e distância.
+ * @param perfil_v Velocidade de cada hora (RACE_HORAS_DIA valores, m/s).
+ * @param meta_km Distância alvo; use INFINITY para simular os dias inteiros.
+ * @param max_dias Número máximo de dias (<= RACE_MAX_DIAS).
+ * @param trace [Saída opcional] Rastro hora a hora; NULL no caminho rápido da fitness.
+ */
+RaceState race_simulate(const RaceContext* ctx, const double* perfil_v,
+                        double meta_km, int max_dias, RaceTrace* trace);
+
+/**
+ * @brief Verificação do simulador: compara race_simulate com o laço original
+ * (física recalculada a cada hora) em 'amostras' perfis aleatórios de [v_min, v_max],
+ * na prova de 3000 km e no alcance de 1 dia.
+ * @return Número de perfis cujo resultado não é idêntico bit a bit (esperado: 0).
+ */
+int race_simulate_check(const RaceContext* ctx, double v_min, double v_max, int amostras);
+
 // --- WRAPPERS PARA O ALGORITMO GENÉTICO ---
 // Estas funções adaptam a interface física para o ponteiro genérico do AG.
 // O parâmetro 'const void* param' permite passar estruturas extras sem mexer na assinatura do AG.
+// O indivíduo recebido é uma visão dentro da matriz da população: leia os genes com IND_GENE().
 
+// Fase 1: 'param' aponta para a velocidade de referência (double, m/s).
+// Fases 2 e 3: 'param' aponta para um RaceContext já inicializado.
 double fitness_shape_wrapper(Individual ind, const void* param);
 double fitness_strategy_wrapper(Individual ind, const void* param);
 double fitness_strategy_daily_wrapper(Individual ind, const void* param);
 
+// Versões em lote (FitnessBatchFunc): mesmo resultado das escalares, mas avaliam
+// um bloco inteiro da população por chamada.
+void fitness_shape_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param);
+void fitness_strategy_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param);
+void fitness_strategy_daily_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param);
+
+// Versões no dispositivo (FitnessDeviceFunc, ver ga_context_run_device): os
+// mesmos núcleos escalares, um indivíduo por iteração, sobre a matriz AoS que
+// já está no acelerador. A Fase 1 usa sempre a aerodinâmica exata.
+void fitness_shape_device(const double* genes, int n, int dims, double* out, const void* param, int device);
+void fitness_strategy_device(const double* genes, int n, int dims, double* out, const void* param, int device);
+void fitness_strategy_daily_device(const double* genes, int n, int dims, double* out, const void* param, int device);
+
 #endif // PHYSICS_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include <math.h>
+#include "physics.h"
+
+/**
+ * @file physics_simd.c
+ * @brief Kernels aerodinâmicos vetoriais (AVX-512 / AVX2 / SSE2 genérico).
+ * * Gera três versões do mesmo kernel (physics_simd_kernel.h) e escolhe a melhor
+ * em tempo de execução conforme a CPU. pow() é substituído por exp2(y*log2(x))
+ * polinomial, com erro relativo máximo medido de ~1e-15 contra a libm no
+ * domínio do carro (ver calcular_drag_body_n em physics.h). Os três ramos da
+ * tabela de finura viram blend/select, sem desvios por lane.
+ * * Este arquivo deve ser compilado com -ffp-contract=off: sem FMA implícito,
+ * todas as larguras produzem exatamente os mesmos bits.
+ */
+
+// --- VERSÃO GENÉRICA (2 lanes, SSE2 no x86-64 / qualquer CPU) ---
+static inline double sqrt_lane(double x) { return sqrt(x); }
+#define VW 2
+#define SIMD_SUFFIX gen
+#define VSQRT(x) ({ __typeof__(x) _r = (x); for (int _k = 0; _k < VW; _k++) _r[_k] = sqrt_lane(_r[_k]); _r; })
+#include "physics_simd_kernel.h"
+#undef VSQRT
+#undef SIMD_SUFFIX
+#undef VW
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PHYSICS_HAS_X86_SIMD 1
+
+// --- VERSÃO AVX2 (4 lanes) ---
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define VW 4
+#define SIMD_SUFFIX avx2
+#define VSQRT(x) ((__typeof__(x))_mm256_sqrt_pd((__m256d)(x)))
+#include "physics_simd_kernel.h"
+#undef VSQRT
+#undef SIMD_SUFFIX
+#undef VW
+#pragma GCC pop_options
+
+// --- VERSÃO AVX-512 (8 lanes) ---
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#define VW 8
+#define SIMD_SUFFIX avx512
+#define VSQRT(x) ((__typeof__(x))_mm512_sqrt_pd((__m512d)(x)))
+#include "physics_simd_kernel.h"
+#undef VSQRT
+#undef SIMD_SUFFIX
+#undef VW
+#pragma GCC pop_options
+#endif
+
+// =============================================================================
+// DESPACHO EM TEMPO DE EXECUÇÃO
+// =============================================================================
+
+const char* physics_simd_backend() {
+#ifdef PHYSICS_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx512f")) return "avx512";
+    if (__builtin_cpu_supports("avx2")) return "avx2";
+#endif
+    return "generico";
+}
+
+void calcular_drag_body_n(int n, const double* L, const double* W, const double* H,
+                          double v_ms, double* CdA_out, double* A_molhada_out) {
+    if (n <= 0) return;
+#ifdef PHYSICS_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx512f")) { drag_kernel_avx512(n, L, W, H, v_ms, CdA_out, A_molhada_out); return; }
+    if (__builtin_cpu_supports("avx2")) { drag_kernel_avx2(n, L, W, H, v_ms, CdA_out, A_molhada_out); return; }
+#endif
+    drag_kernel_gen(n, L, W, H, v_ms, CdA_out, A_molhada_out);
+}
+
+void calcular_cf_misto_n(int n, const double* Re, double* Cf_out) {
+    if (n <= 0) return;
+#ifdef PHYSICS_HAS_X86_SIMD
+    if (__builtin_cpu_supports("avx512f")) { cf_kernel_avx512(n, Re, Cf_out); return; }
+    if (__builtin_cpu_supports("avx2")) { cf_kernel_avx2(n, Re, Cf_out); return; }
+#endif
+    cf_kernel_gen(n, Re, Cf_out);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file physics_simd_kernel.h
+ * @brief "Template" do kernel aerodinâmico vetorial (incluído por physics_simd.c).
+ * * NÃO possui include guard de propósito: physics_simd.c inclui este arquivo
+ * uma vez para cada largura de vetor, definindo antes:
+ *   - VW          : número de lanes (doubles por vetor);
+ *   - SIMD_SUFFIX : sufixo dos nomes gerados (ex: avx2);
+ *   - VSQRT(x)    : raiz quadrada vetorial corretamente arredondada.
+ * * O código usa as extensões vetoriais do GCC, então a mesma fonte vira
+ * instruções AVX2, AVX-512 ou SSE2 de acordo com o 'target' ativo. Todas as
+ * larguras fazem exatamente as mesmas operações na mesma ordem: o resultado
+ * de um corpo não depende de qual lane, nem de qual CPU, o calculou.
+ */
+
+#define SIMD_CAT2(a, b) a##_##b
+#define SIMD_CAT(a, b) SIMD_CAT2(a, b)
+#define SIMD_NAME(x) SIMD_CAT(x, SIMD_SUFFIX)
+
+typedef double SIMD_NAME(vd) __attribute__((vector_size(VW * 8)));
+typedef long long SIMD_NAME(vi) __attribute__((vector_size(VW * 8)));
+#define VD SIMD_NAME(vd)
+#define VI SIMD_NAME(vi)
+
+static inline VD SIMD_NAME(vsplat)(double x) { return (VD){0} + x; }
+
+/** Seleção sem desvio: m ? a : b (m vem de uma comparação, lanes -1/0). */
+static inline VD SIMD_NAME(vsel)(VI m, VD a, VD b) {
+    return (VD)(((VI)a & m) | ((VI)b & ~m));
+}
+
+static inline VD SIMD_NAME(vmin)(VD a, VD b) { return SIMD_NAME(vsel)(a < b, a, b); }
+static inline VD SIMD_NAME(vmax)(VD a, VD b) { return SIMD_NAME(vsel)(a > b, a, b); }
+
+/**
+ * log2(x) para x > 0 normal.
+ * x = m * 2^e com m em [sqrt(1/2), sqrt(2)); ln(m) = 2*atanh(t), t = (m-1)/(m+1),
+ * série até t^17. Como |t| <= 0.1716, o primeiro termo descartado vale
+ * < 3e-16 em valor absoluto (abaixo do arredondamento de um double).
+ */
+static inline VD SIMD_NAME(vlog2)(VD x) {
+    const VD magic = SIMD_NAME(vsplat)(0x1.8p52);
+    VI bits = (VI)x;
+    VI e = ((bits >> 52) & 0x7ff) - 1023;
+    VD m = (VD)((bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL);
+    VI big = m > 1.4142135623730951;
+    m = SIMD_NAME(vsel)(big, m * 0.5, m);
+    e = e - big; // big = -1 onde m foi dividido por 2
+
+    VD t = (m - 1.0) / (m + 1.0);
+    VD t2 = t * t;
+    VD p = SIMD_NAME(vsplat)(1.0 / 17.0);
+    p = p * t2 + 1.0 / 15.0;
+    p = p * t2 + 1.0 / 13.0;
+    p = p * t2 + 1.0 / 11.0;
+    p = p * t2 + 1.0 / 9.0;
+    p = p * t2 + 1.0 / 7.0;
+    p = p * t2 + 1.0 / 5.0;
+    p = p * t2 + 1.0 / 3.0;
+    p = p * t2 + 1.0;
+    VD ln_m = 2.0 * t * p;
+
+    // Inteiro pequeno -> double sem cvtqq2pd (que o AVX2 não tem)
+    VD e_d = (VD)(e + (VI)magic) - magic;
+    return e_d + ln_m * 1.4426950408889634; // log2(e)
+}
+
+/**
+ * 2^y para |y| < 1000.
+ * y = n + f, n inteiro mais próximo, |f| <= 1/2; 2^f = e^(f ln2) por Taylor
+ * de grau 12 (termo descartado < 2e-16). 2^n é montado direto no expoente.
+ */
+static inline VD SIMD_NAME(vexp2)(VD y) {
+    const VD magic = SIMD_NAME(vsplat)(0x1.8p52);
+    VD n = (y + magic) - magic; // Arredonda para o inteiro mais próximo
+    VD z = (y - n) * 0.6931471805599453;
+    VD p = SIMD_NAME(vsplat)(1.0 / 479001600.0); // 1/12!
+    p = p * z + 1.0 / 39916800.0;
+    p = p * z + 1.0 / 3628800.0;
+    p = p * z + 1.0 / 362880.0;
+    p = p * z + 1.0 / 40320.0;
+    p = p * z + 1.0 / 5040.0;
+    p = p * z + 1.0 / 720.0;
+    p = p * z + 1.0 / 120.0;
+    p = p * z + 1.0 / 24.0;
+    p = p * z + 1.0 / 6.0;
+    p = p * z + 0.5;
+    p = p * z + 1.0;
+    p = p * z + 1.0;
+    VI ni = (VI)(n + magic) - (VI)magic;
+    return (VD)((VI)p + (ni << 52));
+}
+
+/** x^y = 2^(y log2 x), para x > 0. */
+static inline VD SIMD_NAME(vpow)(VD x, double y) {
+    return SIMD_NAME(vexp2)(SIMD_NAME(vlog2)(x) * y);
+}
+
+/** Cf misto laminar/turbulento (mesmo modelo de calcular_drag_body e da asa). */
+static inline VD SIMD_NAME(vcf_misto)(VD Re) {
+    VD frac_laminar = SIMD_NAME(vmin)(SIMD_NAME(vsplat)(0.3), RE_CRIT / Re);
+    VD Cf_lam = 1.328 / VSQRT(Re);
+    VD Cf_turb = 0.074 / SIMD_NAME(vpow)(Re, 0.2);
+    return frac_laminar * Cf_lam + (1.0 - frac_laminar) * Cf_turb;
+}
+
+/** Um vetor de corpos: mesma física de calcular_drag_body, sem desvios. */
+static inline void SIMD_NAME(drag_vec)(VD L, VD W, VD H, double v_ms, VD* CdA, VD* Am) {
+    const double p = 1.6075;
+    VD A_frontal = PI / 4 * W * H;
+    VI degenerado = A_frontal < 1e-6;
+
+    VD a = L / 2, b = W / 2, c = H / 2;
+    VD soma = SIMD_NAME(vpow)(a * b, p) + SIMD_NAME(vpow)(a * c, p) + SIMD_NAME(vpow)(b * c, p);
+    VD A_molhada = 4 * PI * SIMD_NAME(vpow)(soma / 3.0, 1.0 / p);
+
+    VD Re = SIMD_NAME(vmax)(SIMD_NAME(vsplat)(1.0), (RHO_AIR * v_ms * L) / MU_AIR);
+
+    // Tabela de finura como blend: calcula os três ramos e seleciona
+    VD finura = L / VSQRT(W * H);
+    VD Cd_alta = SIMD_NAME(vsplat)(0.04);
+    VD Cd_media = 0.04 + 0.02 * (8.0 - finura) / 4.0;
+    VD Cd_baixa = 0.06 + 0.04 * (4.0 - finura) / 2.0;
+    VD Cd_forma = SIMD_NAME(vsel)(finura > 8.0, Cd_alta,
+                  SIMD_NAME(vsel)(finura > 4.0, Cd_media, Cd_baixa));
+
+    VD Cf = SIMD_NAME(vcf_misto)(Re);
+    VD Cd_atrito = Cf * (A_molhada / A_frontal);
+
+    VD zero = SIMD_NAME(vsplat)(0.0);
+    *CdA = SIMD_NAME(vsel)(degenerado, zero, (Cd_forma + Cd_atrito) * A_frontal);
+    *Am = SIMD_NAME(vsel)(degenerado, zero, A_molhada);
+}
+
+/**
+ * Processa n corpos em blocos de VW lanes. O último bloco incompleto é
+ * preenchido repetindo o último corpo válido (lanes extras são descartadas).
+ */
+static void SIMD_NAME(drag_kernel)(int n, const double* L, const double* W, const double* H,
+                                   double v_ms, double* CdA_out, double* Am_out) {
+    for (int i = 0; i < n; i += VW) {
+        VD vL, vW, vH, vCdA, vAm;
+        for (int k = 0; k < VW; k++) {
+            int idx = (i + k < n) ? i + k : n - 1;
+            vL[k] = L[idx]; vW[k] = W[idx]; vH[k] = H[idx];
+        }
+        SIMD_NAME(drag_vec)(vL, vW, vH, v_ms, &vCdA, &vAm);
+        for (int k = 0; k < VW && i + k < n; k++) {
+            CdA_out[i + k] = vCdA[k];
+            Am_out[i + k] = vAm[k];
+        }
+    }
+}
+
+/** Cf misto para n números de Reynolds (ex: asas de toda a população). */
+static void SIMD_NAME(cf_kernel)(int n, const double* Re, double* Cf_out) {
+    for (int i = 0; i < n; i += VW) {
+        VD vRe, vCf;
+        for (int k = 0; k < VW; k++) vRe[k] = Re[(i + k < n) ? i + k : n - 1];
+        vCf = SIMD_NAME(vcf_misto)(vRe);
+        for (int k = 0; k < VW && i + k < n; k++) Cf_out[i + k] = vCf[k];
+    }
+}
+
+#undef VD
+#undef VI
+#undef SIMD_NAME
+#undef SIMD_CAT
+#undef SIMD_CAT2
@@ -0,0 +1,247 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "pipeline.h"
+
+// =============================================================================
+// ESTRUTURAS INTERNAS
+// =============================================================================
+
+/** Uma vaga do hall da fama (só a thread do Estágio 1 mexe no hall). */
+typedef struct {
+    double genes[PIPELINE_SHAPE_DIMS];
+    double fitness;
+    int desde;               // Geração da última mudança desta vaga
+    int versao;              // Incrementada a cada mudança dos genes
+    int versao_enfileirada;  // Versão que foi para a fila (-1 = nenhuma)
+} HallEntry;
+
+struct Pipeline {
+    PipelineConfig cfg;
+    HallEntry hall[PIPELINE_MAX_TOP_K];
+    int n_hall;
+    int ultima_geracao;
+
+    // Fila: todos os candidatos enfileirados, consumidos em ordem de chegada
+    pthread_mutex_t lock;
+    pthread_cond_t tem_trabalho;
+    PipelineCandidate** cand;
+    int n_cand, cap_cand;
+    int proximo;             // Próximo candidato a ser consumido
+    int fechado;             // 1 = o Estágio 1 terminou, não chegam mais candidatos
+
+    pthread_t* threads;
+    int n_threads;
+};
+
+// =============================================================================
+// HALL DA FAMA (PRODUTOR: THREAD DO ESTÁGIO 1)
+// =============================================================================
+
+/** Distância euclidiana entre dois designs, com cada gene normalizado pelo seu range. */
+static double shape_distance(const Pipeline* p, const double* a, const double* b) {
+    double soma = 0.0;
+    for (int j = 0; j < PIPELINE_SHAPE_DIMS; j++) {
+        double range = p->cfg.shape_max[j] - p->cfg.shape_min[j];
+        double d = (a[j] - b[j]) / (range > 1e-12 ? range : 1.0);
+        soma += d * d;
+    }
+    return sqrt(soma);
+}
+
+/** Coloca uma cópia da vaga na fila e acorda uma thread consumidora. */
+static void enqueue(Pipeline* p, HallEntry* e, int geracao) {
+    PipelineCandidate* c = (PipelineCandidate*)calloc(1, sizeof(PipelineCandidate));
+    memcpy(c->genes, e->genes, sizeof(c->genes));
+    c->fitness_forma = e->fitness;
+    c->geracao = geracao;
+    c->car.L_casco = e->genes[0];
+    c->car.W_casco = e->genes[1];
+    c->car.H_casco = e->genes[2];
+    c->car.L_pod   = e->genes[3];
+    c->car.D_pod   = e->genes[4];
+    c->car.A_solar = e->genes[5];
+    c->car.W_sep   = e->genes[6];
+    e->versao_enfileirada = e->versao;
+
+    pthread_mutex_lock(&p->lock);
+    if (p->n_cand == p->cap_cand) {
+        p->cap_cand = p->cap_cand ? 2 * p->cap_cand : 16;
+        p->cand = (PipelineCandidate**)realloc(p->cand, sizeof(PipelineCandidate*) * p->cap_cand);
+    }
+    c->id = p->n_cand + 1;
+    p->cand[p->n_cand++] = c;
+    pthread_cond_signal(&p->tem_trabalho);
+    pthread_mutex_unlock(&p->lock);
+}
+
+void pipeline_observe(int generation, Individual best, double best_fitness, void* param) {
+    Pipeline* p = (Pipeline*)param;
+    p->ultima_geracao = generation;
+    double g[PIPELINE_SHAPE_DIMS];
+    for (int j = 0; j < PIPELINE_SHAPE_DIMS; j++) g[j] = IND_GENE(best, j);
+
+    // O mesmo design (ou um vizinho) melhora a sua vaga; um design distinto
+    // entra numa vaga livre ou no lugar do pior, se for melhor que ele
+    int perto = -1, pior = -1;
+    double d_min = INFINITY;
+    for (int k = 0; k < p->n_hall; k++) {
+        double d = shape_distance(p, g, p->hall[k].genes);
+        if (d < d_min) { d_min = d; perto = k; }
+        if (pior < 0 || p->hall[k].fitness < p->hall[pior].fitness) pior = k;
+    }
+    HallEntry* alvo = NULL;
+    if (perto >= 0 && d_min < p->cfg.min_distance) {
+        if (best_fitness > p->hall[perto].fitness) alvo = &p->hall[perto];
+    } else if (p->n_hall < p->cfg.top_k) {
+        alvo = &p->hall[p->n_hall++];
+        alvo->versao = -1;
+        alvo->versao_enfileirada = -1;
+    } else if (best_fitness > p->hall[pior].fitness) {
+        alvo = &p->hall[pior];
+        alvo->versao = -1;
+        alvo->versao_enfileirada = -1;
+    }
+    if (alvo) {
+        memcpy(alvo->genes, g, sizeof(g));
+        alvo->fitness = best_fitness;
+        alvo->desde = generation;
+        alvo->versao++;
+    }
+
+    // Durante o Estágio 1 cada vaga vai para a fila uma vez, quando fica estável
+    for (int k = 0; k < p->n_hall; k++) {
+        HallEntry* e = &p->hall[k];
+        if (e->versao_enfileirada < 0 && generation - e->desde >= p->cfg.stable_gens) enqueue(p, e, generation);
+    }
+}
+
+// =============================================================================
+// CONSUMIDORES (ESTÁGIOS 2 E 3 DE CADA CANDIDATO)
+// =============================================================================
+
+static void* pipeline_worker(void* arg) {
+    Pipeline* p = (Pipeline*)arg;
+
+    // Um contexto por estágio por thread, reaproveitado por todos os candidatos
+    GAConfig c2 = p->cfg.strategy;
+    c2.seed = p->cfg.seed_longa;
+    GAConfig c3 = p->cfg.strategy;
+    c3.seed = p->cfg.seed_diaria;
+    GAContext* ctx_longa = ga_context_create(&c2, NULL);
+    GAContext* ctx_diaria = ga_context_create(&c3, NULL);
+
+    for (;;) {
+        pthread_mutex_lock(&p->lock);
+        while (p->proximo == p->n_cand && !p->fechado) pthread_cond_wait(&p->tem_trabalho, &p->lock);
+        if (p->proximo == p->n_cand) { pthread_mutex_unlock(&p->lock); break; }
+        PipelineCandidate* c = p->cand[p->proximo++];
+        pthread_mutex_unlock(&p->lock);
+
+        RaceContext rc;
+        race_context_init(&rc, &c->car);
+        c->estrategia_3000 = ga_context_run(ctx_longa, fitness_strategy_wrapper, fitness_strategy_batch, &rc);
+        c->fitness_3000 = fitness_strategy_wrapper(c->estrategia_3000, &rc);
+        c->prova = race_simulate(&rc, c->estrategia_3000.genes, 3000.0, RACE_MAX_DIAS, NULL);
+        c->estrategia_diaria = ga_context_run(ctx_diaria, fitness_strategy_daily_wrapper, fitness_strategy_daily_batch, &rc);
+        c->alcance_km = race_simulate(&rc, c->estrategia_diaria.genes, INFINITY, 1, NULL).dist_km;
+
+        printf(" [Pipeline] Candidato %d (ger. %d, fit. forma %.4f): 3000 km em %.1f h | alcance diario %.2f km\n",
+               c->id, c->geracao + 1, c->fitness_forma, c->prova.tempo_h, c->alcance_km);
+        fflush(stdout);
+    }
+
+    ga_context_free(ctx_longa);
+    ga_context_free(ctx_diaria);
+    return NULL;
+}
+
+// =============================================================================
+// API PÚBLICA
+// =============================================================================
+
+Pipeline* pipeline_start(const PipelineConfig* cfg) {
+    Pipeline* p = (Pipeline*)calloc(1, sizeof(Pipeline));
+    if (p == NULL) return NULL;
+    p->cfg = *cfg;
+    if (p->cfg.top_k < 1) p->cfg.top_k = 1;
+    if (p->cfg.top_k > PIPELINE_MAX_TOP_K) p->cfg.top_k = PIPELINE_MAX_TOP_K;
+    p->cfg.strategy.log = NULL;
+    p->cfg.strategy.telemetry_phase = 0;
+    p->cfg.strategy.verbose = 0;
+    p->cfg.strategy.on_generation = NULL;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->tem_trabalho, NULL);
+
+    p->n_threads = (cfg->workers > 0) ? cfg->workers : 1;
+    p->threads = (pthread_t*)malloc(sizeof(pthread_t) * p->n_threads);
+    int criadas = 0;
+    while (criadas < p->n_threads && pthread_create(&p->threads[criadas], NULL, pipeline_worker, p) == 0) criadas++;
+    p->n_threads = criadas;
+    return p;
+}
+
+void pipeline_finish(Pipeline* p) {
+    // O melhor design final quase sempre mudou um pouco depois de ir para a fila
+    for (int k = 0; k < p->n_hall; k++) {
+        HallEntry* e = &p->hall[k];
+        if (e->versao != e->versao_enfileirada) enqueue(p, e, p->ultima_geracao);
+    }
+    pthread_mutex_lock(&p->lock);
+    p->fechado = 1;
+    pthread_cond_broadcast(&p->tem_trabalho);
+    pthread_mutex_unlock(&p->lock);
+
+    // Sem nenhuma thread consumidora, a própria thread principal esvazia a fila
+    if (p->n_threads == 0) pipeline_worker(p);
+    for (int t = 0; t < p->n_threads; t++) pthread_join(p->threads[t], NULL);
+}
+
+/** Ordem do ranking: maior fitness do Estágio 2; empate, o que chegou antes. */
+static int candidate_before(const PipelineCandidate* a, const PipelineCandidate* b) {
+    if (a->fitness_3000 != b->fitness_3000) return a->fitness_3000 > b->fitness_3000;
+    return a->id < b->id;
+}
+
+const PipelineCandidate* pipeline_best(const Pipeline* p) {
+    const PipelineCandidate* melhor = NULL;
+    for (int i = 0; i < p->n_cand; i++)
+        if (melhor == NULL || candidate_before(p->cand[i], melhor)) melhor = p->cand[i];
+    return melhor;
+}
+
+void pipeline_print_ranking(const Pipeline* p) {
+    int n = p->n_cand;
+    const PipelineCandidate** ordem = (const PipelineCandidate**)malloc(sizeof(PipelineCandidate*) * (n + 1));
+    for (int i = 0; i < n; i++) {
+        int pos = i;
+        while (pos > 0 && candidate_before(p->cand[i], ordem[pos - 1])) { ordem[pos] = ordem[pos - 1]; pos--; }
+        ordem[pos] = p->cand[i];
+    }
+
+    printf("\n--- PIPELINE: %d candidato(s) do Estagio 1 reavaliados pelo tempo de prova ---\n", n);
+    printf("  #  id  Fit.Forma   Casco(m) Pod(m) Solar(m2)   Tempo 3000km   Alcance diario\n");
+    for (int i = 0; i < n; i++) {
+        const PipelineCandidate* c = ordem[i];
+        printf(" %2d %3d  %10.4f   %6.3f  %6.3f  %6.3f     %6.1f h %s    %7.2f km\n",
+               i + 1, c->id, c->fitness_forma, c->car.L_casco, c->car.D_pod, c->car.A_solar,
+               c->prova.tempo_h, c->prova.dist_km >= 3000.0 ? "   " : "(*)", c->alcance_km);
+    }
+    printf(" (*) nao completou os 3000 km em %d dias\n", RACE_MAX_DIAS);
+    free(ordem);
+}
+
+void pipeline_free(Pipeline* p) {
+    if (p == NULL) return;
+    for (int i = 0; i < p->n_cand; i++) {
+        free(p->cand[i]->estrategia_3000.genes);
+        free(p->cand[i]->estrategia_diaria.genes);
+        free(p->cand[i]);
+    }
+    free(p->cand);
+    free(p->threads);
+    pthread_mutex_destroy(&p->lock);
+    pthread_cond_destroy(&p->tem_trabalho);
+    free(p);
+}
@@ -0,0 +1,75 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+/**
+ * @file pipeline.h
+ * @brief Varredura em pipeline: os K melhores designs do Estágio 1 passam pelos Estágios 2 e 3.
+ * * O objetivo do Estágio 1 (sobra de potência a 22 m/s, sol do meio-dia) não
+ * é o tempo de prova, então o melhor design da Fase 1 não é necessariamente o
+ * carro mais rápido nos 3000 km. O pipeline observa o Estágio 1 (via
+ * GAConfig.on_generation) e mantém um "hall da fama" com os K melhores designs
+ * distintos. Cada design que fica stable_gens gerações sem ser superado entra
+ * numa fila de trabalho; threads consumidoras rodam os Estágios 2 e 3 para ele
+ * enquanto o Estágio 1 continua. No fim do Estágio 1 o que ainda não foi para
+ * a fila (ou mudou depois de ir) é enfileirado, e o vencedor é o candidato com
+ * o maior fitness do Estágio 2 (menor tempo nos 3000 km).
+ */
+
+#include <pthread.h>
+#include "ga_engine.h"
+#include "physics.h"
+
+#define PIPELINE_MAX_TOP_K 32
+#define PIPELINE_SHAPE_DIMS SHAPE_NUM_GENES // Genes da Fase 1 (ver CarDesignOutrigger)
+
+/** @brief Configuração do pipeline. */
+typedef struct {
+    int top_k;                        // Designs distintos mantidos no hall da fama (<= PIPELINE_MAX_TOP_K)
+    int workers;                      // Threads consumidoras da fila
+    int stable_gens;                  // Gerações sem ser superado antes de entrar na fila
+    double min_distance;              // Distância mínima entre designs (genes normalizados pelo range)
+    const double* shape_min;          // Limites dos genes da Fase 1 (normalização da distância)
+    const double* shape_max;
+    GAConfig strategy;                // Base dos Estágios 2 e 3 (9 velocidades); log e telemetria são ignorados
+    unsigned long long seed_longa;    // Sementes dos Estágios 2 e 3 (as mesmas para todo candidato)
+    unsigned long long seed_diaria;
+} PipelineConfig;
+
+/** @brief Um design do Estágio 1 e o resultado dos seus Estágios 2 e 3. */
+typedef struct {
+    int id;                           // Ordem de chegada na fila (1, 2, ...)
+    int geracao;                      // Geração do Estágio 1 em que entrou na fila
+    double genes[PIPELINE_SHAPE_DIMS];
+    double fitness_forma;             // Fitness do Estágio 1
+    CarDesignOutrigger car;
+    Individual estrategia_3000;       // Melhor perfil do Estágio 2 (liberado por pipeline_free)
+    Individual estrategia_diaria;     // Melhor perfil do Estágio 3
+    double fitness_3000;              // Fitness do Estágio 2 (critério do vencedor)
+    RaceState prova;                  // Simulação dos 3000 km com estrategia_3000
+    double alcance_km;                // Alcance diário com estrategia_diaria
+} PipelineCandidate;
+
+typedef struct Pipeline Pipeline;
+
+/** @brief Cria o pipeline e inicia as threads consumidoras (ociosas até a fila receber um design). */
+Pipeline* pipeline_start(const PipelineConfig* cfg);
+
+/**
+ * @brief Observador do Estágio 1 (GaGenerationHook; param = o Pipeline).
+ * Só pode ser chamado por uma thread de cada vez (a do AG do Estágio 1).
+ */
+void pipeline_observe(int generation, Individual best, double best_fitness, void* param);
+
+/** @brief Fim do Estágio 1: enfileira o que falta, fecha a fila e espera as threads. */
+void pipeline_finish(Pipeline* p);
+
+/** @brief Candidato vencedor (maior fitness do Estágio 2; empate: o que chegou antes). */
+const PipelineCandidate* pipeline_best(const Pipeline* p);
+
+/** @brief Tabela com todos os candidatos avaliados, do melhor para o pior. */
+void pipeline_print_ranking(const Pipeline* p);
+
+/** @brief Libera o pipeline e todos os candidatos (chamar depois de pipeline_finish). */
+void pipeline_free(Pipeline* p);
+
+#endif // PIPELINE_H
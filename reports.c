@@ -76,9 +76,11 @@ static void relatorio_velocidade_maxima(const double M_total, const double CdA_t
 // FUNÇÃO PRINCIPAL DE RELATÓRIO
 // ============================================================================
 
-void print_final_summary(const CarDesignOutrigger* car, const Individual* strategy,
+void print_final_summary(const RaceContext* ctx, const Individual* strategy,
                          const double M_total, const double Cd, const double CdA_total, const double A_frontal_total) 
 {
+    const CarDesignOutrigger* car = &ctx->car;
+
     // --- 1. Geração de Timestamp ---
     // Útil para diferenciar logs de execuções diferentes no terminal
     time_t raw_time;
@@ -90,30 +92,22 @@ void print_final_summary(const CarDesignOutrigger* car, const Individual* strate
 
     // --- 2. Detalhamento Aerodinâmico (Breakdown) ---
     // O AG trabalha com totais, mas o engenheiro precisa ver as partes.
-    // Recalculamos os componentes individuais aqui para exibição.
+    // As parcelas saem da mesma memória aerodinâmica (CarAero) usada pela fitness.
     
     // Velocidade média estimada para cálculo do Reynolds
     double avg_speed_ms = 0;
     for(int i=0; i<9; i++) avg_speed_ms += strategy->genes[i];
     avg_speed_ms = fmax(avg_speed_ms / 9.0, 1.0);
 
-    // Componentes de Arrasto (Casco e Pod)
-    double Am_casco = 0, Am_pod = 0;
-    double CdA_casco = calcular_drag_body(car->L_casco, car->W_casco, car->H_casco, avg_speed_ms, &Am_casco);
-    double CdA_pod = calcular_drag_body(car->L_pod, car->D_pod, car->D_pod, avg_speed_ms, &Am_pod);
-    
-    // Componentes de Arrasto (Asa Solar - Placa Plana)
-    // 
-    double A_molhada_wing = 2.0 * car->A_solar; // Cima e baixo
+    // Componentes de Arrasto (Casco, Pod e Asa Solar - Placa Plana)
+    double CdA_parts[3];
+    car_aero_breakdown(&ctx->aero, avg_speed_ms, CdA_parts);
+    double CdA_casco = CdA_parts[0];
+    double CdA_pod = CdA_parts[1];
+    double CdA_wing = CdA_parts[2];
+    double Am_casco = ctx->aero.A_molhada[0];
+    double Am_pod = ctx->aero.A_molhada[1];
     double L_wing_chord = car->A_solar / car->W_sep; // Corda média
-    
-    // Cálculo do Número de Reynolds (Re)
-    double Re_wing = fmax(1.0, (RHO_AIR * avg_speed_ms * L_wing_chord) / MU_AIR);
-    
-    // Coeficiente de fricção (Cf) misto (Laminar + Turbulento)
-    double frac = fmin(0.3, RE_CRIT / Re_wing); // Fração laminar estimada
-    double Cf_w = frac * (1.328/sqrt(Re_wing)) + (1-frac)*(0.074/pow(Re_wing, 0.2));
-    double CdA_wing = Cf_w * A_molhada_wing * 0.5; // Fator de forma simplificado
 
     // Normalização: Quanto cada parte contribui para o Cd total?
     // O fator 1.10 representa 10% de arrasto de interferência entre as peças
@@ -125,69 +119,12 @@ void print_final_summary(const CarDesignOutrigger* car, const Individual* strate
     double A_frontal_casco = (PI/4 * car->W_casco * car->H_casco);
     double A_frontal_pod = (PI/4 * car->D_pod * car->D_pod);
 
-    // --- 3. Re-Simulação da Corrida (Log Detalhado) ---
-    // Reexecutamos a estratégia hora a hora para imprimir o status da bateria e velocidade.
-    // Esta lógica deve ser IDÊNTICA à função de fitness para garantir consistência.
-    
-    double distancia_total_km = 0, tempo_total_horas = 0;
-    double capacidade_bateria_wh = CAPACIDADE_BATERIA_KWH * 1000.0;
-    double bateria_atual_wh = capacidade_bateria_wh;
-    int dias = 0;
-
-    // Loop principal: Corre até completar 3000km ou estourar 10 dias
-    while (distancia_total_km < 3000.0 && dias < 10) {
-        dias++;
-        // Loop diário: 9 horas de sol (ex: 8h às 17h)
-        for (int hora = 0; hora < 9; hora++) {
-            double v_ms = strategy->genes[hora];
-            double v_kmh = v_ms * 3.6;
-            
-            // Entradas Ambientais
-            SolarData sol = get_solar_data(hora);
-            double P_sol = calcular_potencia_solar(sol.irradiance, car->A_solar, sol.T_amb);
-            double P_sol_liq = P_sol * EFF_MPPT; // O que realmente entra na bateria
-
-            // Regra de Proteção: Se bateria < 1%, o carro para para carregar (velocidade 0)
-            if (bateria_atual_wh <= 0.01 * capacidade_bateria_wh) {
-                 bateria_atual_wh += P_sol_liq; 
-                 if (bateria_atual_wh > capacidade_bateria_wh) bateria_atual_wh = capacidade_bateria_wh;
-                 tempo_total_horas += 1.0;
-                 continue; // Pula para a próxima hora
-            }
-
-            // Consumo de Energia
-            double T_asf = temperatura_asfalto(hora, sol.T_amb);
-            double P_res = calcular_potencia_resistiva(v_ms, M_total, CdA_total, T_asf);
-            
-            // Eficiência total do sistema
-            double eta = EFF_MPPT * EFF_DRIVER * eficiencia_motor(P_res) * EFF_TRANS;
-            double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6; // Evita divisão por zero
-            
-            // Balanço Energético (Entra Sol - Sai Motor)
-            double balanco = P_sol_liq - P_bat;
-            
-            // Verificação de pane seca no meio da hora
-            if (balanco < 0 && fabs(balanco) > bateria_atual_wh) {
-                // Carro parou no meio da hora
-                double frac = bateria_atual_wh / fabs(balanco);
-                distancia_total_km += v_kmh * frac;
-                tempo_total_horas += 1.0; // Conta a hora inteira (penalidade implicita)
-                bateria_atual_wh = 0;
-            } else {
-                // Hora completada com sucesso
-                bateria_atual_wh += balanco;
-                // Clamp na capacidade máxima (não sobrecarrega)
-                if (bateria_atual_wh > capacidade_bateria_wh) bateria_atual_wh = capacidade_bateria_wh;
-                distancia_total_km += v_kmh;
-                tempo_total_horas += 1.0;
-            }
-            
-            // Chegada na meta
-            if (distancia_total_km >= 3000.0) break;
-        }
-        // Penalidade noturna (15h paradas + pernoite) se não terminou a corrida
-        if (distancia_total_km < 3000.0) tempo_total_horas += 15.0;
-    }
+    // --- 3. Re-Simulação da Corrida ---
+    // Reexecutamos a estratégia no mesmo simulador usado pela fitness (race_simulate),
+    // então o tempo impresso é exatamente o que o AG otimizou.
+    RaceState corrida = race_simulate(ctx, strategy->genes, 3000.0, RACE_MAX_DIAS, NULL);
+    double distancia_total_km = corrida.dist_km;
+    double tempo_total_horas = corrida.tempo_h;
 
     // --- 4. Impressão Formatada no Console ---
     printf("\n====================================================\n");
@@ -9,21 +9,21 @@
  */
 
 // Dependências necessárias para entender os tipos de dados (structs) usados abaixo
-#include "physics.h"   // Para acessar a struct CarDesignOutrigger
+#include "physics.h"   // Para acessar as structs CarDesignOutrigger e RaceContext
 #include "ga_engine.h" // Para acessar a struct Individual
 
 /**
  * @brief Exibe o relatório final do melhor veículo encontrado.
  * * Esta função formata e imprime no console os dados cruciais do design,
  * incluindo aerodinâmica, massa e parâmetros genéticos.
- * * @param car Ponteiro para a estrutura física do carro (dimensões, rodas, etc).
+ * * @param ctx Contexto de corrida do carro (geometria, ambiente e memória aerodinâmica).
  * @param strategy Ponteiro para o indivíduo do AG (contém o genótipo/cromossomo).
  * @param M_total Massa total calculada do veículo (em kg).
  * @param Cd Coeficiente de arrasto (adimensional).
  * @param CdA_total Área de arrasto efetiva (Cd * Área Frontal).
  * @param A_frontal_total Área frontal projetada do veículo (em m²).
  */
-void print_final_summary(const CarDesignOutrigger* car, 
+void print_final_summary(const RaceContext* ctx, 
                          const Individual* strategy,
                          const double M_total, 
                          const double Cd, 
@@ -0,0 +1,38 @@
+#include "rng.h"
+
+// SplitMix64: espalha a semente do usuário pelos 256 bits do estado
+static uint64_t splitmix64(uint64_t* x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(RngState* rng, uint64_t seed) {
+    uint64_t x = seed;
+    for (int i = 0; i < 4; i++) rng->s[i] = splitmix64(&x);
+}
+
+void rng_jump(RngState* rng) {
+    // Polinômio de salto oficial do xoshiro256** (2^128 passos)
+    static const uint64_t JUMP[] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (JUMP[i] & (1ULL << b)) {
+                s0 ^= rng->s[0]; s1 ^= rng->s[1];
+                s2 ^= rng->s[2]; s3 ^= rng->s[3];
+            }
+            rng_next(rng);
+        }
+    }
+    rng->s[0] = s0; rng->s[1] = s1; rng->s[2] = s2; rng->s[3] = s3;
+}
+
+void rng_seed_stream(RngState* rng, uint64_t seed, uint64_t stream) {
+    rng_seed(rng, seed);
+    for (uint64_t k = 0; k < stream; k++) rng_jump(rng);
+}
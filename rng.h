@@ -0,0 +1,95 @@
+#ifndef RNG_H
+#define RNG_H
+
+/**
+ * @file rng.h
+ * @brief Gerador de Números Pseudoaleatórios reentrante (xoshiro256**).
+ * * Substitui o rand() global da libc. Cada thread (ou cada execução do AG)
+ * carrega o seu próprio RngState, então não há trava interna nem estado
+ * escondido: a mesma semente sempre reproduz a mesma sequência, bit a bit.
+ * * As funções do caminho quente são 'static inline' para o compilador
+ * poder embuti-las dentro dos laços de mutação.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Estado do gerador (256 bits).
+ * Nunca deve ser todo zero; use rng_seed() para inicializar.
+ */
+typedef struct {
+    uint64_t s[4];
+} RngState;
+
+/**
+ * @brief Inicializa o estado a partir de uma semente de 64 bits (via SplitMix64).
+ * Sementes vizinhas (1, 2, 3...) geram sequências descorrelacionadas.
+ */
+void rng_seed(RngState* rng, uint64_t seed);
+
+/**
+ * @brief Inicializa um fluxo independente (ex: um por thread).
+ * Equivale a rng_seed(seed) seguido de 'stream' saltos de 2^128 passos,
+ * garantindo que fluxos diferentes nunca se sobreponham.
+ */
+void rng_seed_stream(RngState* rng, uint64_t seed, uint64_t stream);
+
+/** @brief Avança o estado em 2^128 passos (separação de fluxos paralelos). */
+void rng_jump(RngState* rng);
+
+static inline uint64_t rng_rotl(const uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/** @brief Próximo inteiro de 64 bits (xoshiro256**). */
+static inline uint64_t rng_next(RngState* rng) {
+    uint64_t* s = rng->s;
+    const uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+/** @brief Real uniforme em [0, 1) com 53 bits de precisão. */
+static inline double rng_uniform(RngState* rng) {
+    return (double)(rng_next(rng) >> 11) * 0x1.0p-53;
+}
+
+/** @brief Inteiro uniforme em [0, n). Usa multiplicação (sem viés do operador %). */
+static inline int rng_below(RngState* rng, int n) {
+    return (int)(((rng_next(rng) >> 32) * (uint64_t)n) >> 32);
+}
+
+/**
+ * @brief Gerador sem estado: inteiro de 64 bits da posição 'contador' do fluxo
+ * 'chave' (SplitMix64 de chave + contador).
+ * * Cada sorteio só depende do seu próprio índice, então um laço paralelo (ex:
+ * no dispositivo, ver ga_device.h) sorteia os mesmos números em qualquer ordem
+ * ou número de threads. Fluxos diferentes: chaves vindas de rng_counter_key.
+ */
+static inline uint64_t rng_counter_next(uint64_t chave, uint64_t contador) {
+    uint64_t z = chave + (contador + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/** @brief rng_counter_next como real uniforme em [0, 1) com 53 bits de precisão. */
+static inline double rng_counter_uniform(uint64_t chave, uint64_t contador) {
+    return (double)(rng_counter_next(chave, contador) >> 11) * 0x1.0p-53;
+}
+
+/** @brief Chave de um fluxo de rng_counter_uniform a partir de (semente, fluxo). */
+static inline uint64_t rng_counter_key(uint64_t seed, uint64_t fluxo) {
+    uint64_t z = seed ^ (fluxo * 0xD1B54A32D192ED03ULL);
+    z = (z ^ (z >> 33)) * 0xFF51AFD7ED558CCDULL;
+    z = (z ^ (z >> 33)) * 0xC4CEB9FE1A85EC53ULL;
+    return z ^ (z >> 33);
+}
+
+#endif // RNG_H
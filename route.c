@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "route.h"
+
+// =============================================================================
+// ARQUIVO DE ROTA
+// =============================================================================
+
+int route_open(Route* r, const char* path) {
+    memset(r, 0, sizeof(*r));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) { fprintf(stderr, "ERRO: rota %s nao encontrada\n", path); return -1; }
+    struct stat sb;
+    if (fstat(fd, &sb) != 0 || (size_t)sb.st_size < sizeof(RouteFileHeader)) {
+        fprintf(stderr, "ERRO: rota %s vazia ou ilegivel\n", path);
+        close(fd);
+        return -1;
+    }
+    void* mapa = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // O mapeamento continua valendo sem o descritor
+    if (mapa == MAP_FAILED) { fprintf(stderr, "ERRO: mmap da rota %s falhou\n", path); return -1; }
+    r->mapa = mapa;
+    r->tamanho = (size_t)sb.st_size;
+    r->h = (const RouteFileHeader*)mapa;
+
+    const RouteFileHeader* h = r->h;
+    const char* erro = NULL;
+    if (memcmp(h->magic, ROUTE_MAGIC, 8) != 0) erro = "assinatura invalida";
+    else if (h->versao != ROUTE_VERSION) erro = "versao nao suportada";
+    else if (h->header_bytes < sizeof(RouteFileHeader) || h->trecho_bytes < sizeof(RouteSegment) ||
+             h->amostra_bytes < sizeof(RouteSample)) erro = "registros menores que o esperado";
+    else if (h->n_trechos == 0 || h->n_amostras == 0 || !(h->ds_m > 0) || !(h->dt_amostra_s > 0)) erro = "rota vazia";
+    else if ((size_t)h->header_bytes + (size_t)h->n_trechos * h->trecho_bytes +
+             (size_t)h->n_amostras * h->amostra_bytes > r->tamanho) erro = "arquivo truncado";
+    if (erro) {
+        fprintf(stderr, "ERRO: rota %s: %s\n", path, erro);
+        route_close(r);
+        return -1;
+    }
+    r->trechos = (const unsigned char*)mapa + h->header_bytes;
+    r->amostras = r->trechos + (size_t)h->n_trechos * h->trecho_bytes;
+    return 0;
+}
+
+void route_close(Route* r) {
+    if (r->mapa) munmap(r->mapa, r->tamanho);
+    memset(r, 0, sizeof(*r));
+}
+
+double route_length_km(const Route* r) {
+    return r->h->n_trechos * r->h->ds_m / 1000.0;
+}
+
+int route_write_synthetic(const char* path, double km, double ds_m, double dt_amostra_s, int n_dias) {
+    FILE* f = fopen(path, "wb");
+    if (f == NULL) return -1;
+    RouteFileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, ROUTE_MAGIC, 8);
+    h.versao = ROUTE_VERSION;
+    h.header_bytes = sizeof(RouteFileHeader);
+    h.n_trechos = (uint32_t)ceil(km * 1000.0 / ds_m);
+    h.trecho_bytes = sizeof(RouteSegment);
+    int por_dia = (int)(RACE_HORAS_DIA * 3600.0 / dt_amostra_s);
+    h.n_amostras = (uint32_t)(por_dia * n_dias);
+    h.amostra_bytes = sizeof(RouteSample);
+    h.ds_m = ds_m;
+    h.dt_amostra_s = dt_amostra_s;
+    h.hora_inicio = 8.0;
+    h.horas_por_dia = RACE_HORAS_DIA;
+
+    int ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    RouteSegment s = {0.0f, 0.0f, {0.0f, 0.0f}}; // Plana, sem vento
+    for (uint32_t i = 0; ok && i < h.n_trechos; i++) ok = fwrite(&s, sizeof(s), 1, f) == 1;
+    for (int d = 0; ok && d < n_dias; d++) {
+        for (int k = 0; ok && k < por_dia; k++) {
+            SolarData sol = get_solar_data((int)(k * dt_amostra_s / 3600.0));
+            RouteSample a = {(float)sol.irradiance, (float)sol.T_amb, {0.0f, 0.0f}};
+            ok = fwrite(&a, sizeof(a), 1, f) == 1;
+        }
+    }
+    ok = (fclose(f) == 0) && ok;
+    return ok ? 0 : -1;
+}
+
+// =============================================================================
+// CONTEXTO PRÉ-CALCULADO (uma vez por execução)
+// =============================================================================
+
+/** Temperatura do asfalto no instante hora_do_dia (h, contínua): o modelo de temperatura_asfalto. */
+static double asfalto_continuo(double hora_do_dia, double T_amb) {
+    double delta_T = 20.0 * sin(PI * (hora_do_dia - 6) / 12.0);
+    return T_amb + fmax(0, delta_T);
+}
+
+int route_context_init(RouteContext* rc, const RaceContext* race, const Route* r, double dt_s) {
+    memset(rc, 0, sizeof(*rc));
+    const RouteFileHeader* h = r->h;
+    int passos_hora = (int)lround(3600.0 / dt_s);
+    if (dt_s <= 0 || passos_hora < 1 || fabs(passos_hora * dt_s - 3600.0) > 1e-9) {
+        fprintf(stderr, "ERRO: o passo da rota (%g s) tem de dividir 3600 s\n", dt_s);
+        return -1;
+    }
+    if (fabs(h->horas_por_dia - RACE_HORAS_DIA) > 1e-9) {
+        fprintf(stderr, "ERRO: a rota tem %g h de prova por dia; o perfil de velocidades tem %d\n",
+                h->horas_por_dia, RACE_HORAS_DIA);
+        return -1;
+    }
+    int amostras_dia = (int)lround(h->horas_por_dia * 3600.0 / h->dt_amostra_s);
+    if (amostras_dia < 1) amostras_dia = 1;
+
+    rc->race = race;
+    rc->dt_s = dt_s;
+    rc->passos_hora = passos_hora;
+    rc->passos_dia = RACE_HORAS_DIA * passos_hora;
+    rc->n_dias = (int)(h->n_amostras / amostras_dia);
+    if (rc->n_dias < 1) rc->n_dias = 1;
+    if (rc->n_dias > RACE_MAX_DIAS) rc->n_dias = RACE_MAX_DIAS;
+
+    // Clima na grade do passo: amostra vigente no início de cada passo
+    size_t n_passos = (size_t)rc->n_dias * rc->passos_dia;
+    rc->P_sol_liq = (double*)malloc(sizeof(double) * n_passos);
+    rc->crr_fator_temp = (double*)malloc(sizeof(double) * n_passos);
+    for (int d = 0; d < rc->n_dias; d++) {
+        for (int k = 0; k < rc->passos_dia; k++) {
+            double t = k * dt_s;
+            int a = (int)(t / h->dt_amostra_s);
+            if (a >= amostras_dia) a = amostras_dia - 1;
+            size_t idx = (size_t)d * amostras_dia + a;
+            if (idx >= h->n_amostras) idx = h->n_amostras - 1;
+            const RouteSample* s = ROUTE_SAMPLE(r, idx);
+            double T_asf = asfalto_continuo(h->hora_inicio + t / 3600.0, s->T_amb);
+            rc->P_sol_liq[(size_t)d * rc->passos_dia + k] =
+                calcular_potencia_solar(s->irradiancia, race->car.A_solar, s->T_amb) * EFF_MPPT;
+            rc->crr_fator_temp[(size_t)d * rc->passos_dia + k] = 1 + CR_TEMP_COEFF * (T_asf - 25);
+        }
+    }
+
+    // Estrada: forças que só dependem do trecho (a massa do carro é fixa)
+    rc->n_trechos = (int)h->n_trechos;
+    rc->inv_ds = 1.0 / h->ds_m;
+    rc->comprimento_km = route_length_km(r);
+    rc->F_rampa = (double*)malloc(sizeof(double) * rc->n_trechos);
+    rc->F_rolamento = (double*)malloc(sizeof(double) * rc->n_trechos);
+    rc->vento = (double*)malloc(sizeof(double) * rc->n_trechos);
+    double Mg = race->aero.M_tot * GRAVITY;
+    for (int i = 0; i < rc->n_trechos; i++) {
+        const RouteSegment* s = ROUTE_SEGMENT(r, i);
+        double theta = atan(s->rampa);
+        rc->F_rampa[i] = Mg * sin(theta);
+        rc->F_rolamento[i] = CR_ROLLING_BASE * Mg * cos(theta);
+        rc->vento[i] = s->vento_ms;
+    }
+    return 0;
+}
+
+void route_context_free(RouteContext* rc) {
+    free(rc->P_sol_liq);
+    free(rc->crr_fator_temp);
+    free(rc->F_rampa);
+    free(rc->F_rolamento);
+    free(rc->vento);
+    memset(rc, 0, sizeof(*rc));
+}
+
+// =============================================================================
+// SIMULADOR COM PASSO FINO
+// =============================================================================
+
+RaceState route_simulate(const RouteContext* rc, const double* perfil_v, double meta_km, int max_dias) {
+    RaceState st = {0.0, 0.0, CAPACIDADE_BATERIA_KWH * 1000.0, 0};
+    const double cap_bat = st.bat_wh; // Wh
+    const double dt_h = rc->dt_s / 3600.0;
+    if (max_dias > RACE_MAX_DIAS) max_dias = RACE_MAX_DIAS;
+    if (meta_km > rc->comprimento_km) meta_km = rc->comprimento_km;
+
+    // CdA na velocidade média (como em race_simulate) e termos de cada hora
+    double avg_v = 0;
+    for (int i = 0; i < RACE_HORAS_DIA; i++) avg_v += perfil_v[i];
+    avg_v = fmax(avg_v / RACE_HORAS_DIA, 1.0);
+    double k_arrasto = 0.5 * RHO_AIR * car_aero_cda(&rc->race->aero, avg_v);
+    double fator_vel[RACE_HORAS_DIA];
+    for (int h = 0; h < RACE_HORAS_DIA; h++) fator_vel[h] = 1 + CR_SPEED_COEFF * (perfil_v[h] * 3.6);
+
+    const double meta_m = meta_km * 1000.0;
+    const int ultimo = rc->n_trechos - 1;
+    double s_m = 0.0; // Posição na rota (m)
+
+    while (s_m < meta_m && st.dias < max_dias) {
+        st.dias++;
+        int d = (st.dias <= rc->n_dias ? st.dias : rc->n_dias) - 1;
+        const double* P_sol = rc->P_sol_liq + (size_t)d * rc->passos_dia;
+        const double* fator_temp = rc->crr_fator_temp + (size_t)d * rc->passos_dia;
+
+        int k;
+        for (k = 0; k < rc->passos_dia && s_m < meta_m; k++) {
+            if (st.bat_wh <= 0.01 * cap_bat) {
+                // Bateria vazia (<1%): fica parado carregando
+                st.bat_wh += P_sol[k] * dt_h;
+                if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
+                continue;
+            }
+            int h = k / rc->passos_hora;
+            double v = perfil_v[h];
+            int i = (int)(s_m * rc->inv_ds);
+            if (i > ultimo) i = ultimo;
+
+            double v_ar = v + rc->vento[i];
+            double F = k_arrasto * v_ar * fabs(v_ar)
+                     + rc->F_rolamento[i] * fator_vel[h] * fator_temp[k]
+                     + rc->F_rampa[i];
+            double P_res = fmax(F * v, 0.0); // Sem regeneração nas descidas
+            double eta = EFF_MPPT * EFF_DRIVER * physics_motor_eff(P_res) * EFF_TRANS;
+            double P_bat = (eta > 1e-6) ? (P_res / eta) : 1e6;
+            double balanco_wh = (P_sol[k] - P_bat) * dt_h;
+
+            if (balanco_wh < 0 && -balanco_wh > st.bat_wh) {
+                // Morreu no meio do passo: anda a fração e fica parado o resto
+                s_m += v * rc->dt_s * (st.bat_wh / -balanco_wh);
+                st.bat_wh = 0;
+            } else {
+                st.bat_wh += balanco_wh;
+                if (st.bat_wh > cap_bat) st.bat_wh = cap_bat;
+                s_m += v * rc->dt_s;
+            }
+        }
+        st.tempo_h += k * dt_h; // O dia inteiro de prova, ou até o passo da chegada
+        if (s_m < meta_m) st.tempo_h += 15.0; // Penalidade noturna (15h de noite)
+    }
+    st.dist_km = s_m / 1000.0;
+    return st;
+}
+
+// =============================================================================
+// FITNESS DO ESTÁGIO 2 NA ROTA
+// =============================================================================
+
+static double route_fitness_core(const StrategyGenes* perfil, const RouteContext* rc) {
+    double meta_km = fmin(3000.0, rc->comprimento_km);
+    RaceState st = route_simulate(rc, perfil->v, meta_km, RACE_MAX_DIAS);
+    if (st.dist_km >= meta_km) return meta_km + (1000.0 / st.tempo_h); // Bônus por terminar rápido
+    return st.dist_km;
+}
+
+double fitness_strategy_route_wrapper(Individual ind, const void* param) {
+    StrategyGenes perfil = strategy_genes_load(ind);
+    return route_fitness_core(&perfil, (const RouteContext*)param);
+}
+
+void fitness_strategy_route_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param) {
+    const RouteContext* rc = (const RouteContext*)param;
+    for (int i = begin; i < end; i++) {
+        StrategyGenes perfil = strategy_genes_at(genes, i);
+        out[i] = route_fitness_core(&perfil, rc);
+    }
+}
@@ -0,0 +1,136 @@
+#ifndef ROUTE_H
+#define ROUTE_H
+
+/**
+ * @file route.h
+ * @brief Perfil de rota (arquivo binário) e simulador de prova com passo fino.
+ * * O simulador hora a hora (race_simulate) usa a tabela fixa de get_solar_data
+ * e uma estrada plana sem vento. Com uma rota, a prova é integrada em passos de
+ * dt segundos: a rampa e o vento vêm do trecho em que o carro está (posição) e
+ * a irradiância e a temperatura, da amostra de clima do instante (tempo).
+ * * Formato do arquivo (binário, ordem de bytes da máquina):
+ *   RouteFileHeader (header_bytes)
+ *   n_trechos  x RouteSegment (trecho_bytes cada, stride fixo)
+ *   n_amostras x RouteSample  (amostra_bytes cada, stride fixo)
+ * Os strides ficam no cabeçalho: versões futuras podem acrescentar campos ao
+ * fim de cada registro sem quebrar leitores antigos.
+ * * O arquivo é mapeado em memória (mmap) e lido uma única vez, em sequência,
+ * por route_context_init, que monta vetores SoA já na grade do passo dt. O laço
+ * da fitness só faz aritmética sobre esses vetores (sem libm, sem desvios além
+ * do estado da bateria); o custo cresce com 3600/dt passos por hora de prova.
+ */
+
+#include <stdint.h>
+#include "physics.h"
+
+#define ROUTE_MAGIC "SOLROTA1"
+#define ROUTE_VERSION 1
+
+/** @brief Cabeçalho do arquivo de rota. */
+typedef struct {
+    char magic[8];           // ROUTE_MAGIC
+    uint32_t versao;         // ROUTE_VERSION
+    uint32_t header_bytes;   // Tamanho deste cabeçalho (os trechos começam aqui)
+    uint32_t n_trechos;      // Trechos de estrada, todos com ds_m de comprimento
+    uint32_t trecho_bytes;   // Stride de RouteSegment
+    uint32_t n_amostras;     // Amostras de clima (dias inteiros, um após o outro)
+    uint32_t amostra_bytes;  // Stride de RouteSample
+    double ds_m;             // Comprimento de cada trecho (m)
+    double dt_amostra_s;     // Intervalo entre amostras de clima (s; ex: 60)
+    double hora_inicio;      // Hora do dia da primeira amostra de cada dia (ex: 8.0)
+    double horas_por_dia;    // Horas de prova por dia (tem de ser RACE_HORAS_DIA)
+} RouteFileHeader;
+
+/** @brief Um trecho de estrada. */
+typedef struct {
+    float rampa;             // Inclinação (subida/distância; > 0 = subida)
+    float vento_ms;          // Vento contra o carro (m/s; < 0 = a favor)
+    float reservado[2];
+} RouteSegment;
+
+/** @brief Uma amostra de clima. */
+typedef struct {
+    float irradiancia;       // Irradiância global (W/m^2)
+    float T_amb;             // Temperatura ambiente (°C)
+    float reservado[2];
+} RouteSample;
+
+/** @brief Arquivo de rota aberto (mapeado em memória). */
+typedef struct {
+    void* mapa;
+    size_t tamanho;
+    const RouteFileHeader* h;
+    const unsigned char* trechos;  // Primeiro RouteSegment
+    const unsigned char* amostras; // Primeira RouteSample
+} Route;
+
+/** @brief Trecho i da rota (respeita o stride do arquivo). */
+#define ROUTE_SEGMENT(r, i) ((const RouteSegment*)((r)->trechos + (size_t)(i) * (r)->h->trecho_bytes))
+/** @brief Amostra k da rota (respeita o stride do arquivo). */
+#define ROUTE_SAMPLE(r, k) ((const RouteSample*)((r)->amostras + (size_t)(k) * (r)->h->amostra_bytes))
+
+/**
+ * @brief Abre e valida um arquivo de rota (mmap somente leitura).
+ * @return 0 em sucesso; -1 se não existir ou for inválido (mensagem em stderr).
+ */
+int route_open(Route* r, const char* path);
+
+/** @brief Desfaz o mapeamento do arquivo. */
+void route_close(Route* r);
+
+/** @brief Comprimento total da rota (km). */
+double route_length_km(const Route* r);
+
+/**
+ * @brief Grava uma rota sintética: estrada plana, sem vento, e o clima de
+ * get_solar_data (constante dentro de cada hora) repetido por n_dias dias.
+ * Com dt divisor de 3600 s, a simulação nela reproduz race_simulate.
+ * @return 0 em sucesso, -1 em erro de escrita.
+ */
+int route_write_synthetic(const char* path, double km, double ds_m, double dt_amostra_s, int n_dias);
+
+/**
+ * @brief Ambiente da rota pré-calculado para um carro e um passo dt (um por execução).
+ * * Tudo o que não depende das velocidades (genes) vira vetor SoA: por passo do
+ * dia, a potência solar líquida e o fator térmico do Crr; por trecho, a força
+ * de rampa, a força normal vezes Crr base e o vento.
+ */
+typedef struct {
+    const RaceContext* race;     // Carro (aerodinâmica e massa); tem de viver mais que o contexto
+    double dt_s;                 // Passo da integração (s; divide 3600)
+    int passos_hora;             // 3600 / dt_s
+    int passos_dia;              // RACE_HORAS_DIA * passos_hora
+    int n_dias;                  // Dias de clima disponíveis (depois do último, repete o último)
+    double* P_sol_liq;           // [n_dias * passos_dia] Potência solar líquida (W), já com EFF_MPPT
+    double* crr_fator_temp;      // [n_dias * passos_dia] 1 + CR_TEMP_COEFF * (T_asf - 25)
+    int n_trechos;
+    double inv_ds;               // 1 / ds_m
+    double comprimento_km;
+    double* F_rampa;             // [n_trechos] M g sin(theta) (N)
+    double* F_rolamento;         // [n_trechos] CR_ROLLING_BASE * M g cos(theta) (N)
+    double* vento;               // [n_trechos] Vento contra (m/s)
+} RouteContext;
+
+/**
+ * @brief Monta o contexto da rota para o carro de 'race' com passo dt_s.
+ * @return 0 em sucesso; -1 se dt_s não dividir 3600 ou a rota não tiver RACE_HORAS_DIA horas por dia.
+ */
+int route_context_init(RouteContext* rc, const RaceContext* race, const Route* r, double dt_s);
+
+/** @brief Libera os vetores do contexto. */
+void route_context_free(RouteContext* rc);
+
+/**
+ * @brief Simula a prova na rota com o perfil horário perfil_v (RACE_HORAS_DIA velocidades).
+ * Corre até 'meta_km' (limitada ao fim da rota) ou 'max_dias' dias, com as
+ * mesmas regras de race_simulate: parado carregando abaixo de 1% de bateria,
+ * passo parcial quando a bateria acaba e 15 h de noite entre os dias.
+ */
+RaceState route_simulate(const RouteContext* rc, const double* perfil_v, double meta_km, int max_dias);
+
+// Fitness do Estágio 2 na rota ('param' aponta para um RouteContext): mesma
+// pontuação de fitness_strategy_wrapper, com a meta limitada ao comprimento da rota.
+double fitness_strategy_route_wrapper(Individual ind, const void* param);
+void fitness_strategy_route_batch(const GeneMatrix* genes, int begin, int end, double* out, const void* param);
+
+#endif // ROUTE_H
@@ -0,0 +1,507 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <pthread.h>
+#include "ga_engine.h"
+#include "ga_log.h"
+#include "physics.h"
+
+/**
+ * @file runner.c
+ * @brief Executor de experimentos: uma grade de configurações x sementes do AG
+ * rodando em paralelo, com uma tabela única de resultados ('make runner').
+ * * A configuração vem de um arquivo (--config ARQ) e/ou da linha de comando
+ * (--chave valor, com '-' ou '_'); a linha de comando vence. Cada linha do
+ * arquivo é "chave = valor" ('#' comenta o resto da linha). Uma lista separada
+ * por vírgulas vira um eixo da grade: o executor roda o produto cartesiano de
+ * todos os eixos, cada combinação com todas as sementes.
+ *   fase = 1, 2               # 1 = forma, 2 = estratégia 3000 km, 3 = alcance diário
+ *   population = 200, 1000
+ *   layout = aos, soa
+ *   seeds = 1-8
+ * * Vetores (gene_min, gene_max, car) separam os números por espaços; um só
+ * número vale para todos os genes. Cada execução é uma população própria
+ * (GAContext), sem logs por padrão, com 'threads' núcleos (padrão 1), e 'jobs'
+ * execuções correm ao mesmo tempo (padrão: núcleos / threads).
+ * * Saída: uma linha por execução em 'out' (CSV, padrão runner.csv) e, no
+ * terminal, a média de cada combinação sobre as sementes.
+ */
+
+#define RUNNER_MAX_KEYS 64
+#define RUNNER_MAX_VALUES 32
+#define RUNNER_MAX_SEEDS 4096
+#define RUNNER_MAX_DIMS 9
+
+// =============================================================================
+// CONFIGURAÇÃO (chaves e listas de valores)
+// =============================================================================
+
+/** @brief Uma chave da configuração e os seus valores (mais de um = eixo da grade). */
+typedef struct {
+    char nome[32];
+    char* valores[RUNNER_MAX_VALUES];
+    int n;
+} RunnerKey;
+
+typedef struct {
+    RunnerKey chaves[RUNNER_MAX_KEYS];
+    int n;
+} RunnerSpec;
+
+static char* trim(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* fim = s + strlen(s);
+    while (fim > s && isspace((unsigned char)fim[-1])) *--fim = '\0';
+    return s;
+}
+
+static RunnerKey* spec_find(RunnerSpec* spec, const char* nome) {
+    for (int k = 0; k < spec->n; k++)
+        if (strcmp(spec->chaves[k].nome, nome) == 0) return &spec->chaves[k];
+    return NULL;
+}
+
+static const char* spec_get(RunnerSpec* spec, const char* nome, const char* padrao) {
+    RunnerKey* k = spec_find(spec, nome);
+    return (k && k->n > 0) ? k->valores[0] : padrao;
+}
+
+/** Define (ou substitui) a lista de valores de uma chave: "a, b, c". */
+static int spec_set(RunnerSpec* spec, const char* nome_bruto, const char* valor) {
+    char nome[32];
+    snprintf(nome, sizeof(nome), "%s", nome_bruto);
+    for (char* c = nome; *c; c++) if (*c == '-') *c = '_';
+    RunnerKey* k = spec_find(spec, nome);
+    if (k == NULL) {
+        if (spec->n >= RUNNER_MAX_KEYS) return -1;
+        k = &spec->chaves[spec->n++];
+        snprintf(k->nome, sizeof(k->nome), "%s", nome);
+    }
+    for (int v = 0; v < k->n; v++) free(k->valores[v]);
+    k->n = 0;
+    char* copia = strdup(valor);
+    for (char* parte = strtok(copia, ","); parte; parte = strtok(NULL, ",")) {
+        if (k->n >= RUNNER_MAX_VALUES) { free(copia); return -1; }
+        k->valores[k->n++] = strdup(trim(parte));
+    }
+    free(copia);
+    return (k->n > 0) ? 0 : -1;
+}
+
+/** Lê um arquivo de configuração ("chave = valor" por linha). */
+static int spec_load(RunnerSpec* spec, const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f == NULL) { fprintf(stderr, "ERRO: nao foi possivel abrir %s\n", path); return -1; }
+    char linha[1024];
+    int n_linha = 0;
+    while (fgets(linha, sizeof(linha), f)) {
+        n_linha++;
+        char* comentario = strchr(linha, '#');
+        if (comentario) *comentario = '\0';
+        char* s = trim(linha);
+        if (*s == '\0') continue;
+        char* igual = strchr(s, '=');
+        if (igual == NULL) {
+            fprintf(stderr, "ERRO: %s:%d: esperado 'chave = valor'\n", path, n_linha);
+            fclose(f);
+            return -1;
+        }
+        *igual = '\0';
+        if (spec_set(spec, trim(s), trim(igual + 1)) != 0) {
+            fprintf(stderr, "ERRO: %s:%d: valor invalido (ou chaves/valores demais)\n", path, n_linha);
+            fclose(f);
+            return -1;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+static void spec_free(RunnerSpec* spec) {
+    for (int k = 0; k < spec->n; k++)
+        for (int v = 0; v < spec->chaves[k].n; v++) free(spec->chaves[k].valores[v]);
+    spec->n = 0;
+}
+
+/** Sementes: "1-8", "5" ou "1, 3, 10-12". */
+static int parse_seeds(RunnerKey* k, unsigned long long* seeds, int max) {
+    int n = 0;
+    for (int v = 0; v < k->n; v++) {
+        unsigned long long a, b;
+        if (sscanf(k->valores[v], "%llu-%llu", &a, &b) == 2) {
+            for (unsigned long long s = a; s <= b && n < max; s++) seeds[n++] = s;
+        } else if (sscanf(k->valores[v], "%llu", &a) == 1 && n < max) {
+            seeds[n++] = a;
+        } else {
+            return -1;
+        }
+    }
+    return n;
+}
+
+// =============================================================================
+// EXECUÇÕES
+// =============================================================================
+
+/** @brief Uma execução da grade: configuração completa e resultado. */
+typedef struct {
+    int id;
+    int combinacao;             // Índice da combinação da grade (agrupa as sementes)
+    char rotulo[256];           // Só os eixos da grade ("population=200;layout=soa")
+    int fase;
+    GAConfig cfg;
+    GaIslandConfig ilhas;
+    double gene_min[RUNNER_MAX_DIMS], gene_max[RUNNER_MAX_DIMS];
+    double ref_speed_ms;        // Fase 1
+    CarDesignOutrigger car;     // Fases 2 e 3
+    char log_path[256];         // Vazio = sem log
+    // Resultado
+    GaRunStats stats;
+    double melhor_fitness;
+} RunnerJob;
+
+/** Lê "x" ou "x1 x2 ... xd" em v (d valores). */
+static int parse_vector(const char* s, double* v, int d) {
+    int n = 0;
+    char* fim;
+    for (const char* p = s; n < d; p = fim) {
+        double x = strtod(p, &fim);
+        if (fim == p) break;
+        v[n++] = x;
+    }
+    if (n == 1) for (int j = 1; j < d; j++) v[j] = v[0];
+    return (n == 1 || n == d) ? 0 : -1;
+}
+
+static int parse_int_value(const char* s, int* out) {
+    char* fim;
+    long x = strtol(s, &fim, 10);
+    if (fim == s || *trim(fim) != '\0') return -1;
+    *out = (int)x;
+    return 0;
+}
+
+static int parse_double_value(const char* s, double* out) {
+    char* fim;
+    double x = strtod(s, &fim);
+    if (fim == s || *trim(fim) != '\0') return -1;
+    *out = x;
+    return 0;
+}
+
+/** Valores padrão de uma execução (os mesmos do main.c). */
+static void job_defaults(RunnerJob* job) {
+    memset(job, 0, sizeof(*job));
+    job->fase = 1;
+    job->cfg = ga_config_from_globals();
+    job->cfg.population_size = 1000;
+    job->cfg.max_generations = 100000;
+    job->cfg.num_threads = 1;
+    job->cfg.verbose = 0;
+    job->cfg.telemetry_phase = 0;
+    job->cfg.log = NULL;
+    job->cfg.checkpoint_path = NULL;
+    job->cfg.checkpoint_every = 0;
+    job->cfg.stop.stagnation_gens = 10000;
+    job->cfg.stop.min_resets = 20;
+    job->ilhas = (GaIslandConfig){1, 50, 2, GA_TOPOLOGY_RING};
+    job->ref_speed_ms = 22.0;
+    // Um carro no meio do espaço de busca (o mesmo do bench)
+    job->car.L_casco = 4.4; job->car.W_casco = 0.75; job->car.H_casco = 1.0;
+    job->car.L_pod = 2.2; job->car.D_pod = 0.6; job->car.A_solar = 5.0; job->car.W_sep = 1.8;
+}
+
+/** Limites padrão dos genes de cada fase (os mesmos do main.c). */
+static void job_default_bounds(RunnerJob* job) {
+    static const double shape_min[7] = {3.0, MIN_CASCO_WIDTH, MIN_CASCO_HEIGHT, 1.5, MIN_POD_DIAMETER, 4.0,
+                                        MIN_CASCO_WIDTH + MIN_POD_DIAMETER + MIN_COMPONENT_SEP};
+    static const double shape_max[7] = {5.8, 0.9, 1.2, 3.0, 0.7, 6.0, MAX_VEHICLE_WIDTH};
+    job->cfg.num_dimensions = (job->fase == 1) ? 7 : 9;
+    for (int j = 0; j < job->cfg.num_dimensions; j++) {
+        job->gene_min[j] = (job->fase == 1) ? shape_min[j] : 15.0;
+        job->gene_max[j] = (job->fase == 1) ? shape_max[j] : 25.0;
+    }
+}
+
+/**
+ * Aplica uma chave à execução.
+ * @return 0 em sucesso, -1 valor inválido, -2 chave desconhecida.
+ */
+static int job_apply(RunnerJob* job, const char* nome, const char* valor) {
+    GAConfig* c = &job->cfg;
+    if (strcmp(nome, "fase") == 0) return (parse_int_value(valor, &job->fase) == 0 && job->fase >= 1 && job->fase <= 3) ? 0 : -1;
+    if (strcmp(nome, "population") == 0) return parse_int_value(valor, &c->population_size);
+    if (strcmp(nome, "max_generations") == 0) return parse_int_value(valor, &c->max_generations);
+    if (strcmp(nome, "threads") == 0) return parse_int_value(valor, &c->num_threads);
+    if (strcmp(nome, "stagnation") == 0) return parse_int_value(valor, &c->stop.stagnation_gens);
+    if (strcmp(nome, "min_resets") == 0) return parse_int_value(valor, &c->stop.min_resets);
+    if (strcmp(nome, "diversity_floor") == 0) return parse_double_value(valor, &c->stop.diversity_floor);
+    if (strcmp(nome, "max_seconds") == 0) return parse_double_value(valor, &c->stop.max_seconds);
+    if (strcmp(nome, "max_evals") == 0) {
+        double x;
+        if (parse_double_value(valor, &x) != 0) return -1;
+        c->stop.max_evaluations = (long long)x;
+        return 0;
+    }
+    if (strcmp(nome, "target") == 0) {
+        c->stop.target_enabled = 1;
+        return parse_double_value(valor, &c->stop.target_fitness);
+    }
+    if (strcmp(nome, "diversity_sample") == 0) return parse_int_value(valor, &c->diversity_sample_size);
+    if (strcmp(nome, "layout") == 0) {
+        if (strcmp(valor, "aos") == 0) c->layout = GA_LAYOUT_AOS;
+        else if (strcmp(valor, "soa") == 0) c->layout = GA_LAYOUT_SOA;
+        else return -1;
+        return 0;
+    }
+    if (strcmp(nome, "breeding") == 0) {
+        if (strcmp(valor, "serial") == 0) c->parallel_breeding = 0;
+        else if (strcmp(valor, "parallel") == 0) c->parallel_breeding = 1;
+        else return -1;
+        return 0;
+    }
+    if (strcmp(nome, "strategy") == 0) return ga_strategy_from_name(valor, &c->strategy);
+    if (strcmp(nome, "islands") == 0) return parse_int_value(valor, &job->ilhas.n_islands);
+    if (strcmp(nome, "migration_interval") == 0) return parse_int_value(valor, &job->ilhas.migration_interval);
+    if (strcmp(nome, "migrants") == 0) return parse_int_value(valor, &job->ilhas.n_migrants);
+    if (strcmp(nome, "topology") == 0) {
+        if (strcmp(valor, "ring") == 0) job->ilhas.topology = GA_TOPOLOGY_RING;
+        else if (strcmp(valor, "full") == 0) job->ilhas.topology = GA_TOPOLOGY_FULL;
+        else return -1;
+        return 0;
+    }
+    if (strcmp(nome, "surrogate") == 0) return parse_int_value(valor, &c->surrogate.enabled);
+    if (strcmp(nome, "fitness_cache") == 0) return parse_int_value(valor, &c->cache.entries);
+    if (strcmp(nome, "cache_quantum") == 0) return parse_double_value(valor, &c->cache.quantum);
+    if (strcmp(nome, "ref_speed") == 0) return parse_double_value(valor, &job->ref_speed_ms);
+    if (strcmp(nome, "gene_min") == 0) return parse_vector(valor, job->gene_min, c->num_dimensions);
+    if (strcmp(nome, "gene_max") == 0) return parse_vector(valor, job->gene_max, c->num_dimensions);
+    if (strcmp(nome, "car") == 0) {
+        double g[7];
+        if (sscanf(valor, "%lf %lf %lf %lf %lf %lf %lf", &g[0], &g[1], &g[2], &g[3], &g[4], &g[5], &g[6]) != 7) return -1;
+        job->car = (CarDesignOutrigger){g[0], g[1], g[2], g[3], g[4], g[5], g[6]};
+        return 0;
+    }
+    return -2;
+}
+
+// Chaves do executor (não mudam a execução do AG)
+static int is_runner_key(const char* nome) {
+    return strcmp(nome, "seeds") == 0 || strcmp(nome, "jobs") == 0 ||
+           strcmp(nome, "out") == 0 || strcmp(nome, "log") == 0;
+}
+
+/**
+ * Monta a execução da combinação 'comb' da grade com a semente 'seed'.
+ * 'fase' entra primeiro (define os genes), depois os limites padrão, depois o resto.
+ */
+static int job_build(RunnerJob* job, RunnerSpec* spec, int comb, unsigned long long seed) {
+    job_defaults(job);
+    job->combinacao = comb;
+    job->cfg.seed = seed;
+    int idx[RUNNER_MAX_KEYS];
+    int resto = comb;
+    for (int k = spec->n - 1; k >= 0; k--) {
+        int eixo = !is_runner_key(spec->chaves[k].nome);
+        idx[k] = eixo ? resto % spec->chaves[k].n : 0;
+        if (eixo) resto /= spec->chaves[k].n;
+    }
+    RunnerKey* kf = spec_find(spec, "fase");
+    if (kf && job_apply(job, "fase", kf->valores[idx[kf - spec->chaves]]) != 0) {
+        fprintf(stderr, "ERRO: fase invalida: %s\n", kf->valores[idx[kf - spec->chaves]]);
+        return -1;
+    }
+    job_default_bounds(job);
+
+    size_t pos = 0;
+    job->rotulo[0] = '\0';
+    for (int k = 0; k < spec->n; k++) {
+        RunnerKey* chave = &spec->chaves[k];
+        if (is_runner_key(chave->nome)) continue;
+        const char* valor = chave->valores[idx[k]];
+        if (chave != kf) {
+            int erro = job_apply(job, chave->nome, valor);
+            if (erro == -2) { fprintf(stderr, "ERRO: chave desconhecida: %s\n", chave->nome); return -1; }
+            if (erro != 0) { fprintf(stderr, "ERRO: valor invalido para %s: %s\n", chave->nome, valor); return -1; }
+        }
+        if (chave->n > 1 && pos < sizeof(job->rotulo))
+            pos += snprintf(job->rotulo + pos, sizeof(job->rotulo) - pos, "%s%s=%s", pos ? ";" : "", chave->nome, valor);
+    }
+    if (pos == 0) snprintf(job->rotulo, sizeof(job->rotulo), "padrao");
+    if (job->cfg.population_size < 2 || job->cfg.max_generations < 1) {
+        fprintf(stderr, "ERRO: population >= 2 e max_generations >= 1\n");
+        return -1;
+    }
+    if (job->cfg.parallel_breeding && job->cfg.strategy == GA_STRATEGY_FISHER) {
+        // A linha da grade diria 'parallel' com o resultado da reprodução em série
+        fprintf(stderr, "ERRO: breeding = parallel nao vale com strategy = fisher (a reproducao dela e serial)\n");
+        return -1;
+    }
+    job->cfg.gene_min = job->gene_min;
+    job->cfg.gene_max = job->gene_max;
+    return 0;
+}
+
+/** Roda uma execução (numa thread do executor). */
+static void job_run(RunnerJob* job) {
+    RaceContext race;
+    FitnessFunc f = fitness_shape_wrapper;
+    FitnessBatchFunc fb = fitness_shape_batch;
+    const void* param = &job->ref_speed_ms;
+    if (job->fase > 1) {
+        race_context_init(&race, &job->car);
+        f = (job->fase == 2) ? fitness_strategy_wrapper : fitness_strategy_daily_wrapper;
+        fb = (job->fase == 2) ? fitness_strategy_batch : fitness_strategy_daily_batch;
+        param = &race;
+    }
+    GaLog* log = job->log_path[0] ? ga_log_open(job->log_path, NULL) : NULL;
+    job->cfg.log = log;
+    GAContext* ctx = ga_context_create(&job->cfg, &job->ilhas);
+    Individual best = ga_context_run(ctx, f, fb, param);
+    job->stats = *ga_context_stats(ctx);
+    job->melhor_fitness = f(best, param); // A fitness é determinística: o mesmo valor que o AG viu
+    free(best.genes);
+    ga_context_free(ctx);
+    ga_log_close(log);
+}
+
+/** Fila das execuções, consumida por 'jobs' threads. */
+typedef struct {
+    RunnerJob* jobs;
+    int n;
+    int proximo;
+    int feitos;
+    pthread_mutex_t trava;
+} RunnerQueue;
+
+static void* worker(void* arg) {
+    RunnerQueue* q = (RunnerQueue*)arg;
+    for (;;) {
+        pthread_mutex_lock(&q->trava);
+        int i = q->proximo++;
+        pthread_mutex_unlock(&q->trava);
+        if (i >= q->n) return NULL;
+        job_run(&q->jobs[i]);
+        pthread_mutex_lock(&q->trava);
+        int feitos = ++q->feitos;
+        RunnerJob* j = &q->jobs[i];
+        fprintf(stderr, " [%d/%d] %s semente %llu: fitness %.6g em %.2f s (%s)\n", feitos, q->n, j->rotulo,
+                j->cfg.seed, j->melhor_fitness, j->stats.seconds, ga_stop_reason_name(j->stats.stop_reason));
+        pthread_mutex_unlock(&q->trava);
+    }
+}
+
+// =============================================================================
+// RESULTADOS
+// =============================================================================
+
+static void write_results(FILE* f, const RunnerJob* jobs, int n) {
+    fprintf(f, "execucao,combinacao,config,fase,semente,geracoes,avaliacoes,tempo_s,avaliacoes_por_s,melhor_fitness,parada\n");
+    for (int i = 0; i < n; i++) {
+        const RunnerJob* j = &jobs[i];
+        double taxa = j->stats.seconds > 0 ? j->stats.evaluations / j->stats.seconds : 0.0;
+        fprintf(f, "%d,%d,%s,%d,%llu,%d,%lld,%.4f,%.1f,%.10g,%s\n", j->id, j->combinacao, j->rotulo, j->fase,
+                j->cfg.seed, j->stats.generations, j->stats.evaluations, j->stats.seconds, taxa,
+                j->melhor_fitness, ga_stop_reason_name(j->stats.stop_reason));
+    }
+}
+
+/** Média de cada combinação sobre as sementes (as execuções de uma combinação são vizinhas). */
+static void print_summary(const RunnerJob* jobs, int n, int n_seeds) {
+    printf("%-40s %4s %10s %12s %14s %14s %10s\n", "config", "n", "tempo_s", "aval/s", "fitness_media",
+           "fitness_melhor", "geracoes");
+    for (int i = 0; i < n; i += n_seeds) {
+        double t = 0, taxa = 0, fit = 0, melhor = jobs[i].melhor_fitness, gens = 0;
+        for (int s = 0; s < n_seeds; s++) {
+            const RunnerJob* j = &jobs[i + s];
+            t += j->stats.seconds;
+            taxa += j->stats.seconds > 0 ? j->stats.evaluations / j->stats.seconds : 0.0;
+            fit += j->melhor_fitness;
+            gens += j->stats.generations;
+            if (j->melhor_fitness > melhor) melhor = j->melhor_fitness;
+        }
+        printf("%-40s %4d %10.3f %12.0f %14.6g %14.6g %10.0f\n", jobs[i].rotulo, n_seeds, t / n_seeds,
+               taxa / n_seeds, fit / n_seeds, melhor, gens / n_seeds);
+    }
+}
+
+// =============================================================================
+// PROGRAMA
+// =============================================================================
+
+int main(int argc, char** argv) {
+    RunnerSpec spec = {0};
+    // O arquivo primeiro; as opções da linha de comando substituem as suas chaves
+    for (int i = 1; i < argc - 1; i++)
+        if (strcmp(argv[i], "--config") == 0 && spec_load(&spec, argv[i + 1]) != 0) return 1;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--", 2) != 0 || i + 1 >= argc) {
+            fprintf(stderr, "Uso: %s [--config ARQ] [--chave valor[,valor...]]...\n", argv[0]);
+            return 1;
+        }
+        if (strcmp(argv[i], "--config") != 0 && spec_set(&spec, argv[i] + 2, argv[i + 1]) != 0) {
+            fprintf(stderr, "ERRO: valor invalido para %s\n", argv[i]);
+            return 1;
+        }
+        i++;
+    }
+
+    static unsigned long long seeds[RUNNER_MAX_SEEDS];
+    int n_seeds = 1;
+    seeds[0] = 1;
+    RunnerKey* ks = spec_find(&spec, "seeds");
+    if (ks && (n_seeds = parse_seeds(ks, seeds, RUNNER_MAX_SEEDS)) <= 0) {
+        fprintf(stderr, "ERRO: sementes invalidas (use ex: 1-8 ou 1,5,9)\n");
+        return 1;
+    }
+
+    // As chaves do executor não são eixos da grade (delas só vale o primeiro valor)
+    int n_comb = 1;
+    for (int k = 0; k < spec.n; k++)
+        if (!is_runner_key(spec.chaves[k].nome)) n_comb *= spec.chaves[k].n;
+
+    int n = n_comb * n_seeds;
+    RunnerJob* jobs = (RunnerJob*)malloc(sizeof(RunnerJob) * n);
+    const char* log_prefixo = spec_get(&spec, "log", NULL);
+    for (int c = 0; c < n_comb; c++) {
+        for (int s = 0; s < n_seeds; s++) {
+            RunnerJob* j = &jobs[c * n_seeds + s];
+            if (job_build(j, &spec, c, seeds[s]) != 0) { free(jobs); spec_free(&spec); return 1; }
+            j->id = c * n_seeds + s;
+            if (log_prefixo) snprintf(j->log_path, sizeof(j->log_path), "%s%d.galog", log_prefixo, j->id);
+        }
+    }
+
+    int threads = jobs[0].cfg.num_threads > 0 ? jobs[0].cfg.num_threads : ga_available_threads();
+    int n_workers = atoi(spec_get(&spec, "jobs", "0"));
+    if (n_workers <= 0) n_workers = ga_available_threads() / threads;
+    if (n_workers < 1) n_workers = 1;
+    if (n_workers > n) n_workers = n;
+    const char* saida = spec_get(&spec, "out", "runner.csv");
+    fprintf(stderr, " Executor: %d combinacao(oes) x %d semente(s) = %d execucoes, %d em paralelo\n",
+            n_comb, n_seeds, n, n_workers);
+
+    RunnerQueue q = {jobs, n, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+    pthread_t tids[n_workers];
+    int iniciadas = 0;
+    for (int w = 1; w < n_workers; w++)
+        if (pthread_create(&tids[iniciadas], NULL, worker, &q) == 0) iniciadas++;
+    worker(&q); // A thread principal também consome a fila
+    for (int w = 0; w < iniciadas; w++) pthread_join(tids[w], NULL);
+
+    FILE* f = fopen(saida, "w");
+    if (f == NULL) {
+        fprintf(stderr, "AVISO: nao foi possivel criar %s; resultados no terminal\n", saida);
+        write_results(stdout, jobs, n);
+    } else {
+        write_results(f, jobs, n);
+        fclose(f);
+        printf("Resultados de cada execucao em %s\n", saida);
+    }
+    print_summary(jobs, n, n_seeds);
+
+    free(jobs);
+    spec_free(&spec);
+    return 0;
+}
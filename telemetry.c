@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "telemetry.h"
+
+// =============================================================================
+// ANEL SPSC (produtor: thread do AG | consumidor: thread exportadora)
+// =============================================================================
+// head só é escrito pelo produtor e tail só pelo consumidor; cada um fica na
+// sua linha de cache para um lado não invalidar o outro a cada geração.
+// Vários AGs simultâneos (um GAContext por estágio) revezam o papel de
+// produtor por um spinlock curto; o consumidor nunca toma o lock.
+
+#define RING_MASK (TELEMETRY_RING_SIZE - 1)
+#define CACHE_LINE 64
+
+typedef struct {
+    _Atomic uint64_t head;                       // Próximo slot a escrever
+    char pad_head[CACHE_LINE - sizeof(uint64_t)];
+    _Atomic uint64_t tail;                       // Próximo slot a ler
+    char pad_tail[CACHE_LINE - sizeof(uint64_t)];
+    _Atomic uint64_t dropped;                    // Descartes por anel cheio (escrito pelo produtor)
+    atomic_flag producer_lock;                   // Serializa produtores concorrentes
+    TelemetryRecord slots[TELEMETRY_RING_SIZE];
+} TelemetryRing;
+
+static TelemetryRing ring = {.producer_lock = ATOMIC_FLAG_INIT};
+static int telemetry_on = 0;
+static int telemetry_fase = 0;
+static atomic_int exporter_running;
+static pthread_t exporter_thread;
+static int sock_fd = -1;
+static struct sockaddr_in dest_addr;
+
+// Intervalo de espera do consumidor quando o anel está vazio
+#define EXPORTER_IDLE_NS 20000000L // 20 ms
+
+/** Datagrama: cabeçalho + até TELEMETRY_BATCH registros. */
+typedef struct {
+    char magic[4];
+    uint32_t n;
+    uint64_t dropped;
+    TelemetryRecord recs[TELEMETRY_BATCH];
+} TelemetryPacket;
+
+/** Consumidor: copia até TELEMETRY_BATCH registros do anel e libera os slots. */
+static int ring_pop(TelemetryRecord* out, int max) {
+    uint64_t t = atomic_load_explicit(&ring.tail, memory_order_relaxed);
+    uint64_t h = atomic_load_explicit(&ring.head, memory_order_acquire);
+    int n = (int)(h - t);
+    if (n > max) n = max;
+    for (int k = 0; k < n; k++) out[k] = ring.slots[(t + k) & RING_MASK];
+    atomic_store_explicit(&ring.tail, t + n, memory_order_release);
+    return n;
+}
+
+/** Esvazia o anel em datagramas. @return número de registros enviados. */
+static int exporter_drain() {
+    TelemetryPacket pkt;
+    memcpy(pkt.magic, TELEMETRY_MAGIC, 4);
+    int total = 0, n;
+    while ((n = ring_pop(pkt.recs, TELEMETRY_BATCH)) > 0) {
+        pkt.n = (uint32_t)n;
+        pkt.dropped = atomic_load_explicit(&ring.dropped, memory_order_relaxed);
+        size_t len = offsetof(TelemetryPacket, recs) + sizeof(TelemetryRecord) * n;
+        // UDP: se ninguém estiver ouvindo o pacote simplesmente se perde
+        sendto(sock_fd, &pkt, len, 0, (const struct sockaddr*)&dest_addr, sizeof(dest_addr));
+        total += n;
+    }
+    return total;
+}
+
+static void* exporter_main(void* arg) {
+    (void)arg;
+    struct timespec idle = {0, EXPORTER_IDLE_NS};
+    while (atomic_load(&exporter_running)) {
+        if (exporter_drain() == 0) nanosleep(&idle, NULL);
+    }
+    exporter_drain(); // O que o AG publicou antes do stop
+    return NULL;
+}
+
+// =============================================================================
+// API PÚBLICA
+// =============================================================================
+
+int telemetry_start(const char* host, int port) {
+    if (telemetry_on) return 0;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = AF_INET;
+    dest_addr.sin_port = htons((uint16_t)port);
+    if (inet_pton(AF_INET, host ? host : "127.0.0.1", &dest_addr.sin_addr) != 1) return -1;
+
+    sock_fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock_fd < 0) return -1;
+
+    atomic_store(&ring.head, 0);
+    atomic_store(&ring.tail, 0);
+    atomic_store(&ring.dropped, 0);
+    atomic_store(&exporter_running, 1);
+    if (pthread_create(&exporter_thread, NULL, exporter_main, NULL) != 0) {
+        close(sock_fd); sock_fd = -1;
+        return -1;
+    }
+    telemetry_on = 1;
+    return 0;
+}
+
+void telemetry_stop() {
+    if (!telemetry_on) return;
+    telemetry_on = 0;
+    atomic_store(&exporter_running, 0);
+    pthread_join(exporter_thread, NULL);
+    close(sock_fd); sock_fd = -1;
+}
+
+int telemetry_enabled() { return telemetry_on; }
+
+void telemetry_set_phase(int fase) { telemetry_fase = fase; }
+
+int telemetry_current_phase() { return telemetry_fase; }
+
+int telemetry_publish(int fase, const GaLogRow* row) {
+    if (!telemetry_on) return 0;
+    while (atomic_flag_test_and_set_explicit(&ring.producer_lock, memory_order_acquire)) { }
+    uint64_t h = atomic_load_explicit(&ring.head, memory_order_relaxed);
+    uint64_t t = atomic_load_explicit(&ring.tail, memory_order_acquire);
+    if (h - t >= TELEMETRY_RING_SIZE) {
+        // Anel cheio: o AG não espera pelo consumidor
+        atomic_store_explicit(&ring.dropped, atomic_load_explicit(&ring.dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+        atomic_flag_clear_explicit(&ring.producer_lock, memory_order_release);
+        return 0;
+    }
+    TelemetryRecord* r = &ring.slots[h & RING_MASK];
+    r->fase = fase;
+    r->reservado = 0;
+    r->cols[GA_COL_GERACAO] = row->geracao;
+    r->cols[GA_COL_MELHOR_FITNESS] = row->melhor_fitness;
+    r->cols[GA_COL_FITNESS_MEDIO] = row->fitness_medio;
+    r->cols[GA_COL_DESVIO_PADRAO_FIT] = row->desvio_padrao_fit;
+    r->cols[GA_COL_DIVERSIDADE] = row->diversidade;
+    r->cols[GA_COL_TAXA_MUTACAO] = row->taxa_mutacao;
+    r->cols[GA_COL_FATOR_REPULSAO] = row->fator_repulsao;
+    r->cols[GA_COL_EVENTO] = row->evento;
+    r->cols[GA_COL_TEMPO_GERACAO] = row->tempo_geracao_us;
+    r->cols[GA_COL_CACHE_ACERTOS] = row->cache_acertos;
+    r->cols[GA_COL_CACHE_FALHAS] = row->cache_falhas;
+    r->cols[GA_COL_SEVERIDADE] = row->severidade;
+    atomic_store_explicit(&ring.head, h + 1, memory_order_release); // Publica o slot
+    atomic_flag_clear_explicit(&ring.producer_lock, memory_order_release);
+    return 1;
+}
+
+uint64_t telemetry_dropped() {
+    return atomic_load_explicit(&ring.dropped, memory_order_relaxed);
+}
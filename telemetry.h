@@ -0,0 +1,66 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+/**
+ * @file telemetry.h
+ * @brief Telemetria ao vivo do AG (para acompanhar a convergência durante a execução).
+ * * O motor do AG (produtor) publica as métricas de cada geração num anel
+ * lock-free de produtor único / consumidor único (AGs simultâneos se revezam
+ * como produtor por um spinlock curto). Uma thread exportadora
+ * (consumidor) esvazia o anel e envia os registros em datagramas UDP para
+ * HOST:PORTA (por padrão 127.0.0.1). dashboard.py --follow escuta essa porta.
+ * * O produtor nunca espera: se o anel estiver cheio (consumidor atrasado), o
+ * registro é descartado e contado em 'dropped'. Sem telemetria ativa,
+ * telemetry_publish() é só um teste de ponteiro.
+ * * --- FORMATO DO DATAGRAMA (ordem de bytes nativa) ---
+ * Os registros vão como estão na memória; dashboard.py lê como little-endian.
+ *   char     magic[4]  = "GATL"
+ *   uint32   n         (registros neste datagrama, <= TELEMETRY_BATCH)
+ *   uint64   dropped   (total de registros descartados até agora)
+ *   TelemetryRecord registros[n]
+ */
+
+#include <stdint.h>
+#include "ga_log.h" // GaLogRow e a ordem das colunas (GaLogColumn)
+
+#define TELEMETRY_RING_SIZE 4096     // Potência de 2
+#define TELEMETRY_BATCH 64           // Registros por datagrama
+#define TELEMETRY_DEFAULT_PORT 47800
+#define TELEMETRY_MAGIC "GATL"
+
+/** @brief Um registro publicado (uma geração de uma fase). */
+typedef struct {
+    int32_t fase;                    // Fase do projeto (telemetry_set_phase)
+    int32_t reservado;
+    double cols[GA_LOG_NCOLS];       // Mesmas colunas e ordem do log (GaLogColumn)
+} TelemetryRecord;
+
+/**
+ * @brief Liga a telemetria: abre o socket UDP e inicia a thread exportadora.
+ * @param host Endereço IPv4 de destino (NULL = "127.0.0.1").
+ * @return 0 em sucesso, -1 se o socket ou a thread não puderam ser criados.
+ */
+int telemetry_start(const char* host, int port);
+
+/** @brief Envia o que restou no anel, encerra a thread e fecha o socket. */
+void telemetry_stop();
+
+/** @brief 1 se a telemetria está ligada (o AG só monta o registro nesse caso). */
+int telemetry_enabled();
+
+/** @brief Define a fase padrão (usada por ga_config_from_globals; chamar entre execuções do AG). */
+void telemetry_set_phase(int fase);
+
+/** @brief Fase padrão definida por telemetry_set_phase (0 se nunca definida). */
+int telemetry_current_phase();
+
+/**
+ * @brief Publica uma geração da fase 'fase' (chamada pelas threads do AG).
+ * Nunca espera pelo consumidor. @return 1 se publicado, 0 se descartado ou desligado.
+ */
+int telemetry_publish(int fase, const GaLogRow* row);
+
+/** @brief Total de registros descartados por anel cheio. */
+uint64_t telemetry_dropped();
+
+#endif // TELEMETRY_H